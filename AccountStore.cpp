@@ -0,0 +1,406 @@
+/**
+ * The AccountStore class keeps the balances and open bets of players on disk, so that they survive quitting the game
+ * and crashes. Money is stored in cents (whole numbers), so no rounding errors build up in the files.
+ *
+ * Every change is appended as a record to a write-ahead log before it counts as done. A record is one line with a
+ * sequence number, the type of change, the player, the amount and a checksum of the line, so that a line that was
+ * only partly written during a crash is recognised and ignored, together with everything after it.
+ *
+ * Writing a record to the disk (fsync) takes milliseconds, which would limit the game to a few hundred changes per
+ * second. The records are therefore collected in memory and written by a background thread every few milliseconds,
+ * with a single fsync for all of them (group commit). Changes return their sequence number straight away, and callers
+ * that need to know a change is durable wait for it with waitUntilDurable(), which wakes the background thread
+ * straight away. All changes that arrive while an fsync is running are written together with the next one, so many
+ * waiting players share every fsync.
+ *
+ * To keep the log short, the background thread regularly writes a snapshot with all balances and open bets. The
+ * snapshot is written to a temporary file, flushed to disk and then renamed over the old one, which replaces it in one
+ * step. After that the log is started over. When the store is opened, the snapshot is read and the records of the log
+ * with a higher sequence number are replayed. A bet that was still open at a crash is returned to the player, as its
+ * round could not be finished.
+ */
+
+#include "AccountStore.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Metrics.h"
+
+// fsync is called _commit on Windows
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cerr, std::endl, std::to_string, std::isspace;
+
+/**
+ * Constructor for a store that keeps its files in the directory "directory", which is created if needed. The
+ * accounts are recovered from the files that are already there, and a background thread is started to write the
+ * changes.
+ */
+AccountStore::AccountStore(const string &directory) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        cerr << "Error: the account directory \"" << directory << "\" could not be created" << endl;
+        exit(-1);
+    }
+    logFileName = (std::filesystem::path(directory) / "accounts.log").string();
+    snapshotFileName = (std::filesystem::path(directory) / "accounts.snapshot").string();
+
+    recover();
+
+    flushThread = std::thread([this]() {
+        while (true) {
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(durableMutex);
+                durableChanged.wait_for(lock, std::chrono::milliseconds(GROUP_COMMIT_MILLISECONDS),
+                                        [this]() { return isStopping || flushIsRequested; });
+                stopping = isStopping;
+                flushIsRequested = false;
+            }
+            writePendingRecords();
+            if (stopping) {
+                break;
+            }
+        }
+    });
+}
+
+/**
+ * Destructor: writes all pending records and stops the background thread.
+ */
+AccountStore::~AccountStore() {
+    {
+        std::lock_guard<std::mutex> lock(durableMutex);
+        isStopping = true;
+    }
+    durableChanged.notify_all();
+    flushThread.join();
+    fclose(logFile);
+}
+
+/**
+ * This function checks whether a player name, provided as input string "playerName", can be stored: it must not
+ * be empty or contain spaces. Otherwise an error will be displayed indicating the problem and the program will be
+ * exited.
+ */
+void AccountStore::errorCheckPlayerName(const string &playerName) {
+    bool isValid = !playerName.empty();
+    for (char character : playerName) {
+        isValid = isValid && !isspace((unsigned char) character);
+    }
+    if (!isValid) {
+        cerr << "Error: the player name \"" << playerName << "\" is empty or contains spaces" << endl;
+        exit(-1);
+    }
+}
+
+/**
+ * This function returns a checksum (FNV-1a) of the input "text", which is added to every record of the log.
+ */
+uint32_t AccountStore::checksum(const string &text) {
+    uint32_t hash = 2166136261u;
+    for (char character : text) {
+        hash = (hash ^ (uint8_t) character) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * This function applies the change of a record of the input "type" ('N' for a new balance, 'B' for a placed bet and
+ * 'S' for a settled bet) with the input "amount" to the account of "playerName".
+ */
+void AccountStore::apply(char type, const string &playerName, Money amount) {
+    Account &account = accounts[playerName];
+    if (type == 'N') {
+        account.balance = amount;
+    } else if (type == 'B') {
+        account.balance -= amount;
+        account.openBet = amount;
+    } else if (type == 'S') {
+        account.balance += amount;
+        account.openBet = Money();
+    }
+}
+
+/**
+ * This function applies a change like apply() and adds its record to the pending records. The caller must hold
+ * stateMutex. It returns the sequence number of the record.
+ */
+uint64_t AccountStore::record(char type, const string &playerName, Money amount) {
+    apply(type, playerName, amount);
+    uint64_t sequenceNumber = ++lastSequenceNumber;
+    string line = to_string(sequenceNumber) + " " + type + " " + playerName + " " + to_string(amount.getCents());
+    pendingRecords += line + " " + to_string(checksum(line)) + "\n";
+    recordsSinceSnapshot++;
+    Metrics::changeGauge(Metrics::PENDING_ACCOUNT_RECORDS, 1);
+    return sequenceNumber;
+}
+
+/**
+ * This function reads the snapshot and replays the log, see the description at the top of this file.
+ */
+void AccountStore::recover() {
+    uint64_t snapshotSequenceNumber = 0;
+    std::ifstream snapshotFile(snapshotFileName);
+    if (snapshotFile) {
+        string header;
+        int amountOfAccounts = 0;
+        snapshotFile >> header >> snapshotSequenceNumber >> amountOfAccounts;
+        for (int i = 0; i < amountOfAccounts && snapshotFile; ++i) {
+            string playerName;
+            int64_t balanceInCents = 0;
+            int64_t openBetInCents = 0;
+            snapshotFile >> playerName >> balanceInCents >> openBetInCents;
+            accounts[playerName] = {Money::fromCents(balanceInCents), Money::fromCents(openBetInCents)};
+        }
+        string footer;
+        snapshotFile >> footer;
+        // The snapshot replaces the old one in one step, so a broken snapshot means the file was changed by hand
+        if (header != "snapshot" || footer != "end") {
+            cerr << "Error: the account snapshot \"" << snapshotFileName << "\" is damaged" << endl;
+            exit(-1);
+        }
+    }
+    lastSequenceNumber = snapshotSequenceNumber;
+
+    // Replaying the log up to the first record that is incomplete or does not match its checksum
+    std::ifstream logInput(logFileName);
+    string line;
+    while (std::getline(logInput, line)) {
+        std::istringstream lineStream(line);
+        uint64_t sequenceNumber;
+        char type;
+        string playerName;
+        int64_t amountInCents;
+        uint32_t lineChecksum;
+        if (!(lineStream >> sequenceNumber >> type >> playerName >> amountInCents >> lineChecksum)) {
+            break;
+        }
+        string body = to_string(sequenceNumber) + " " + type + " " + playerName + " " + to_string(amountInCents);
+        if (checksum(body) != lineChecksum) {
+            break;
+        }
+        // Records up to the snapshot are already part of it
+        if (sequenceNumber > snapshotSequenceNumber) {
+            apply(type, playerName, Money::fromCents(amountInCents));
+            lastSequenceNumber = sequenceNumber;
+        }
+    }
+
+    // The rounds of open bets could not be finished, so the bets are returned
+    for (auto &[playerName, account] : accounts) {
+        if (account.openBet > Money()) {
+            record('S', playerName, account.openBet);
+        }
+    }
+    Metrics::changeGauge(Metrics::PENDING_ACCOUNT_RECORDS,
+                         -(int64_t) std::count(pendingRecords.begin(), pendingRecords.end(), '\n'));
+    pendingRecords.clear();
+    recordsSinceSnapshot = 0;
+
+    // Starting from a fresh snapshot also removes a partly written record from the end of the log
+    writeSnapshot(accounts, lastSequenceNumber);
+    durableSequenceNumber = lastSequenceNumber;
+}
+
+/**
+ * This function writes all pending records to the log with a single fsync, and a snapshot if enough records have
+ * been written since the last one.
+ */
+void AccountStore::writePendingRecords() {
+    string records;
+    uint64_t writtenSequenceNumber;
+    bool snapshotIsDue = false;
+    map<string, Account> accountsToSave;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        records.swap(pendingRecords);
+        Metrics::changeGauge(Metrics::PENDING_ACCOUNT_RECORDS,
+                             -(int64_t) std::count(records.begin(), records.end(), '\n'));
+        writtenSequenceNumber = lastSequenceNumber;
+        if (recordsSinceSnapshot >= RECORDS_PER_SNAPSHOT) {
+            snapshotIsDue = true;
+            accountsToSave = accounts;
+            recordsSinceSnapshot = 0;
+        }
+    }
+
+    // A record only counts as durable once it is on the disk, so a failed write ends the program before
+    // durableSequenceNumber moves on
+    if (!records.empty()) {
+        if (fwrite(records.data(), 1, records.size(), logFile) != records.size()) {
+            cerr << "Error: the account log \"" << logFileName << "\" could not be written" << endl;
+            exit(-1);
+        }
+        Metrics::count(Metrics::BYTES_TO_ACCOUNT_LOG, records.size());
+        syncToDisk(logFile, logFileName);
+    }
+    if (snapshotIsDue) {
+        writeSnapshot(accountsToSave, writtenSequenceNumber);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(durableMutex);
+        durableSequenceNumber = writtenSequenceNumber;
+    }
+    durableChanged.notify_all();
+}
+
+/**
+ * This function writes a snapshot of the input "accountsToSave", which includes all records up to the input
+ * "sequenceNumber", and starts a new, empty log.
+ */
+void AccountStore::writeSnapshot(const map<string, Account> &accountsToSave, uint64_t sequenceNumber) {
+    string temporaryFileName = snapshotFileName + ".tmp";
+    FILE *snapshotFile = fopen(temporaryFileName.c_str(), "wb");
+    if (snapshotFile == nullptr) {
+        cerr << "Error: the account snapshot \"" << temporaryFileName << "\" could not be written" << endl;
+        exit(-1);
+    }
+    string contents = "snapshot " + to_string(sequenceNumber) + " " + to_string(accountsToSave.size()) + "\n";
+    for (const auto &[playerName, account] : accountsToSave) {
+        contents += playerName + " " + to_string(account.balance.getCents()) + " " +
+                    to_string(account.openBet.getCents()) + "\n";
+    }
+    contents += "end\n";
+    // Every step must succeed before the log is started over, as the log is the only copy of the records until the
+    // new snapshot is on the disk
+    if (fwrite(contents.data(), 1, contents.size(), snapshotFile) != contents.size()) {
+        cerr << "Error: the account snapshot \"" << temporaryFileName << "\" could not be written" << endl;
+        exit(-1);
+    }
+    Metrics::count(Metrics::BYTES_TO_ACCOUNT_LOG, contents.size());
+    syncToDisk(snapshotFile, temporaryFileName);
+    if (fclose(snapshotFile) != 0) {
+        cerr << "Error: the account snapshot \"" << temporaryFileName << "\" could not be closed" << endl;
+        exit(-1);
+    }
+
+    // Renaming replaces the old snapshot in one step, so there is always one complete snapshot on the disk
+    std::error_code error;
+    std::filesystem::rename(temporaryFileName, snapshotFileName, error);
+    if (error) {
+        cerr << "Error: the account snapshot \"" << temporaryFileName << "\" could not be renamed to \""
+             << snapshotFileName << "\"" << endl;
+        exit(-1);
+    }
+#ifndef _WIN32
+    // On POSIX systems the rename itself is only durable once the directory is synced
+    int directory = open(std::filesystem::path(snapshotFileName).parent_path().string().c_str(), O_RDONLY);
+    if (directory >= 0) {
+        int syncResult = fsync(directory);
+        close(directory);
+        if (syncResult != 0) {
+            cerr << "Error: the account directory of \"" << snapshotFileName << "\" could not be synced to the disk"
+                 << endl;
+            exit(-1);
+        }
+    }
+#endif
+
+    // All records up to the snapshot are in it, so the log can start over
+    if (logFile != nullptr && fclose(logFile) != 0) {
+        cerr << "Error: the account log \"" << logFileName << "\" could not be closed" << endl;
+        exit(-1);
+    }
+    logFile = fopen(logFileName.c_str(), "wb");
+    if (logFile == nullptr) {
+        cerr << "Error: the account log \"" << logFileName << "\" could not be opened" << endl;
+        exit(-1);
+    }
+}
+
+/**
+ * This function makes sure everything written to the input "file" (named "fileName") is on the disk. If that fails,
+ * an error is displayed and the program is exited, as the changes in the file cannot be counted as done.
+ */
+void AccountStore::syncToDisk(FILE *file, const string &fileName) {
+    if (fflush(file) != 0) {
+        cerr << "Error: the account file \"" << fileName << "\" could not be written" << endl;
+        exit(-1);
+    }
+    auto startTime = std::chrono::steady_clock::now();
+#ifdef _WIN32
+    int syncResult = _commit(_fileno(file));
+#else
+    int syncResult = fsync(fileno(file));
+#endif
+    if (syncResult != 0) {
+        cerr << "Error: the account file \"" << fileName << "\" could not be synced to the disk" << endl;
+        exit(-1);
+    }
+    Metrics::observe(Metrics::FSYNC_LATENCY,
+                     std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+/**
+ * This function returns true if an account exists for the input "playerName".
+ */
+bool AccountStore::hasAccount(const string &playerName) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return accounts.count(playerName) > 0;
+}
+
+/**
+ * This function returns the account of the input "playerName", or an empty account if it does not exist.
+ */
+Account AccountStore::getAccount(const string &playerName) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    auto account = accounts.find(playerName);
+    return account == accounts.end() ? Account() : account->second;
+}
+
+/**
+ * This function sets the balance of "playerName" to "balance", creating the account if needed. It returns the
+ * sequence number of the change.
+ */
+uint64_t AccountStore::setBalance(const string &playerName, Money balance) {
+    errorCheckPlayerName(playerName);
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return record('N', playerName, balance);
+}
+
+/**
+ * This function takes the bet "bet" from the balance of "playerName" and keeps it as the open bet. It returns the
+ * sequence number of the change.
+ */
+uint64_t AccountStore::placeBet(const string &playerName, Money bet) {
+    errorCheckPlayerName(playerName);
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return record('B', playerName, bet);
+}
+
+/**
+ * This function closes the open bet of "playerName" and adds "returned" (the bet plus the winnings, or 0 for a
+ * lost bet) to their balance. It returns the sequence number of the change.
+ */
+uint64_t AccountStore::settleBet(const string &playerName, Money returned) {
+    errorCheckPlayerName(playerName);
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return record('S', playerName, returned);
+}
+
+/**
+ * This function waits until the change with the input "sequenceNumber" (and all before it) is on the disk.
+ */
+void AccountStore::waitUntilDurable(uint64_t sequenceNumber) {
+    std::unique_lock<std::mutex> lock(durableMutex);
+    if (durableSequenceNumber < sequenceNumber) {
+        flushIsRequested = true;
+        durableChanged.notify_all();
+    }
+    durableChanged.wait(lock, [&]() { return durableSequenceNumber >= sequenceNumber; });
+}
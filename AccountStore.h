@@ -0,0 +1,164 @@
+/**
+ * The AccountStore class keeps the balances and open bets of players on disk, so that they survive quitting the game
+ * and crashes. Money is stored in cents (whole numbers, see Money.h), so no rounding errors build up in the files.
+ *
+ * Every change is appended as a record to a write-ahead log before it counts as done. A record is one line with a
+ * sequence number, the type of change, the player, the amount and a checksum of the line, so that a line that was
+ * only partly written during a crash is recognised and ignored, together with everything after it.
+ *
+ * Writing a record to the disk (fsync) takes milliseconds, which would limit the game to a few hundred changes per
+ * second. The records are therefore collected in memory and written by a background thread every few milliseconds,
+ * with a single fsync for all of them (group commit). Changes return their sequence number straight away, and callers
+ * that need to know a change is durable wait for it with waitUntilDurable(), which wakes the background thread
+ * straight away. All changes that arrive while an fsync is running are written together with the next one, so many
+ * waiting players share every fsync.
+ *
+ * To keep the log short, the background thread regularly writes a snapshot with all balances and open bets. The
+ * snapshot is written to a temporary file, flushed to disk and then renamed over the old one, which replaces it in one
+ * step. After that the log is started over. When the store is opened, the snapshot is read and the records of the log
+ * with a higher sequence number are replayed. A bet that was still open at a crash is returned to the player, as its
+ * round could not be finished.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_ACCOUNTSTORE_H
+#define PIE_CPP_BLACKJACK_ACCOUNTSTORE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Money.h"
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::map;
+
+struct Account {
+    Money balance;
+    Money openBet;
+};
+
+class AccountStore {
+private:
+    const int GROUP_COMMIT_MILLISECONDS = 5;
+    const int RECORDS_PER_SNAPSHOT = 10000;
+
+    string logFileName;
+    string snapshotFileName;
+    FILE *logFile = nullptr;
+
+    // The accounts and the records that have not been written yet are protected by stateMutex
+    std::mutex stateMutex;
+    map<string, Account> accounts;
+    string pendingRecords;
+    uint64_t lastSequenceNumber = 0;
+    int recordsSinceSnapshot = 0;
+
+    // The background thread writes the pending records and wakes up the callers of waitUntilDurable()
+    std::mutex durableMutex;
+    std::condition_variable durableChanged;
+    uint64_t durableSequenceNumber = 0;
+    bool flushIsRequested = false; // set by waitUntilDurable(), so the background thread writes without waiting
+    bool isStopping = false;
+    std::thread flushThread;
+
+    /**
+     * This function checks whether a player name, provided as input string "playerName", can be stored: it must not
+     * be empty or contain spaces. Otherwise an error will be displayed indicating the problem and the program will be
+     * exited.
+     */
+    static void errorCheckPlayerName(const string &playerName);
+
+    /**
+     * This function returns a checksum (FNV-1a) of the input "text", which is added to every record of the log.
+     */
+    static uint32_t checksum(const string &text);
+
+    /**
+     * This function applies the change of a record of the input "type" ('N' for a new balance, 'B' for a placed bet and
+     * 'S' for a settled bet) with the input "amount" to the account of "playerName".
+     */
+    void apply(char type, const string &playerName, Money amount);
+
+    /**
+     * This function applies a change like apply() and adds its record to the pending records. The caller must hold
+     * stateMutex. It returns the sequence number of the record.
+     */
+    uint64_t record(char type, const string &playerName, Money amount);
+
+    /**
+     * This function reads the snapshot and replays the log, see the description at the top of this file.
+     */
+    void recover();
+
+    /**
+     * This function writes all pending records to the log with a single fsync, and a snapshot if enough records have
+     * been written since the last one.
+     */
+    void writePendingRecords();
+
+    /**
+     * This function writes a snapshot of the input "accountsToSave", which includes all records up to the input
+     * "sequenceNumber", and starts a new, empty log.
+     */
+    void writeSnapshot(const map<string, Account> &accountsToSave, uint64_t sequenceNumber);
+
+    /**
+     * This function makes sure everything written to the input "file" (named "fileName") is on the disk. If that fails,
+     * an error is displayed and the program is exited, as the changes in the file cannot be counted as done.
+     */
+    static void syncToDisk(FILE *file, const string &fileName);
+
+public:
+    /**
+     * Constructor for a store that keeps its files in the directory "directory", which is created if needed. The
+     * accounts are recovered from the files that are already there, and a background thread is started to write the
+     * changes.
+     */
+    explicit AccountStore(const string &directory);
+
+    /**
+     * Destructor: writes all pending records and stops the background thread.
+     */
+    ~AccountStore();
+
+    AccountStore(const AccountStore &) = delete;
+    AccountStore &operator=(const AccountStore &) = delete;
+
+    /**
+     * This function returns true if an account exists for the input "playerName".
+     */
+    bool hasAccount(const string &playerName);
+
+    /**
+     * This function returns the account of the input "playerName", or an empty account if it does not exist.
+     */
+    Account getAccount(const string &playerName);
+
+    /**
+     * This function sets the balance of "playerName" to "balance", creating the account if needed. It returns the
+     * sequence number of the change.
+     */
+    uint64_t setBalance(const string &playerName, Money balance);
+
+    /**
+     * This function takes the bet "bet" from the balance of "playerName" and keeps it as the open bet. It returns the
+     * sequence number of the change.
+     */
+    uint64_t placeBet(const string &playerName, Money bet);
+
+    /**
+     * This function closes the open bet of "playerName" and adds "returned" (the bet plus the winnings, or 0 for a
+     * lost bet) to their balance. It returns the sequence number of the change.
+     */
+    uint64_t settleBet(const string &playerName, Money returned);
+
+    /**
+     * This function waits until the change with the input "sequenceNumber" (and all before it) is on the disk.
+     */
+    void waitUntilDurable(uint64_t sequenceNumber);
+};
+
+
+#endif //PIE_CPP_BLACKJACK_ACCOUNTSTORE_H
@@ -0,0 +1,151 @@
+/**
+ * The AsyncTable class plays a game of Blackjack as a coroutine (see CoroutineScheduler.h), so that one thread can run
+ * thousands of tables at the same time, each waiting for its own player. The console game blocks its thread until the
+ * user has typed an answer, so it needs a thread per table. A table instead plays the same game, Blackjack::playGame(),
+ * with a RemotePlayer (see Blackjack.h): the game sends every question to the player and waits for the answer with
+ * co_await, and it waits for the pauses between the cards with a timer of the scheduler. Meanwhile, the thread plays
+ * the other tables. The rules are therefore exactly those of the console game, and the cards are drawn from an
+ * infinite deck of the table.
+ *
+ * The players are simulated remote players, which are coroutines as well: they think for a random time (up to a few
+ * seconds, like a user) and then answer with the commands a user would type, betting the minimum bet and hitting or
+ * standing with basic strategy (see PlayerPolicy.h). A real connection would send the questions over the network and
+ * put the answers in the same channel. A player leaves the table when the rounds are over, and the game ends by itself
+ * when their balance is below the minimum bet.
+ */
+
+#include "AsyncTable.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cout, std::endl, std::string, std::vector;
+
+/**
+ * Constructor for a table on the input "scheduler", which immediately starts a game of "amountOfRounds" rounds with a
+ * player with a balance of "startingBalance". A blackjack pays "blackjackPayout" and the dealer's second card follows
+ * "holeCardRule". The cards and the thinking times of the player are random numbers seeded with "seed". The scheduler
+ * is not copied, so it must outlive the table.
+ */
+AsyncTable::AsyncTable(CoroutineScheduler &scheduler, int amountOfRounds, Money startingBalance,
+                       PayoutRatio blackjackPayout, HoleCardRule holeCardRule, uint64_t seed)
+        : AMOUNT_OF_ROUNDS(amountOfRounds), scheduler(scheduler), deck(seed), connection(scheduler),
+          thinkingTimeGenerator(seed), player(simulatePlayer()),
+          table(playTable(startingBalance, blackjackPayout, holeCardRule)) {}
+
+/**
+ * This coroutine sets up the game with a player with a balance of "startingBalance", where a blackjack pays
+ * "blackjackPayout" and the dealer's second card follows "holeCardRule", and plays it until the player leaves. The
+ * player is then told that the table is closed.
+ */
+Task AsyncTable::playTable(Money startingBalance, PayoutRatio blackjackPayout, HoleCardRule holeCardRule) {
+    game.useCardSource(deck);
+    game.useRemotePlayer(connection);
+    game.setBlackjackPayout(blackjackPayout);
+    game.setHoleCardRule(holeCardRule);
+    game.setPlayerMoney(startingBalance);
+
+    co_await game.playGame();
+    connection.questions.send(TableQuestion{TableQuestion::TABLE_CLOSED, game.getPlayerMoney()});
+}
+
+/**
+ * This coroutine plays the simulated remote player: it answers every question of the game after thinking about it,
+ * until the table is closed.
+ */
+Task AsyncTable::simulatePlayer() {
+    std::uniform_real_distribution<double> thinkingTime(0, LONGEST_THINKING_TIME);
+    while (true) {
+        TableQuestion question = co_await connection.questions.receive();
+        if (question.type == TableQuestion::TABLE_CLOSED) {
+            co_return;
+        }
+        questionsAsked++;
+
+        co_await scheduler.sleep(thinkingTime(thinkingTimeGenerator));
+        if (question.type == TableQuestion::START_OR_QUIT) {
+            connection.answers.send(game.getRoundsPlayed() < AMOUNT_OF_ROUNDS ? "s" : "q");
+        } else if (question.type == TableQuestion::BET) {
+            connection.answers.send(MINIMUM_BET.toString());
+        } else {
+            bool hit = policy.shouldHit(question.playerSum, question.isSoft, question.dealerCardValue, 0);
+            connection.answers.send(hit ? "h" : "s");
+        }
+    }
+}
+
+/**
+ * This function returns true if the game at the table is over.
+ */
+bool AsyncTable::isClosed() const {
+    return table.isDone();
+}
+
+/**
+ * This function returns the amount of rounds played at the table.
+ */
+int AsyncTable::getRoundsPlayed() const {
+    return game.getRoundsPlayed();
+}
+
+/**
+ * This function returns the amount of questions the table has asked its player.
+ */
+uint64_t AsyncTable::getQuestionsAsked() const {
+    return questionsAsked;
+}
+
+/**
+ * This function returns the balance of the player.
+ */
+Money AsyncTable::getBalance() const {
+    return game.getPlayerMoney();
+}
+
+/**
+ * This function plays "amountOfTables" tables of "rounds" rounds each on this thread, with players that start with
+ * "startingBalance", and prints how long it took. A blackjack pays "blackjackPayout", the dealer's second card follows
+ * "holeCardRule" and table i is seeded with "seed" + i. The pauses and thinking times take real time, unless
+ * "useSimulatedTime" is true.
+ */
+void AsyncTable::runTables(int amountOfTables, int rounds, Money startingBalance, PayoutRatio blackjackPayout,
+                           HoleCardRule holeCardRule, uint64_t seed, bool useSimulatedTime) {
+    auto startTime = std::chrono::steady_clock::now();
+    CoroutineScheduler scheduler(useSimulatedTime);
+
+    // Every table starts its game (and asks its player to start) as soon as it is created
+    vector<std::unique_ptr<AsyncTable>> tables;
+    tables.reserve(amountOfTables);
+    for (int i = 0; i < amountOfTables; ++i) {
+        tables.push_back(std::make_unique<AsyncTable>(scheduler, rounds, startingBalance, blackjackPayout,
+                                                      holeCardRule, seed + i));
+    }
+    scheduler.run();
+
+    long long roundsPlayed = 0;
+    uint64_t questionsAsked = 0;
+    int closedTables = 0;
+    int playersOutOfMoney = 0;
+    Money houseResult;
+    for (const std::unique_ptr<AsyncTable> &table : tables) {
+        roundsPlayed += table->getRoundsPlayed();
+        questionsAsked += table->getQuestionsAsked();
+        closedTables += table->isClosed();
+        playersOutOfMoney += table->getRoundsPlayed() < rounds;
+        houseResult += startingBalance - table->getBalance();
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    cout << "Tables played on one thread: " << amountOfTables << " (" << closedTables << " closed, "
+         << playersOutOfMoney << " players ran out of money)" << endl;
+    cout << "Rounds played: " << roundsPlayed << ", questions to the players: " << questionsAsked << endl;
+    cout << "House result: " << houseResult << endl;
+    cout << "Table time: " << scheduler.getElapsedSeconds() / 3600 << " hours"
+         << (useSimulatedTime ? " (simulated)" : "") << endl;
+    cout << "Coroutines resumed: " << scheduler.getResumes() << endl;
+    cout << "Elapsed time: " << elapsedSeconds << " s (" << roundsPlayed / elapsedSeconds << " rounds per second)"
+         << endl;
+}
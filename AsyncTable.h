@@ -0,0 +1,106 @@
+/**
+ * The AsyncTable class plays a game of Blackjack as a coroutine (see CoroutineScheduler.h), so that one thread can run
+ * thousands of tables at the same time, each waiting for its own player. The console game blocks its thread until the
+ * user has typed an answer, so it needs a thread per table. A table instead plays the same game, Blackjack::playGame(),
+ * with a RemotePlayer (see Blackjack.h): the game sends every question to the player and waits for the answer with
+ * co_await, and it waits for the pauses between the cards with a timer of the scheduler. Meanwhile, the thread plays
+ * the other tables. The rules are therefore exactly those of the console game, and the cards are drawn from an
+ * infinite deck of the table.
+ *
+ * The players are simulated remote players, which are coroutines as well: they think for a random time (up to a few
+ * seconds, like a user) and then answer with the commands a user would type, betting the minimum bet and hitting or
+ * standing with basic strategy (see PlayerPolicy.h). A real connection would send the questions over the network and
+ * put the answers in the same channel. A player leaves the table when the rounds are over, and the game ends by itself
+ * when their balance is below the minimum bet.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_ASYNCTABLE_H
+#define PIE_CPP_BLACKJACK_ASYNCTABLE_H
+
+#include <cstdint>
+#include <random>
+
+#include "CardSource.h"
+#include "Blackjack.h"
+#include "CoroutineScheduler.h"
+#include "Money.h"
+#include "PlayerPolicy.h"
+
+class AsyncTable {
+private:
+    static constexpr double LONGEST_THINKING_TIME = 4; // in seconds
+    const Money MINIMUM_BET = Money::fromWholeAmount(1);
+    const int AMOUNT_OF_ROUNDS;
+
+    CoroutineScheduler &scheduler;
+    InfiniteDeck deck;
+    RemotePlayer connection; // the channels between the game and the player
+    Blackjack game;
+    uint64_t questionsAsked = 0;
+
+    // The simulated remote player
+    BasicStrategyPolicy policy;
+    std::minstd_rand thinkingTimeGenerator; // small, as there are thousands of players
+
+    // Declared after the connection and the game, so the coroutines are destroyed before what they may be waiting for
+    Task player;
+    Task table;
+
+    /**
+     * This coroutine sets up the game with a player with a balance of "startingBalance", where a blackjack pays
+     * "blackjackPayout" and the dealer's second card follows "holeCardRule", and plays it until the player leaves. The
+     * player is then told that the table is closed.
+     */
+    Task playTable(Money startingBalance, PayoutRatio blackjackPayout, HoleCardRule holeCardRule);
+
+    /**
+     * This coroutine plays the simulated remote player: it answers every question of the game after thinking about
+     * it, until the table is closed.
+     */
+    Task simulatePlayer();
+
+public:
+    /**
+     * Constructor for a table on the input "scheduler", which immediately starts a game of "amountOfRounds" rounds with
+     * a player with a balance of "startingBalance". A blackjack pays "blackjackPayout" and the dealer's second card
+     * follows "holeCardRule". The cards and the thinking times of the player are random numbers seeded with "seed".
+     * The scheduler is not copied, so it must outlive the table.
+     */
+    AsyncTable(CoroutineScheduler &scheduler, int amountOfRounds, Money startingBalance, PayoutRatio blackjackPayout,
+               HoleCardRule holeCardRule, uint64_t seed);
+
+    AsyncTable(const AsyncTable &) = delete;
+    AsyncTable &operator=(const AsyncTable &) = delete;
+
+    /**
+     * This function returns true if the game at the table is over.
+     */
+    bool isClosed() const;
+
+    /**
+     * This function returns the amount of rounds played at the table.
+     */
+    int getRoundsPlayed() const;
+
+    /**
+     * This function returns the amount of questions the table has asked its player.
+     */
+    uint64_t getQuestionsAsked() const;
+
+    /**
+     * This function returns the balance of the player.
+     */
+    Money getBalance() const;
+
+    /**
+     * This function plays "amountOfTables" tables of "rounds" rounds each on this thread, with players that start with
+     * "startingBalance", and prints how long it took. A blackjack pays "blackjackPayout", the dealer's second card
+     * follows "holeCardRule" and table i is seeded with "seed" + i. The pauses and thinking times take real time,
+     * unless "useSimulatedTime" is true.
+     */
+    static void runTables(int amountOfTables, int rounds, Money startingBalance, PayoutRatio blackjackPayout,
+                          HoleCardRule holeCardRule, uint64_t seed, bool useSimulatedTime);
+};
+
+
+#endif //PIE_CPP_BLACKJACK_ASYNCTABLE_H
@@ -0,0 +1,302 @@
+/**
+ * The BankrollSimulator class estimates how a player's bankroll develops over many rounds of Blackjack. It plays many
+ * independent sessions, each starting with the same bankroll, in which the player bets according to a betting
+ * strategy and plays their hands with basic strategy (see RoundSimulator and PlayerPolicy). A session ends when the
+ * player can no longer place the minimum bet (ruin, like the game over in the console game) or after a fixed amount of
+ * rounds. The simulator then reports the risk of ruin, the time to ruin and percentiles of the final bankroll.
+ *
+ * The available betting strategies are:
+ *  - FLAT: always bet one betting unit.
+ *  - KELLY: bet a fraction of the Kelly bet, which is the bankroll times the player's edge divided by the variance of
+ *    a round. The edge and variance of the rules are measured in a short pilot simulation first, and the edge is
+ *    increased by half a percent for every point of true count. When the edge is negative, the minimum bet is placed.
+ *  - COUNT_SPREAD: bet one betting unit per point of Hi-Lo true count, between 1 and the maximum spread of units.
+ *
+ * The cards are dealt from a Shoe, which keeps the true count, or from an infinite deck if the amount of decks is 0.
+ *
+ * The sessions do not depend on each other, so they are spread over all cores of the computer. Every session gets its
+ * own card source, seeded with the session number, so the results do not depend on the amount of threads. Instead of
+ * storing the course of every session, every thread adds its results to its own QuantileSketch objects, which are
+ * merged when all threads have finished.
+ *
+ * Money is counted in cents (whole numbers, see Money.h) during the sessions, so no rounding errors build up over
+ * millions of rounds. Every session is a seat in a Ledger, to which the threads post every settlement without locks.
+ * The ledger is applied in batches while the sessions run, and its final snapshot gives the exact result of the house.
+ */
+
+#include "BankrollSimulator.h"
+#include "ContinuousShuffler.h"
+#include "Shoe.h"
+#include "WeightedDeck.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cout, std::endl, std::cerr, std::vector;
+
+/**
+ * Constructor for a BankrollSimulator with the input "settings_".
+ */
+BankrollSimulator::BankrollSimulator(const BankrollSettings &settings_)
+        : settings(settings_),
+          finalBankrollSketch(0, 4 * settings_.startingBankroll.toDecimal(), AMOUNT_OF_SKETCH_BINS),
+          ruinRoundSketch(0, settings_.roundsPerSession, std::min(AMOUNT_OF_SKETCH_BINS, settings_.roundsPerSession)) {}
+
+/**
+ * This function returns the amount the player wins per unit of bet for the input "outcome". Like
+ * Blackjack::payout(), this is the "blackjackPayout" (1.5 for 3:2) for a blackjack, 1 for a normal win, 0 for a
+ * tie and -1 for a loss.
+ */
+double BankrollSimulator::winFactor(RoundOutcome outcome, PayoutRatio blackjackPayout) {
+    switch (outcome) {
+        case RoundOutcome::PLAYER_BLACKJACK:
+            return (double) blackjackPayout.numerator / blackjackPayout.denominator;
+        case RoundOutcome::PLAYER_WIN:
+            return 1;
+        case RoundOutcome::PUSH:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * This function returns the amount the player wins with the input "bet" for the input "outcome", like winFactor()
+ * but exact: the bet paid at "blackjackPayout" (rounded down to a whole cent) for a blackjack, the bet for a normal
+ * win, 0 for a tie and minus the bet for a loss.
+ */
+Money BankrollSimulator::winnings(RoundOutcome outcome, Money bet, PayoutRatio blackjackPayout) {
+    switch (outcome) {
+        case RoundOutcome::PLAYER_BLACKJACK:
+            return bet.payout(blackjackPayout);
+        case RoundOutcome::PLAYER_WIN:
+            return bet;
+        case RoundOutcome::PUSH:
+            return Money();
+        default:
+            return -bet;
+    }
+}
+
+/**
+ * This function returns the betting strategy with the input "name" ("flat", "kelly" or "count"). For an unknown
+ * name an error is displayed and the program is exited.
+ */
+BettingStrategy BankrollSimulator::parseBettingStrategy(const string &name) {
+    if (name == "flat") {
+        return BettingStrategy::FLAT;
+    } else if (name == "kelly") {
+        return BettingStrategy::KELLY;
+    } else if (name == "count") {
+        return BettingStrategy::COUNT_SPREAD;
+    }
+    cerr << "Error: betting strategy is not \"flat\", \"kelly\" or \"count\"" << endl;
+    exit(-1);
+}
+
+/**
+ * This function plays a short pilot simulation with flat bets to measure the edge and variance of a round under
+ * the rules of the game. These are needed by the Kelly betting strategy.
+ */
+void BankrollSimulator::estimateEdgeAndVariance() {
+    std::unique_ptr<CardSource> cardSource = createCardSource(settings.seed ^ 0x9E3779B97F4A7C15ULL);
+    BasicStrategyPolicy policy;
+    RoundSimulator simulator(*cardSource, policy);
+    simulator.setHoleCardRule(settings.holeCardRule);
+
+    double sum = 0;
+    double sumOfSquares = 0;
+    for (int round = 0; round < PILOT_ROUNDS; ++round) {
+        double win = winFactor(simulator.playRound(), settings.blackjackPayout);
+        sum += win;
+        sumOfSquares += win * win;
+    }
+    edgePerRound = sum / PILOT_ROUNDS;
+    variancePerRound = sumOfSquares / PILOT_ROUNDS - edgePerRound * edgePerRound;
+}
+
+/**
+ * This function creates the card source for a session or simulation, seeded with the input "seed": a Shoe, an
+ * infinite deck if the amount of decks in the settings is 0, a ContinuousShuffler if it has slots, or a WeightedDeck
+ * if a deck composition is given.
+ */
+std::unique_ptr<CardSource> BankrollSimulator::createCardSource(uint64_t seed) {
+    if (settings.amountOfDecks <= 0) {
+        return std::make_unique<InfiniteDeck>(seed);
+    }
+    if (settings.shufflerSlots > 0) {
+        return std::make_unique<ContinuousShuffler>(settings.amountOfDecks, settings.shufflerSlots,
+                                                    settings.shufflerBufferMinimum, seed);
+    }
+    if (!settings.deckComposition.empty()) {
+        return std::make_unique<WeightedDeck>(settings.deckComposition, settings.amountOfDecks, settings.penetration,
+                                              seed);
+    }
+    return std::make_unique<Shoe>(settings.amountOfDecks, settings.penetration, seed);
+}
+
+/**
+ * This function returns the bet to place for the coming round according to the betting strategy, based on the
+ * current "bankroll" and "trueCount". The bet is a whole amount of at least the minimum bet and at most the
+ * bankroll.
+ */
+Money BankrollSimulator::determineBet(Money bankroll, double trueCount) {
+    double bet = settings.minimumBet.toDecimal();
+
+    if (settings.strategy == BettingStrategy::FLAT) {
+        bet = settings.bettingUnit.toDecimal();
+    } else if (settings.strategy == BettingStrategy::KELLY) {
+        double edge = edgePerRound + EDGE_PER_TRUE_COUNT * trueCount;
+        if (edge > 0) {
+            bet = settings.kellyFraction * bankroll.toDecimal() * edge / variancePerRound;
+        }
+    } else if (settings.strategy == BettingStrategy::COUNT_SPREAD) {
+        double units = std::floor(trueCount);
+        units = std::max(1.0, std::min(units, (double) settings.maximumSpread));
+        bet = units * settings.bettingUnit.toDecimal();
+    }
+
+    // Like in the console game, the bet is a whole amount that the player can afford
+    Money wholeBet = std::max(Money::fromWholeAmount((int64_t) std::floor(bet)), settings.minimumBet);
+    return std::min(wholeBet, bankroll);
+}
+
+/**
+ * This function plays the sessions with numbers "firstSession" up to (not including) "endSession" and adds their
+ * results to the input sketches and counters. Every settlement is posted to the seat of its session in the input
+ * "ledger" as "writer". It is run by every thread for its own part of the sessions.
+ */
+void BankrollSimulator::simulateSessions(int firstSession, int endSession, QuantileSketch &finalBankrolls,
+                                         QuantileSketch &ruinRounds, uint64_t &ruined, uint64_t &roundsPlayed,
+                                         Ledger &ledger, int writer) {
+    BasicStrategyPolicy policy;
+
+    for (int session = firstSession; session < endSession; ++session) {
+        std::unique_ptr<CardSource> cardSource = createCardSource(settings.seed + session);
+        RoundSimulator simulator(*cardSource, policy);
+        simulator.setHoleCardRule(settings.holeCardRule);
+
+        Money bankroll = settings.startingBankroll;
+        ledger.post(writer, session, bankroll);
+        int round = 0;
+        while (round < settings.roundsPerSession && bankroll >= settings.minimumBet) {
+            Money bet = determineBet(bankroll, cardSource->getTrueCount());
+            Money won = winnings(simulator.playRound(), bet, settings.blackjackPayout);
+            bankroll += won;
+            ledger.post(writer, session, won);
+            round++;
+        }
+
+        roundsPlayed += round;
+        finalBankrolls.add(bankroll.toDecimal());
+        if (bankroll < settings.minimumBet) {
+            ruined++;
+            ruinRounds.add(round);
+        }
+    }
+}
+
+/**
+ * This function runs all sessions, spread over the threads, and merges their results.
+ */
+void BankrollSimulator::run() {
+    auto startTime = std::chrono::steady_clock::now();
+
+    if (settings.strategy == BettingStrategy::KELLY) {
+        estimateEdgeAndVariance();
+    }
+
+    int amountOfThreads = settings.threads;
+    if (amountOfThreads <= 0) {
+        amountOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Every thread gets its own sketches and counters, so no locking is needed while the sessions are played
+    vector<QuantileSketch> threadFinalBankrolls(amountOfThreads, finalBankrollSketch);
+    vector<QuantileSketch> threadRuinRounds(amountOfThreads, ruinRoundSketch);
+    vector<uint64_t> threadRuined(amountOfThreads, 0);
+    vector<uint64_t> threadRoundsPlayed(amountOfThreads, 0);
+
+    Ledger ledger(settings.sessions, amountOfThreads);
+    std::atomic<int> finishedThreads{0};
+
+    vector<std::thread> threads;
+    for (int t = 0; t < amountOfThreads; ++t) {
+        int firstSession = (int) ((long long) settings.sessions * t / amountOfThreads);
+        int endSession = (int) ((long long) settings.sessions * (t + 1) / amountOfThreads);
+        threads.emplace_back([this, t, firstSession, endSession, &threadFinalBankrolls, &threadRuinRounds,
+                                     &threadRuined, &threadRoundsPlayed, &ledger, &finishedThreads]() {
+            simulateSessions(firstSession, endSession, threadFinalBankrolls[t], threadRuinRounds[t], threadRuined[t],
+                             threadRoundsPlayed[t], ledger, t);
+            finishedThreads++;
+        });
+    }
+
+    // While the sessions are played, this thread applies the settlements to the ledger in batches
+    while (finishedThreads < amountOfThreads) {
+        ledger.applyPending();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (int t = 0; t < amountOfThreads; ++t) {
+        threads[t].join();
+        finalBankrollSketch.merge(threadFinalBankrolls[t]);
+        ruinRoundSketch.merge(threadRuinRounds[t]);
+        ruinedSessions += threadRuined[t];
+        totalRoundsPlayed += threadRoundsPlayed[t];
+    }
+
+    // The house wins what the players have lost: their starting bankrolls minus their final balances
+    LedgerSnapshot snapshot = ledger.getSnapshot();
+    houseResult = Money::fromCents(settings.sessions * settings.startingBankroll.getCents());
+    for (Money balance : snapshot.balances) {
+        houseResult -= balance;
+    }
+    settlementsInLedger = snapshot.entriesApplied;
+
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * This function prints the risk of ruin, the time to ruin and the percentiles of the final bankroll to the console.
+ */
+void BankrollSimulator::printReport() {
+    const double percentiles[] = {0.05, 0.25, 0.5, 0.75, 0.95};
+
+    cout << "Sessions: " << settings.sessions << " of at most " << settings.roundsPerSession
+         << " rounds, starting with " << settings.startingBankroll << ", ";
+    if (settings.amountOfDecks > 0) {
+        cout << settings.amountOfDecks << (settings.shufflerSlots > 0 ? " decks in a continuous shuffler"
+                                           : settings.deckComposition.empty() ? " decks" : " weighted decks") << endl;
+    } else {
+        cout << "infinite deck" << endl;
+    }
+    if (settings.strategy == BettingStrategy::KELLY) {
+        cout << "Measured edge per round: " << edgePerRound * 100 << "%, variance: " << variancePerRound << endl;
+    }
+    cout << "Rounds played: " << totalRoundsPlayed << " in " << elapsedSeconds << " s" << endl;
+    cout << "Risk of ruin: " << 100.0 * ruinedSessions / settings.sessions << "%" << endl;
+    cout << "Result of the house: " << houseResult << " (exact, from " << settlementsInLedger << " ledger entries)"
+         << endl;
+
+    if (ruinedSessions > 0) {
+        cout << "Time to ruin (rounds):";
+        for (double percentile : percentiles) {
+            cout << "  P" << (int) (percentile * 100) << "=" << ruinRoundSketch.getQuantile(percentile);
+        }
+        cout << endl;
+    }
+
+    cout << "Final bankroll:";
+    for (double percentile : percentiles) {
+        cout << "  P" << (int) (percentile * 100) << "=" << finalBankrollSketch.getQuantile(percentile);
+    }
+    cout << endl << "(bankrolls above " << 4 * settings.startingBankroll.toDecimal() << " are counted as "
+         << 4 * settings.startingBankroll.toDecimal() << ")" << endl;
+}
@@ -0,0 +1,156 @@
+/**
+ * The BankrollSimulator class estimates how a player's bankroll develops over many rounds of Blackjack. It plays many
+ * independent sessions, each starting with the same bankroll, in which the player bets according to a betting
+ * strategy and plays their hands with basic strategy (see RoundSimulator and PlayerPolicy). A session ends when the
+ * player can no longer place the minimum bet (ruin, like the game over in the console game) or after a fixed amount of
+ * rounds. The simulator then reports the risk of ruin, the time to ruin and percentiles of the final bankroll.
+ *
+ * The available betting strategies are:
+ *  - FLAT: always bet one betting unit.
+ *  - KELLY: bet a fraction of the Kelly bet, which is the bankroll times the player's edge divided by the variance of
+ *    a round. The edge and variance of the rules are measured in a short pilot simulation first, and the edge is
+ *    increased by half a percent for every point of true count. When the edge is negative, the minimum bet is placed.
+ *  - COUNT_SPREAD: bet one betting unit per point of Hi-Lo true count, between 1 and the maximum spread of units.
+ *
+ * The cards are dealt from a Shoe, which keeps the true count, or from an infinite deck if the amount of decks is 0.
+ *
+ * The sessions do not depend on each other, so they are spread over all cores of the computer. Every session gets its
+ * own card source, seeded with the session number, so the results do not depend on the amount of threads. Instead of
+ * storing the course of every session, every thread adds its results to its own QuantileSketch objects, which are
+ * merged when all threads have finished.
+ *
+ * Money is counted in cents (whole numbers, see Money.h) during the sessions, so no rounding errors build up over
+ * millions of rounds. Every session is a seat in a Ledger, to which the threads post every settlement without locks.
+ * The ledger is applied in batches while the sessions run, and its final snapshot gives the exact result of the house.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_BANKROLLSIMULATOR_H
+#define PIE_CPP_BLACKJACK_BANKROLLSIMULATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::vector;
+
+#include "Ledger.h"
+#include "Money.h"
+#include "QuantileSketch.h"
+#include "RoundSimulator.h"
+
+enum class BettingStrategy {
+    FLAT,
+    KELLY,
+    COUNT_SPREAD
+};
+
+struct BankrollSettings {
+    BettingStrategy strategy = BettingStrategy::FLAT;
+    Money startingBankroll = Money::fromWholeAmount(100);
+    Money bettingUnit = Money::fromWholeAmount(1);
+    Money minimumBet = Money::fromWholeAmount(1);
+    PayoutRatio blackjackPayout = {3, 2};
+    HoleCardRule holeCardRule = HoleCardRule::PEEK;
+    double kellyFraction = 0.5;
+    int maximumSpread = 8;
+    int amountOfDecks = 6; // 0 uses an infinite deck, which cannot be counted
+    double penetration = 0.75;
+    vector<int> deckComposition; // cards per rank of one deck for a WeightedDeck, empty for standard decks in a Shoe
+    int shufflerSlots = 0;       // the slots of a ContinuousShuffler, 0 to deal from a Shoe instead
+    int shufflerBufferMinimum = 10;
+    int roundsPerSession = 1000;
+    int sessions = 100000;
+    int threads = 0; // 0 uses all cores of the computer
+    uint64_t seed = 1;
+};
+
+class BankrollSimulator {
+private:
+    const int AMOUNT_OF_SKETCH_BINS = 4096;
+    const int PILOT_ROUNDS = 1000000;
+    const double EDGE_PER_TRUE_COUNT = 0.005;
+
+    BankrollSettings settings;
+
+    // The edge and variance per round for a bet of 1, measured by estimateEdgeAndVariance() for the Kelly strategy
+    double edgePerRound = 0;
+    double variancePerRound = 1;
+
+    QuantileSketch finalBankrollSketch;
+    QuantileSketch ruinRoundSketch;
+    uint64_t ruinedSessions = 0;
+    uint64_t totalRoundsPlayed = 0;
+    double elapsedSeconds = 0;
+
+    // The result of the house over all sessions and the amount of settlements, from the final snapshot of the ledger
+    Money houseResult;
+    uint64_t settlementsInLedger = 0;
+
+    /**
+     * This function plays a short pilot simulation with flat bets to measure the edge and variance of a round under
+     * the rules of the game. These are needed by the Kelly betting strategy.
+     */
+    void estimateEdgeAndVariance();
+
+    /**
+     * This function creates the card source for a session or simulation, seeded with the input "seed": a Shoe, an
+     * infinite deck if the amount of decks in the settings is 0, a ContinuousShuffler if it has slots, or a
+     * WeightedDeck if a deck composition is given.
+     */
+    std::unique_ptr<CardSource> createCardSource(uint64_t seed);
+
+    /**
+     * This function returns the bet to place for the coming round according to the betting strategy, based on the
+     * current "bankroll" and "trueCount". The bet is a whole amount of at least the minimum bet and at most the
+     * bankroll.
+     */
+    Money determineBet(Money bankroll, double trueCount);
+
+    /**
+     * This function plays the sessions with numbers "firstSession" up to (not including) "endSession" and adds their
+     * results to the input sketches and counters. Every settlement is posted to the seat of its session in the input
+     * "ledger" as "writer". It is run by every thread for its own part of the sessions.
+     */
+    void simulateSessions(int firstSession, int endSession, QuantileSketch &finalBankrolls, QuantileSketch &ruinRounds,
+                          uint64_t &ruined, uint64_t &roundsPlayed, Ledger &ledger, int writer);
+
+public:
+    /**
+     * Constructor for a BankrollSimulator with the input "settings_".
+     */
+    explicit BankrollSimulator(const BankrollSettings &settings_);
+
+    /**
+     * This function returns the amount the player wins per unit of bet for the input "outcome". Like
+     * Blackjack::payout(), this is the "blackjackPayout" (1.5 for 3:2) for a blackjack, 1 for a normal win, 0 for a
+     * tie and -1 for a loss.
+     */
+    static double winFactor(RoundOutcome outcome, PayoutRatio blackjackPayout = {3, 2});
+
+    /**
+     * This function returns the amount the player wins with the input "bet" for the input "outcome", like winFactor()
+     * but exact: the bet paid at "blackjackPayout" (rounded down to a whole cent) for a blackjack, the bet for a normal
+     * win, 0 for a tie and minus the bet for a loss.
+     */
+    static Money winnings(RoundOutcome outcome, Money bet, PayoutRatio blackjackPayout);
+
+    /**
+     * This function returns the betting strategy with the input "name" ("flat", "kelly" or "count"). For an unknown
+     * name an error is displayed and the program is exited.
+     */
+    static BettingStrategy parseBettingStrategy(const string &name);
+
+    /**
+     * This function runs all sessions, spread over the threads, and merges their results.
+     */
+    void run();
+
+    /**
+     * This function prints the risk of ruin, the time to ruin and the percentiles of the final bankroll to the console.
+     */
+    void printReport();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_BANKROLLSIMULATOR_H
@@ -0,0 +1,41 @@
+// Generated with --strategy-chart for 6 decks with a dealer that peeks. Generate it again instead of editing it
+
+#ifndef PIE_CPP_BLACKJACK_BASIC_STRATEGY_CHART_H
+#define PIE_CPP_BLACKJACK_BASIC_STRATEGY_CHART_H
+
+#include "StrategyChart.h"
+
+// The columns are the dealer card values 2-11 (an Ace is 11)
+inline constexpr StrategyChart BASIC_STRATEGY_CHART = {
+        {
+                "HHHHHHHHHH", // hard 4
+                "HHHHHHHHHH", // hard 5
+                "HHHHHHHHHH", // hard 6
+                "HHHHHHHHHH", // hard 7
+                "HHHHHHHHHH", // hard 8
+                "HHHHHHHHHH", // hard 9
+                "HHHHHHHHHH", // hard 10
+                "HHHHHHHHHH", // hard 11
+                "HHHSSHHHHH", // hard 12
+                "SSSSSHHHHH", // hard 13
+                "SSSSSHHHHH", // hard 14
+                "SSSSSHHHHH", // hard 15
+                "SSSSSHHHHH", // hard 16
+                "SSSSSSSSSS", // hard 17
+                "SSSSSSSSSS", // hard 18
+                "SSSSSSSSSS", // hard 19
+                "SSSSSSSSSS", // hard 20
+        },
+        {
+                "HHHHHHHHHH", // soft 12
+                "HHHHHHHHHH", // soft 13
+                "HHHHHHHHHH", // soft 14
+                "HHHHHHHHHH", // soft 15
+                "HHHHHHHHHH", // soft 16
+                "HHHHHHHHHH", // soft 17
+                "SSSSSSSHHH", // soft 18
+                "SSSSSSSSSS", // soft 19
+                "SSSSSSSSSS", // soft 20
+        }};
+
+#endif //PIE_CPP_BLACKJACK_BASIC_STRATEGY_CHART_H
@@ -0,0 +1,363 @@
+/**
+ * The BatchRoundSimulator class plays thousands of independent rounds of Blackjack in lockstep, instead of one round
+ * after the other like the RoundSimulator. The course of a round in Blackjack::playRound() is full of branches that
+ * depend on random cards, which processors cannot predict. Here every step of the round is done for all rounds of the
+ * batch at once, working on arrays (see HandBatch) with a flag per round instead of branches:
+ *  1. dealing: the player gets two cards and the dealer an open card and a hole card, in every round;
+ *  2. the player's decisions: a round in which the dealer peeks and has blackjack is finished, with a single
+ *     comparison of the packed dealer's hand. As long as any round still has a player that hits, one card is drawn for
+ *     exactly those rounds. The decision is looked up in a table that is filled from a PlayerPolicy once, when the
+ *     simulator is created. Players that stand, have 21 or go over 21 are finished;
+ *  3. the dealer's draws: as long as any round with a standing player has a dealer below 17, one card is drawn for
+ *     exactly those rounds. With the DealerTable, the dealer's final total is picked for all rounds at once instead,
+ *     with one random number per round;
+ *  4. settlement: the outcome of every round is calculated without branches, with the same result as
+ *     Blackjack::determineOutcome().
+ *
+ * The cards are drawn like the Card class does, from an infinite deck, with a small and fast random number generator
+ * per round, so that a whole array of ranks is filled at once. The results are added up in half bets, so they are
+ * exact whole numbers.
+ */
+
+#include "BatchRoundSimulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "CardSource.h"
+#include "DealerTable.h"
+#include "Instrumentation.h"
+#include "RoundSimulator.h"
+#include "RunningStatistics.h"
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cout, std::endl;
+
+/**
+ * Constructor for a simulator that plays "amountOfRounds_" rounds per batch with the decisions of the input
+ * "policy", seeded with the input "seed". If "useDealerTable_" is true, the dealer's final totals are picked from
+ * the DealerTable instead of drawing the dealer's cards. The dealer gets a hole card and peeks, unless "holeCardRule"
+ * is NO_HOLE_CARD.
+ */
+BatchRoundSimulator::BatchRoundSimulator(int amountOfRounds_, PlayerPolicy &policy, uint64_t seed,
+                                         bool useDealerTable_, HoleCardRule holeCardRule)
+        : amountOfRounds(amountOfRounds_), useDealerTable(useDealerTable_),
+          dealsHoleCard(holeCardRule == HoleCardRule::PEEK), randomX(amountOfRounds_), randomY(amountOfRounds_),
+          randomZ(amountOfRounds_), randomW(amountOfRounds_), playerHands(amountOfRounds_),
+          dealerHands(amountOfRounds_), dealerCardValues(playerHands.getPaddedSize(), 0),
+          ranks(playerHands.getPaddedSize(), 0), playerIsPlaying(playerHands.getPaddedSize(), 0),
+          playerStands(playerHands.getPaddedSize(), 0), tableDealerSums(playerHands.getPaddedSize(), 0),
+          tableDealerCardCounts(playerHands.getPaddedSize(), 0) {
+    // Seeding the generator of every round with splitmix64, so that no generator starts with only zeros
+    uint64_t seedState = seed;
+    for (int i = 0; i < amountOfRounds; ++i) {
+        uint32_t *words[4] = {&randomX[i], &randomY[i], &randomZ[i], &randomW[i]};
+        for (uint32_t *word : words) {
+            uint64_t mixed = (seedState += 0x9E3779B97F4A7C15ULL);
+            mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+            *word = (uint32_t) ((mixed ^ (mixed >> 31)) >> 32) | 1;
+        }
+    }
+
+    // Asking the policy once for every possible decision, so that deciding is a table lookup during the rounds
+    for (int soft = 0; soft <= 1; ++soft) {
+        for (int sum = 2; sum <= 21; ++sum) {
+            for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+                hitTable[soft][sum][dealerCardValue] = policy.shouldHit(sum, soft == 1, dealerCardValue, 0) ? 1 : 0;
+            }
+        }
+    }
+}
+
+/**
+ * This function advances the xorshift128 random number generator (Marsaglia) with the words "x", "y", "z" and "w" and
+ * returns its next 32-bit random number.
+ */
+static inline uint32_t nextRandomBits(uint32_t &x, uint32_t &y, uint32_t &z, uint32_t &w) {
+    uint32_t t = x ^ (x << 11);
+    x = y;
+    y = z;
+    z = w;
+    w = w ^ (w >> 19) ^ t ^ (t >> 8);
+    return w;
+}
+
+/**
+ * This function fills the array of ranks with a random rank (1-13) for every round, using a xorshift random number
+ * generator. Rounds whose "mask" is 0 get rank 0, which HandBatch::addRanks() skips.
+ */
+void BatchRoundSimulator::drawRanks(const int8_t *mask) {
+    uint32_t *x = randomX.data();
+    uint32_t *y = randomY.data();
+    uint32_t *z = randomZ.data();
+    uint32_t *w = randomW.data();
+    int8_t *rankOfRound = ranks.data();
+
+    for (int i = 0; i < amountOfRounds; ++i) {
+        // The upper 16 bits of the random number are scaled to 13 ranks without a division
+        uint32_t randomBits = nextRandomBits(x[i], y[i], z[i], w[i]);
+        int rank = 1 + (int) (((randomBits >> 16) * 13) >> 16);
+        rankOfRound[i] = (int8_t) (mask == nullptr ? rank : rank * mask[i]);
+    }
+}
+
+/**
+ * This function plays one batch of rounds in lockstep and adds their results to the totals.
+ */
+void BatchRoundSimulator::playBatch() {
+    playerHands.clear();
+    dealerHands.clear();
+
+    // 1. Dealing in the order of a real table: the player, the dealer's open card, the player again and the dealer's
+    // hole card
+    drawRanks(nullptr);
+    playerHands.addRanks(ranks.data());
+    drawRanks(nullptr);
+    dealerHands.addRanks(ranks.data());
+    const int16_t *dealerSumsOfGameValues = dealerHands.getSumsOfGameValues();
+    std::copy(dealerSumsOfGameValues, dealerSumsOfGameValues + amountOfRounds, dealerCardValues.begin());
+    drawRanks(nullptr);
+    playerHands.addRanks(ranks.data());
+    if (dealsHoleCard) {
+        drawRanks(nullptr);
+        dealerHands.addRanks(ranks.data());
+    }
+
+    // 2. The player's decisions. Like in the console game, a player with 21 or more does not get to decide, and
+    // neither does a player whose dealer has peeked and found a blackjack
+    playerHands.evaluate();
+    const int16_t *playerSums = playerHands.getOptimalSums();
+    const int16_t *playerSoftFlags = playerHands.getSoftFlags();
+    const int16_t *dealerCardCountsBeforeDraws = dealerHands.getCardCounts();
+    for (int i = 0; i < amountOfRounds; ++i) {
+        int dealerBlackjack = Blackjack::isBlackjack(dealerSumsOfGameValues[i], dealerCardCountsBeforeDraws[i]);
+        playerIsPlaying[i] = (int8_t) ((playerSums[i] < 21) & !dealerBlackjack);
+        playerStands[i] = 0;
+    }
+
+    while (true) {
+        int amountOfHits = 0;
+        for (int i = 0; i < amountOfRounds; ++i) {
+            int sum = std::min((int) playerSums[i], 21);
+            int hits = playerIsPlaying[i] & hitTable[playerSoftFlags[i]][sum][dealerCardValues[i]];
+            // A player that is still playing but does not hit, stands
+            playerStands[i] |= (int8_t) (playerIsPlaying[i] & (1 - hits));
+            playerIsPlaying[i] = (int8_t) hits;
+            amountOfHits += hits;
+        }
+        if (amountOfHits == 0) {
+            break;
+        }
+
+        drawRanks(playerIsPlaying.data());
+        playerHands.addRanks(ranks.data());
+        playerHands.evaluate();
+        // A player that reaches 21 or more is finished, without the dealer drawing cards
+        for (int i = 0; i < amountOfRounds; ++i) {
+            playerIsPlaying[i] &= (int8_t) (playerSums[i] < 21);
+        }
+    }
+
+    // Without a hole card, the dealer gets their second card in the rounds where the player has 21, as a dealer's
+    // blackjack still beats a 21 of more cards and ties with a player's blackjack
+    if (!dealsHoleCard) {
+        vector<int8_t> &playerHasTwentyOne = playerIsPlaying; // reusing the array, as all players are finished
+        for (int i = 0; i < amountOfRounds; ++i) {
+            playerHasTwentyOne[i] = (int8_t) (playerSums[i] == 21);
+        }
+        drawRanks(playerHasTwentyOne.data());
+        dealerHands.addRanks(ranks.data());
+    }
+
+    // 3. The dealer's draws, only in the rounds where the player stood
+    const int16_t *dealerSums = dealerHands.getOptimalSums();
+    const int16_t *dealerCardCounts = dealerHands.getCardCounts();
+    if (useDealerTable) {
+        // One random number per round picks the final total. After a peek, the dealer is known not to have blackjack,
+        // so a blackjack is picked again. In the other rounds the dealer keeps the cards that were dealt
+        dealerHands.evaluate();
+        for (int i = 0; i < amountOfRounds; ++i) {
+            int final;
+            do {
+                final = DealerTable::sampleFinalTotal(dealerCardValues[i],
+                                                      nextRandomBits(randomX[i], randomY[i], randomZ[i], randomW[i]));
+            } while (final == DealerTable::FINAL_BLACKJACK && dealerCardCounts[i] == 2);
+            tableDealerSums[i] = (int16_t) (playerStands[i] ? DealerTable::FINAL_SUMS[final] : dealerSums[i]);
+            tableDealerCardCounts[i] = (int16_t) (playerStands[i] ? DealerTable::FINAL_CARD_COUNTS[final]
+                                                                  : dealerCardCounts[i]);
+        }
+        dealerSums = tableDealerSums.data();
+        dealerCardCounts = tableDealerCardCounts.data();
+    }
+
+    vector<int8_t> &dealerDraws = playerIsPlaying; // reusing the array, as all players are finished
+    while (!useDealerTable) {
+        dealerHands.evaluate();
+        int amountOfDraws = 0;
+        for (int i = 0; i < amountOfRounds; ++i) {
+            dealerDraws[i] = (int8_t) (playerStands[i] & (dealerSums[i] < 17));
+            amountOfDraws += dealerDraws[i];
+        }
+        if (amountOfDraws == 0) {
+            break;
+        }
+        drawRanks(dealerDraws.data());
+        dealerHands.addRanks(ranks.data());
+    }
+
+    // 4. Settlement in half bets, with the same result as Blackjack::determineOutcome():
+    // bust player -2, bust dealer +2, only the player has blackjack +3, only the dealer has blackjack -2, and
+    // otherwise the higher sum wins 2 half bets
+    const int16_t *playerCardCounts = playerHands.getCardCounts();
+    int64_t batchHalfBets = 0;
+    int64_t batchSquaredHalfBets = 0;
+    for (int i = 0; i < amountOfRounds; ++i) {
+        int playerSum = playerSums[i];
+        int dealerSum = dealerSums[i];
+        int playerBlackjack = playerSum == 21 && playerCardCounts[i] == 2;
+        int dealerBlackjack = dealerSum == 21 && dealerCardCounts[i] == 2;
+        int higherSumResult = playerSum > dealerSum ? 2 : (playerSum < dealerSum ? -2 : 0);
+        int blackjackResult = playerBlackjack && !dealerBlackjack
+                              ? 3
+                              : (dealerBlackjack && !playerBlackjack ? -2 : higherSumResult);
+        int result = playerSum > 21 ? -2 : (dealerSum > 21 ? 2 : blackjackResult);
+        batchHalfBets += result;
+        batchSquaredHalfBets += result * result;
+    }
+
+    totalHalfBets += batchHalfBets;
+    totalSquaredHalfBets += batchSquaredHalfBets;
+    roundsPlayed += amountOfRounds;
+    INSTRUMENT_COUNT(ROUNDS, amountOfRounds);
+    INSTRUMENT_COUNT(HANDS, 2 * amountOfRounds);
+}
+
+/**
+ * This function returns the sum of the results of all rounds played so far, in half bets (a blackjack wins 3 half
+ * bets, a normal win 2, a tie 0 and a loss -2).
+ */
+int64_t BatchRoundSimulator::getTotalHalfBets() {
+    return totalHalfBets;
+}
+
+/**
+ * This function returns the sum of the squares of the results of all rounds played so far, in half bets squared.
+ */
+int64_t BatchRoundSimulator::getTotalSquaredHalfBets() {
+    return totalSquaredHalfBets;
+}
+
+/**
+ * This function returns the amount of rounds played so far.
+ */
+long long BatchRoundSimulator::getRoundsPlayed() {
+    return roundsPlayed;
+}
+
+/**
+ * This function plays at least "rounds" rounds in batches, spread over "threads" threads (0 for all cores), and
+ * prints the house edge with its 95% confidence interval and the speed. If "scalar" is true, the rounds are played
+ * one after the other with the RoundSimulator instead, for comparison. If "dealerTable" is true, both pick the
+ * dealer's final totals from the DealerTable. The dealer gets a hole card and peeks, unless "holeCardRule" is
+ * NO_HOLE_CARD. If "targetPrecision" is above 0, the threads stop as soon as the confidence interval of the
+ * house edge is within plus or minus "targetPrecision" percent, and "rounds" is only the maximum.
+ */
+void BatchRoundSimulator::runHouseEdge(long long rounds, int threads, uint64_t seed, bool scalar, bool dealerTable,
+                                       HoleCardRule holeCardRule, double targetPrecision) {
+    const int ROUNDS_PER_BATCH = 256;
+    const uint64_t MINIMUM_ROUNDS = 1000000; // a confidence interval of fewer rounds is too rough to stop on
+    const auto CHECK_INTERVAL = std::chrono::milliseconds(100);
+    auto startTime = std::chrono::steady_clock::now();
+
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    long long amountOfBatches = (rounds + ROUNDS_PER_BATCH - 1) / ROUNDS_PER_BATCH;
+
+    // Every thread keeps the results of its rounds (in half bets) in its own RunningStatistics, and publishes them in
+    // its slot after every batch. With a target precision, this thread merges the slots while the others play, and
+    // stops them once the confidence interval is narrow enough
+    std::unique_ptr<StatisticsSlot[]> slots(new StatisticsSlot[threads]);
+    vector<RunningStatistics> threadStatistics(threads);
+    std::atomic<bool> stop{false};
+    std::atomic<int> finishedThreads{0};
+    vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([=, &slots, &threadStatistics, &stop, &finishedThreads]() {
+            BasicStrategyPolicy policy;
+            long long firstBatch = amountOfBatches * t / threads;
+            long long endBatch = amountOfBatches * (t + 1) / threads;
+            RunningStatistics &statistics = threadStatistics[t];
+
+            if (scalar) {
+                InfiniteDeck deck(seed + t);
+                RoundSimulator simulator(deck, policy);
+                simulator.setHoleCardRule(holeCardRule);
+                if (dealerTable) {
+                    simulator.useDealerTable(deck);
+                }
+                for (long long batch = firstBatch; batch < endBatch && !stop.load(std::memory_order_relaxed); ++batch) {
+                    for (int round = 0; round < ROUNDS_PER_BATCH; ++round) {
+                        RoundOutcome outcome = simulator.playRound();
+                        statistics.add(outcome == RoundOutcome::PLAYER_BLACKJACK ? 3
+                                       : outcome == RoundOutcome::PLAYER_WIN ? 2
+                                       : outcome == RoundOutcome::PUSH ? 0 : -2);
+                    }
+                    slots[t].publish(statistics);
+                }
+            } else {
+                BatchRoundSimulator simulator(ROUNDS_PER_BATCH, policy, seed + t, dealerTable, holeCardRule);
+                for (long long batch = firstBatch; batch < endBatch && !stop.load(std::memory_order_relaxed); ++batch) {
+                    int64_t halfBetsBefore = simulator.getTotalHalfBets();
+                    int64_t squaredHalfBetsBefore = simulator.getTotalSquaredHalfBets();
+                    simulator.playBatch();
+                    statistics.addBatch(ROUNDS_PER_BATCH, (double) (simulator.getTotalHalfBets() - halfBetsBefore),
+                                        (double) (simulator.getTotalSquaredHalfBets() - squaredHalfBetsBefore));
+                    slots[t].publish(statistics);
+                }
+            }
+            finishedThreads++;
+        });
+    }
+
+    bool precisionReached = false;
+    while (targetPrecision > 0 && finishedThreads.load() < threads) {
+        std::this_thread::sleep_for(CHECK_INTERVAL);
+        RunningStatistics running;
+        for (int t = 0; t < threads; ++t) {
+            running.merge(slots[t].read());
+        }
+        // The house edge is minus the average result, and a half bet is 50% of a bet
+        cout << "\r" << running.getCount() << " rounds: house edge " << -50 * running.getMean() << "% (+/- "
+             << 50 * running.getConfidenceHalfWidth() << "%)     " << std::flush;
+        if (running.getCount() >= MINIMUM_ROUNDS && 50 * running.getConfidenceHalfWidth() <= targetPrecision) {
+            precisionReached = true;
+            stop = true;
+        }
+    }
+    if (targetPrecision > 0) {
+        cout << endl;
+    }
+
+    RunningStatistics total;
+    for (int t = 0; t < threads; ++t) {
+        workers[t].join();
+        total.merge(threadStatistics[t]);
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    cout << (scalar ? "Scalar" : "Lockstep") << " simulation of " << total.getCount() << " rounds on " << threads
+         << " threads in " << elapsedSeconds << " s (" << total.getCount() / elapsedSeconds / 1e6
+         << " million rounds/s)" << endl;
+    cout << "House edge: " << -50 * total.getMean() << "% (+/- " << 50 * total.getConfidenceHalfWidth()
+         << "%, 95% confidence)" << endl;
+    if (targetPrecision > 0 && !precisionReached) {
+        cout << "The precision of +/- " << targetPrecision << "% was not reached within " << rounds << " rounds"
+             << endl;
+    }
+}
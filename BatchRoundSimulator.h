@@ -0,0 +1,112 @@
+/**
+ * The BatchRoundSimulator class plays thousands of independent rounds of Blackjack in lockstep, instead of one round
+ * after the other like the RoundSimulator. The course of a round in Blackjack::playRound() is full of branches that
+ * depend on random cards, which processors cannot predict. Here every step of the round is done for all rounds of the
+ * batch at once, working on arrays (see HandBatch) with a flag per round instead of branches:
+ *  1. dealing: the player gets two cards and the dealer an open card and a hole card, in every round;
+ *  2. the player's decisions: a round in which the dealer peeks and has blackjack is finished, with a single
+ *     comparison of the packed dealer's hand. As long as any round still has a player that hits, one card is drawn for
+ *     exactly those rounds. The decision is looked up in a table that is filled from a PlayerPolicy once, when the
+ *     simulator is created. Players that stand, have 21 or go over 21 are finished;
+ *  3. the dealer's draws: as long as any round with a standing player has a dealer below 17, one card is drawn for
+ *     exactly those rounds. With the DealerTable, the dealer's final total is picked for all rounds at once instead,
+ *     with one random number per round;
+ *  4. settlement: the outcome of every round is calculated without branches, with the same result as
+ *     Blackjack::determineOutcome().
+ *
+ * The cards are drawn like the Card class does, from an infinite deck, with a small and fast random number generator
+ * per round, so that a whole array of ranks is filled at once. The results are added up in half bets, so they are
+ * exact whole numbers.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_BATCHROUNDSIMULATOR_H
+#define PIE_CPP_BLACKJACK_BATCHROUNDSIMULATOR_H
+
+#include <cstdint>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::vector;
+
+#include "Blackjack.h"
+#include "HandBatch.h"
+#include "PlayerPolicy.h"
+
+class BatchRoundSimulator {
+private:
+    int amountOfRounds;
+    bool useDealerTable;
+    bool dealsHoleCard;
+
+    // Every round has its own xorshift128 random number generator, whose four 32-bit words are stored in four arrays,
+    // so that all generators can be advanced at once with SIMD instructions
+    vector<uint32_t> randomX, randomY, randomZ, randomW;
+
+    HandBatch playerHands;
+    HandBatch dealerHands;
+    vector<int16_t> dealerCardValues;
+    vector<int8_t> ranks;
+    vector<int8_t> playerIsPlaying; // 1 while the player may still hit
+    vector<int8_t> playerStands;    // 1 if the player stood below 21, so the dealer has to draw
+
+    // The dealer's final sums and card counts when they are picked from the DealerTable
+    vector<int16_t> tableDealerSums;
+    vector<int16_t> tableDealerCardCounts;
+
+    // hitTable[soft][sum][dealer card value] is 1 if the policy hits and 0 if it stands
+    uint8_t hitTable[2][22][12] = {};
+
+    int64_t totalHalfBets = 0;
+    int64_t totalSquaredHalfBets = 0; // for the variance of the results
+    long long roundsPlayed = 0;
+
+    /**
+     * This function fills the array of ranks with a random rank (1-13) for every round, using the xorshift random
+     * number generator of every round. Rounds whose "mask" is 0 get rank 0, which HandBatch::addRanks() skips.
+     */
+    void drawRanks(const int8_t *mask);
+
+public:
+    /**
+     * Constructor for a simulator that plays "amountOfRounds_" rounds per batch with the decisions of the input
+     * "policy", seeded with the input "seed". If "useDealerTable_" is true, the dealer's final totals are picked from
+     * the DealerTable instead of drawing the dealer's cards. The dealer gets a hole card and peeks, unless "holeCardRule"
+     * is NO_HOLE_CARD.
+     */
+    BatchRoundSimulator(int amountOfRounds_, PlayerPolicy &policy, uint64_t seed, bool useDealerTable_ = false,
+                        HoleCardRule holeCardRule = HoleCardRule::PEEK);
+
+    /**
+     * This function plays one batch of rounds in lockstep and adds their results to the totals.
+     */
+    void playBatch();
+
+    /**
+     * This function returns the sum of the results of all rounds played so far, in half bets (a blackjack wins 3 half
+     * bets, a normal win 2, a tie 0 and a loss -2).
+     */
+    int64_t getTotalHalfBets();
+
+    /**
+     * This function returns the sum of the squares of the results of all rounds played so far, in half bets squared.
+     */
+    int64_t getTotalSquaredHalfBets();
+
+    /**
+     * This function returns the amount of rounds played so far.
+     */
+    long long getRoundsPlayed();
+
+    /**
+     * This function plays at least "rounds" rounds in batches, spread over "threads" threads (0 for all cores), and
+     * prints the house edge with its 95% confidence interval and the speed. If "scalar" is true, the rounds are played
+     * one after the other with the RoundSimulator instead, for comparison. If "dealerTable" is true, both pick the
+     * dealer's final totals from the DealerTable. The dealer gets a hole card and peeks, unless "holeCardRule" is
+     * NO_HOLE_CARD. If "targetPrecision" is above 0, the threads stop as soon as the confidence interval of the
+     * house edge is within plus or minus "targetPrecision" percent, and "rounds" is only the maximum.
+     */
+    static void runHouseEdge(long long rounds, int threads, uint64_t seed, bool scalar, bool dealerTable,
+                             HoleCardRule holeCardRule, double targetPrecision = 0);
+};
+
+
+#endif //PIE_CPP_BLACKJACK_BATCHROUNDSIMULATOR_H
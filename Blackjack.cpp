@@ -12,177 +12,250 @@
 
 #include <iostream>
 #include <string>
-
-// Including <chrono> and <thread> in order to be able to add timed pauses to the code according to:
-// https://cplusplus.com/reference/thread/this_thread/sleep_for/
-#include <chrono>
-#include <thread>
+#include <sstream>
 
 // Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
-using std::cout, std::endl, std::cerr, std::cin, std::isdigit;
+using std::cout, std::endl, std::cerr, std::cin;
 
 #include "Blackjack.h"
+#include "Instrumentation.h"
+#include "Metrics.h"
 
 
 /**
- * This function manages a full round of Blackjack. To start the game, it draws the dealer a card and the player two
- * cards. In between draws, the cards are reprinted to the console and the program is paused to mimic the real world
- * dynamics of a dealer handing out cards. This gives the user time to process the information. Using a while-loop
- * and based on the user's entered response (gathered from calling requestHitOrStand()), the player is drawn another
- * card (hit) or they are not given cards anymore (stand). When the user stands, the dealer is dealt cards as long
- * as their sum of cards is below 17. After this process concludeRound() is called to decide the winner of the round.
+ * This function manages a full round of Blackjack. To start the game, it deals the cards like at a real table: a card
+ * for the player, the dealer's open card, the player's second card and (with a hole card, see HoleCardRule) the
+ * dealer's hole card face down. If the dealer peeks and has blackjack, the round is over. In between draws, the cards
+ * are reprinted to the console and the program is paused to mimic the real world dynamics of a dealer handing out
+ * cards. This gives the user time to process the information. Using a while-loop and based on the user's entered
+ * response (gathered from calling requestHitOrStand()), the player is drawn another card (hit) or they are not given
+ * cards anymore (stand). When the user stands, the dealer turns over the hole card and is dealt cards as long as their
+ * sum of cards is below 17. After this process concludeRound() is called to decide the winner of the round.
+ * The round is a coroutine: it co_awaits the answers of the player and the pauses (see readUserInput() and
+ * waitSeconds()), so with a remote player the thread can play other tables in the meantime.
  */
-void Blackjack::playRound() {
+SubTask<> Blackjack::playRound() {
     playerHand.emptyHand();
     dealerHand.emptyHand();
 
-    thisRoundBet = requestBetAmount();
-    playerMoney = playerMoney - thisRoundBet;
+    thisRoundBet = co_await requestBetAmount();
+    // When the input ended before a bet was placed, the game has been quit and no round is played
+    if (!gameIsRunning) {
+        co_return;
+    }
+    playerMoney -= thisRoundBet;
+    roundsPlayed++;
+    INSTRUMENT_COUNT(ROUNDS, 1);
+    Metrics::count(Metrics::ROUNDS, 1);
+    INSTRUMENT_COUNT(HANDS, 2);
+    if (accountStore != nullptr) {
+        accountStore->placeBet(accountName, thisRoundBet);
+    }
+    publishEvent(TableEvent::ROUND_STARTED);
+    publishEvent(TableEvent::BET_PLACED, 0, 0, thisRoundBet);
 
-    // To start the game, the dealer gets one open card
-    dealerHand.addRandomCards(1);
+    // The cards are dealt one by one in the order of a real table, with a pause after every card to allow the user
+    // time to comprehend which card was drawn: the player, the dealer's open card, the player again, and the dealer's
+    // hole card face down
+    dealCard(playerHand);
     printDealerAndPlayerHands();
-
-    // Adding a pause to allow the user time to comprehend which card the dealer drew
-    waitSeconds(SECONDS_BETWEEN_DRAWS);
-
-    // After the dealer's card is shown, the player gets 2 cards, one by one with a pause in between to mimic real life
-    playerHand.addRandomCards(1);
+    co_await waitSeconds(SECONDS_BETWEEN_DRAWS);
+    dealCard(dealerHand);
     printDealerAndPlayerHands();
-    waitSeconds(SECONDS_BETWEEN_DRAWS);
-    playerHand.addRandomCards(1);
+    co_await waitSeconds(SECONDS_BETWEEN_DRAWS);
+    dealCard(playerHand);
     printDealerAndPlayerHands();
-    waitSeconds(SECONDS_BETWEEN_DRAWS);
+    co_await waitSeconds(SECONDS_BETWEEN_DRAWS);
+    if (holeCardRule == HoleCardRule::PEEK) {
+        dealCard(dealerHand, true);
+        printDealerAndPlayerHands();
+        co_await waitSeconds(SECONDS_BETWEEN_DRAWS);
+
+        // With a dealer's blackjack, the player loses straight away (unless they have blackjack too)
+        if (dealerPeeksBlackjack()) {
+            revealHoleCard();
+            printDealerAndPlayerHands();
+            co_await concludeRound();
+            co_return;
+        }
+    }
 
     // If the player is dealt 21 (blackjack) straight away, go straight to concluding the round without asking
     // whether the user wants another card or not
     if (sumOptimal(playerHand) == 21) {
-        concludeRound();
+        co_await dealDealerSecondCard();
+        co_await concludeRound();
+        co_return;
     }
 
     // Asking whether the player wants to hit (get new card) or stand (let the dealer draw cards and check who won)
-    // This while loop will keep running as long as the user chooses to hit
-    while (requestHitOrStand() == "hit" && sumOptimal(playerHand) < 21) {
-        playerHand.addRandomCards(1);
+    // This while loop will keep running as long as the user chooses to hit. The answer is awaited outside the loop
+    // condition, as GCC 12 does not resume a co_await inside a condition with temporaries correctly
+    string answer = co_await requestHitOrStand();
+    while (answer == "hit" && sumOptimal(playerHand) < 21) {
+        publishEvent(TableEvent::ACTION_TAKEN, 0, TableEvent::HIT);
+        dealCard(playerHand);
         printDealerAndPlayerHands();
-        waitSeconds(SECONDS_BETWEEN_DRAWS);
-        // If the sum goes over 21, the player has busted and the round needs to be concluded
+        co_await waitSeconds(SECONDS_BETWEEN_DRAWS);
+        // If the sum goes over 21, the player has busted and the round needs to be concluded. With 21, the dealer
+        // still needs their second card to find out whether they have blackjack
         if (sumOptimal(playerHand) >= 21) {
-            concludeRound();
+            if (sumOptimal(playerHand) == 21) {
+                co_await dealDealerSecondCard();
+            }
+            co_await concludeRound();
+            co_return;
         }
+        answer = co_await requestHitOrStand();
     }
 
     // At this point, the user has decided to stand because the while condition is no longer true
+    publishEvent(TableEvent::ACTION_TAKEN, 0, TableEvent::STAND);
+
+    // The dealer's turn starts with turning over the hole card
+    if (holeCardRule == HoleCardRule::PEEK) {
+        revealHoleCard();
+        printDealerAndPlayerHands();
+        co_await waitSeconds(SECONDS_BETWEEN_DRAWS);
+    }
 
     // As long as the sum of the dealers' cards are below 17, the dealer has to hit. If it is above 17, the dealer
     // has to stand. If the dealer has an ace, and counting it as 11 would bring the total to 17 or more (but not
     // over 21), the dealer must count the ace as 11 and stand. This while loop keeps adding cards until the sum is
     // above 17:
     while (sumOptimal(dealerHand) < 17) {
-        dealerHand.addRandomCards(1);
-        printDealerAndPlayerHands();
-        // Adding a timed pause to allow the user time to comprehend which card(s) the dealer is drawing. This
-        // method was learned from: https://cplusplus.com/reference/thread/this_thread/sleep_for/
-        std::this_thread::sleep_for(std::chrono::seconds(SECONDS_BETWEEN_DRAWS));
+        // The pause is not part of the dealer's play, as the thread plays other tables meanwhile with a remote player
+        {
+            INSTRUMENT_PHASE(DEALER_PLAY);
+            dealCard(dealerHand);
+            printDealerAndPlayerHands();
+        }
+        // Adding a timed pause to allow the user time to comprehend which card(s) the dealer is drawing
+        co_await waitSeconds(SECONDS_BETWEEN_DRAWS);
     }
 
-    concludeRound();
+    co_await concludeRound();
 }
 
 /**
- * This function concludes a round of Blackjack by determining the outcome of the round based on the final card sums.
- * It evaluates all possible scenarios such as busting (sum > 21), winning with a higher sum, having a tie and it
- * checks the presence of a blackjack (an Ace with a 10-value card) in the initial two cards.
+ * This function concludes a round of Blackjack by determining the outcome of the round based on the final card sums
+ * (see determineOutcome()). It evaluates all possible scenarios such as busting (sum > 21), winning with a higher sum,
+ * having a tie and it checks the presence of a blackjack (an Ace with a 10-value card) in the initial two cards.
  *
- * Using boolean states for who won, the function prints the result of the round using the ASCII by calling printYouWon()
- * and printYouLost(),as well as messages for winning with a blackjack or achieving a tie. Finally, based on user
- * input, a new round is started or the program is quit.
+ * Based on the outcome, the function prints the result of the round using the ASCII by calling printYouWon() and
+ * printYouLost(), as well as messages for winning with a blackjack or achieving a tie, and pays out the player.
+ * Finally, based on user input, the game continues with a new round or is quit.
  */
-void Blackjack::concludeRound() {
-    bool playerWon = false;
-    bool dealerWon = false;
-    bool wonWithBlackjack = false;
-
-    // Storing the player and dealer sums to make the below if-statements easier to read
-    int dealerSum = sumOptimal(dealerHand);
-    int playerSum = sumOptimal(playerHand);
-
-    // Determining who won by going over all the possible situations:
-    if (playerSum > 21) { // Player busted, dealer wins
-        dealerWon = true;
-    } else if (dealerSum > 21) { // Dealer busted, player wins
-        playerWon = true;
-    } else if (playerSum > dealerSum && playerSum < 21) { // Player has higher sum w/o busting, but no blackjack
-        playerWon = true;
-    } else if (dealerSum > playerSum && dealerSum < 21) { // Dealer has higher sum w/o busting, but no blackjack
-        dealerWon = true;
-    } else if (playerSum == 21 && dealerSum != 21) { // Player wins with 21
-        playerWon = true;
-        if (playerHand.getSize() == 2) { // Player has BLACKJACK!
-            wonWithBlackjack = true;
+SubTask<> Blackjack::concludeRound() {
+    // Settling the round is timed apart from the question below, which waits for the user
+    {
+        INSTRUMENT_PHASE(SETTLE);
+        // The cards of this round are done, so a shoe can be reshuffled if the cut card has been reached
+        if (cardSource != nullptr) {
+            cardSource->finishRound();
         }
-    } else if (dealerSum == 21 && playerSum != 21) { // Dealer wins with 21
-        dealerWon = true;
-        if (dealerHand.getSize() == 2) { // Dealer has BLACKJACK!
-            wonWithBlackjack = true;
-        }
-    } else if (dealerSum == 21 && playerSum == 21) {
-        if (playerHand.getSize() == 2 && dealerHand.getSize() != 2) { // Player has won with BLACKJACK!
-            playerWon = true;
-            wonWithBlackjack = true;
-        } else if (playerHand.getSize() != 2 && dealerHand.getSize() == 2) { // Dealer has won with BLACKJACK!
-            dealerWon = true;
-            wonWithBlackjack = true;
-        } else { // A tie, no one wins
-            // All booleans can remain false
+        Money moneyBeforePayout = playerMoney;
+
+        // A round that ends before the dealer's turn (a blackjack or a bust) shows the hole card as well
+        revealHoleCard();
+        publishEvent(TableEvent::DEALER_REVEALED, 0, (uint8_t) sumOptimal(dealerHand));
+        RoundOutcome outcome = determineOutcome(sumOptimal(playerHand), playerHand.getSize(), sumOptimal(dealerHand),
+                                                dealerHand.getSize());
+
+        // Printing who won the round
+        if (outcome == RoundOutcome::PLAYER_BLACKJACK) {
+            *output << "BLACKJACK!" << endl;
+            printYouWon();
+            payout(thisRoundBet, blackjackPayout);
+            *output << "Your payout is " << blackjackPayout.numerator << ":" << blackjackPayout.denominator
+                    << " on your bet, plus your initial bet! Your balance is now: " << playerMoney << endl << endl;
+        } else if (outcome == RoundOutcome::PLAYER_WIN) {
+            printYouWon();
+            payout(thisRoundBet, {1, 1});
+            *output << "Your bet has been doubled! " << "Your balance is now: " << playerMoney << endl << endl;
+        } else if (outcome == RoundOutcome::DEALER_BLACKJACK) {
+            *output << "The dealer has BLACKJACK!" << endl;
+            printYouLost();
+            *output << "You lost your bet. " << "Your balance is now: " << playerMoney << endl << endl;
+        } else if (outcome == RoundOutcome::DEALER_WIN) {
+            printYouLost();
+            *output << "You lost your bet. " << "Your balance is now: " << playerMoney << endl << endl;
+        } else {
+            payout(thisRoundBet, {0, 1});
+            *output << "It's a tie. No one won. Your bet has been returned. " << "Your balance is now: " << playerMoney
+                    << endl << endl;
         }
-    } else if (dealerSum == playerSum) { // A tie, no one wins
-        // All booleans can remain false
-    } else {
-        cerr << "Not defined who won, check code" << endl;
-    }
 
+        publishEvent(TableEvent::ROUND_SETTLED, 0, (uint8_t) outcome, playerMoney);
 
-    // Printing who won the round
-    if (wonWithBlackjack) {
-        cout << "BLACKJACK!" << endl;
-        printYouWon();
-        payout(thisRoundBet, 1.5);
-        cout << "Your payout is one and a half times your bet, plus your initial bet! Your balance is now: "
-             << playerMoney << endl << endl;
-    } else if (playerWon && !wonWithBlackjack) {
-        printYouWon();
-        payout(thisRoundBet, 1);
-        cout << "Your bet has been doubled! " << "Your balance is now: " << playerMoney << endl << endl;
-    } else if (dealerWon) {
-        printYouLost();
-        cout << "You lost your bet. " << "Your balance is now: " << playerMoney << endl << endl;
-    } else {
-        cout << "It's a tie. No one won. Your bet has been returned. " << "Your balance is now: " << playerMoney << endl
-             << endl;
+        // The payout is stored in the account before the game goes on, so a crash cannot lose it
+        if (accountStore != nullptr) {
+            accountStore->waitUntilDurable(accountStore->settleBet(accountName, playerMoney - moneyBeforePayout));
+        }
     }
 
     // If the player does not have enough money to place a bet of at least 1, the game is over...
-    if (playerMoney < 1) {
-        cout << "Oops! It looks like you don't have enough balance to place a bet. The game is over." << endl << endl;
+    if (playerMoney < MINIMUM_BET) {
+        *output << "Oops! It looks like you don't have enough balance to place a bet. The game is over." << endl << endl;
         quitGame();
+        co_return;
     }
 
-    // Asking whether the user wants to play a new round
+    // Asking whether the user wants to play a new round. Starting the round itself is left to playGame()
     string userInput;
-    cout << "Enter 's' to start a new round or 'q' to quit the game: " <<
-         endl;
-    while (true) {
-        cin >> userInput;
+    *output << "Enter 's' to start a new round or 'q' to quit the game: " << endl;
+    while (co_await readUserInput(userInput, TableQuestion::START_OR_QUIT)) {
         if (userInput == "s" || userInput == "S") {
-            playRound();
             break;
         } else if (userInput == "q" || userInput == "Q") {
             quitGame();
             break;
         } else {
-            cout << "Invalid input, please try again. Enter 's' to start or 'q' to quit the game" << endl;
+            *output << "Invalid input, please try again. Enter 's' to start or 'q' to quit the game" << endl;
+        }
+    }
+}
+
+/**
+ * This function determines the outcome of a round based on the final sums and the amount of cards of the player
+ * ("playerSum", "playerCardCount") and the dealer ("dealerSum", "dealerCardCount"). It evaluates all possible
+ * scenarios such as busting (sum > 21), winning with a higher sum, having a tie and it checks the presence of a
+ * blackjack (21 with the initial two cards). The function only uses plain numbers, so the same rules can be used by
+ * the console game and by simulations.
+ */
+RoundOutcome Blackjack::determineOutcome(int playerSum, int playerCardCount, int dealerSum, int dealerCardCount) {
+    // Determining who won by going over all the possible situations:
+    if (playerSum > 21) { // Player busted, dealer wins
+        return RoundOutcome::DEALER_WIN;
+    } else if (dealerSum > 21) { // Dealer busted, player wins
+        return RoundOutcome::PLAYER_WIN;
+    } else if (playerSum > dealerSum && playerSum < 21) { // Player has higher sum w/o busting, but no blackjack
+        return RoundOutcome::PLAYER_WIN;
+    } else if (dealerSum > playerSum && dealerSum < 21) { // Dealer has higher sum w/o busting, but no blackjack
+        return RoundOutcome::DEALER_WIN;
+    } else if (playerSum == 21 && dealerSum != 21) { // Player wins with 21
+        if (playerCardCount == 2) { // Player has BLACKJACK!
+            return RoundOutcome::PLAYER_BLACKJACK;
+        }
+        return RoundOutcome::PLAYER_WIN;
+    } else if (dealerSum == 21 && playerSum != 21) { // Dealer wins with 21
+        if (dealerCardCount == 2) { // Dealer has BLACKJACK!
+            return RoundOutcome::DEALER_BLACKJACK;
         }
+        return RoundOutcome::DEALER_WIN;
+    } else if (dealerSum == 21 && playerSum == 21) {
+        if (playerCardCount == 2 && dealerCardCount != 2) { // Player has won with BLACKJACK!
+            return RoundOutcome::PLAYER_BLACKJACK;
+        } else if (playerCardCount != 2 && dealerCardCount == 2) { // Dealer has won with BLACKJACK!
+            return RoundOutcome::DEALER_BLACKJACK;
+        } else { // A tie, no one wins
+            return RoundOutcome::PUSH;
+        }
+    } else if (dealerSum == playerSum) { // A tie, no one wins
+        return RoundOutcome::PUSH;
+    } else {
+        cerr << "Not defined who won, check code" << endl;
+        return RoundOutcome::PUSH;
     }
 }
 
@@ -191,13 +264,13 @@ void Blackjack::concludeRound() {
  */
 void Blackjack::printOpeningTitle() {
     // printing the opening title "Casino++ Blackjack" using https://patorjk.com/software/taag/ to create ASCII Art
-    cout << "  ____          _                           ____  _            _     _            _    " << endl;
-    cout << " / ___|__ _ ___(_)_ __   ___    _     _    | __ )| | __ _  ___| | __(_) __ _  ___| | __" << endl;
-    cout << "| |   / _` / __| | '_ \\ / _ \\ _| |_ _| |_  |  _ \\| |/ _` |/ __| |/ /| |/ _` |/ __| |/ /" << endl;
-    cout << "| |__| (_| \\__ \\ | | | | (_) |_   _|_   _| | |_) | | (_| | (__|   < | | (_| | (__|   < " << endl;
-    cout << " \\____\\__,_|___/_|_| |_|\\___/  |_|   |_|   |____/|_|\\__,_|\\___|_|\\_\\/ |\\__,_|\\___|_|\\_\\"
-         << endl;
-    cout << "                                                                  |__/                 " << endl;
+    *output << "  ____          _                           ____  _            _     _            _    " << endl;
+    *output << " / ___|__ _ ___(_)_ __   ___    _     _    | __ )| | __ _  ___| | __(_) __ _  ___| | __" << endl;
+    *output << "| |   / _` / __| | '_ \\ / _ \\ _| |_ _| |_  |  _ \\| |/ _` |/ __| |/ /| |/ _` |/ __| |/ /" << endl;
+    *output << "| |__| (_| \\__ \\ | | | | (_) |_   _|_   _| | |_) | | (_| | (__|   < | | (_| | (__|   < " << endl;
+    *output << " \\____\\__,_|___/_|_| |_|\\___/  |_|   |_|   |____/|_|\\__,_|\\___|_|\\_\\/ |\\__,_|\\___|_|\\_\\"
+            << endl;
+    *output << "                                                                  |__/                 " << endl;
 }
 
 /**
@@ -205,31 +278,32 @@ void Blackjack::printOpeningTitle() {
  */
 void Blackjack::printYouWon() {
     // printing "You won!" using https://patorjk.com/software/taag/ to create ASCII Art
-    cout << " __   __                                       _ " << endl;
-    cout << " \\ \\ / /___   _   _    __      __ ___   _ __  | |" << endl;
-    cout << "  \\ V // _ \\ | | | |   \\ \\ /\\ / // _ \\ | '_ \\ | |" << endl;
-    cout << "   | || (_) || |_| |    \\ V  V /| (_) || | | ||_|" << endl;
-    cout << "   |_| \\___/  \\__,_|     \\_/\\_/  \\___/ |_| |_|(_)" << endl;
-    cout << endl;
+    *output << " __   __                                       _ " << endl;
+    *output << " \\ \\ / /___   _   _    __      __ ___   _ __  | |" << endl;
+    *output << "  \\ V // _ \\ | | | |   \\ \\ /\\ / // _ \\ | '_ \\ | |" << endl;
+    *output << "   | || (_) || |_| |    \\ V  V /| (_) || | | ||_|" << endl;
+    *output << "   |_| \\___/  \\__,_|     \\_/\\_/  \\___/ |_| |_|(_)" << endl;
+    *output << endl;
 }
 
 /**
  * This function prints ASCII art "You lost..." made with: https://patorjk.com/software/taag/
  */
 void Blackjack::printYouLost() {
-    cout << " __   __                _              _            " << endl;
-    cout << " \\ \\ / /___   _   _    | |  ___   ___ | |_          " << endl;
-    cout << "  \\ V // _ \\ | | | |   | | / _ \\ / __|| __|         " << endl;
-    cout << "   | || (_) || |_| |   | || (_) |\\__ \\| |_  _  _  _ " << endl;
-    cout << "   |_| \\___/  \\__,_|   |_| \\___/ |___/ \\__|(_)(_)(_)" << endl;
-    cout << endl;
+    *output << " __   __                _              _            " << endl;
+    *output << " \\ \\ / /___   _   _    | |  ___   ___ | |_          " << endl;
+    *output << "  \\ V // _ \\ | | | |   | | / _ \\ / __|| __|         " << endl;
+    *output << "   | || (_) || |_| |   | || (_) |\\__ \\| |_  _  _  _ " << endl;
+    *output << "   |_| \\___/  \\__,_|   |_| \\___/ |___/ \\__|(_)(_)(_)" << endl;
+    *output << endl;
 }
 
 /**
- * This function prints a horizontal border with a line of '=' characters to visually separate console information
+ * This function prints a horizontal border with a line of '=' characters to visually separate console information,
+ * to the input "stream".
  */
-void Blackjack::printConsoleSeparationLine() {
-    cout << "===================================================================" << endl << endl;
+void Blackjack::printConsoleSeparationLine(std::ostream &stream) {
+    stream << "===================================================================" << endl << endl;
 }
 
 /**
@@ -237,55 +311,76 @@ void Blackjack::printConsoleSeparationLine() {
  * expects a single character as input. When a valid character is entered, the function returns the player's decision
  * as a string "hit" or "stand".
  */
-string Blackjack::requestHitOrStand() {
-    cout << "Enter 'h' to hit or 's' to stand:" << endl;
+SubTask<string> Blackjack::requestHitOrStand() {
+    *output << "Enter 'h' to hit or 's' to stand:" << endl;
 
     string userInput;
-    while (true) {
-        cin >> userInput;
+    while (co_await readUserInput(userInput, TableQuestion::HIT_OR_STAND)) {
+        // Only checking the answer is timed, as the thread plays other tables while a remote player thinks
+        INSTRUMENT_PHASE(PLAYER_DECISION);
         if (userInput == "h" || userInput == "H") {
-            return "hit";
+            co_return "hit";
         } else if (userInput == "s" || userInput == "S") {
-            return "stand";
+            co_return "stand";
         } else {
-            cout << "Invalid input, please try again. Enter 'h' to hit or 's' to stand:" << endl;
+            *output << "Invalid input, please try again. Enter 'h' to hit or 's' to stand:" << endl;
         }
     }
+
+    // The input has ended, so the player cannot hit anymore and the round is finished by standing
+    co_return "stand";
 }
 
 /**
- * This function prints an overview of the hands of the dealer and the player. It calls the printHorizontal()
- * function to do the actual Hand printing. First the dealer's hand is printed (along with the current cards sum) and
- * underneath the player's hand is printed (also along with the current cards sum).
+ * This function prints an overview of the hands of the dealer and the player. It calls the renderHorizontal()
+ * function to put the cards of a Hand together. First the dealer's hand is printed (along with the current cards sum)
+ * and underneath the player's hand is printed (also along with the current cards sum). The overview is redrawn in
+ * place by the TerminalScreen, unless the game is set to scroll (see setRedrawInPlace()).
  */
 void Blackjack::printDealerAndPlayerHands() {
-    printConsoleSeparationLine(); // ===========
+    // In a scripted session nobody is watching the table, so the hands are not redrawn
+    if (!redrawHands) {
+        return;
+    }
+    INSTRUMENT_PHASE(RENDER);
+
+    std::ostringstream table;
+    printConsoleSeparationLine(table); // ===========
 
-    printBalanceAndBet();
-    cout << endl;
+    printBalanceAndBet(table);
+    table << endl;
 
-    cout << "Dealer " << "(" << sumOptimal(dealerHand) << "):" << endl;
-    dealerHand.printHorizontal();
+    table << "Dealer " << "(" << sumOptimal(dealerHand) << "):" << endl;
+    table << dealerHand.renderHorizontal();
 
-    cout << "You " << "(" << sumOptimal(playerHand) << "):" << endl;
-    playerHand.printHorizontal();
+    table << "You " << "(" << sumOptimal(playerHand) << "):" << endl;
+    table << playerHand.renderHorizontal();
 
-    cout << endl;
+    table << endl;
+
+    string text = redrawInPlace ? screen.present(table.str()) : table.str();
+    *output << text << std::flush;
+    Metrics::count(Metrics::BYTES_TO_SCREEN, text.size());
 }
 
 /**
  * This function calculates and returns the optimal sum of a hand of cards according to standard Blackjack rules.
  * It iterates through each card in the hand, adding their game values to the total sum. Additionally, it keeps track
  * of the number of Aces in the hand as they can have a flexible value of 1 or 11. In case the sum exceeds 21 (busting),
- * the function adjusts the value of Aces from 11 to 1 to minimize the total sum and avoid busting.
+ * the function adjusts the value of Aces from 11 to 1 to minimize the total sum and avoid busting. Cards lying face down
+ * (the dealer's hole card) are not counted, as the player does not know them yet.
  */
 unsigned int Blackjack::sumOptimal(Hand &handToSum) {
+    INSTRUMENT_COUNT(SUM_OPTIMAL_CALLS, 1);
     int sum = 0;
     int numberOfAcesInHand = 0;
 
     // Using an index-based for loop
     for (int i = 0; i < handToSum.getSize(); ++i) {
         Card cardToSum = handToSum.getCardAtIndex(i);
+        if (cardToSum.isFaceDown()) {
+            continue;
+        }
 
         sum += cardToSum.getGameValue();
 
@@ -296,116 +391,378 @@ unsigned int Blackjack::sumOptimal(Hand &handToSum) {
         }
     }
 
+    return sumOptimal(sum, numberOfAcesInHand);
+}
+
+/**
+ * This function calculates and returns the optimal sum of a hand from the sum of the game values of its cards
+ * ("sumOfGameValues", with every Ace counted as 11) and the amount of Aces in the hand ("numberOfAcesInHand"). In case
+ * the sum exceeds 21 (busting), the value of Aces is adjusted from 11 to 1 to minimize the total sum and avoid busting.
+ */
+unsigned int Blackjack::sumOptimal(int sumOfGameValues, int numberOfAcesInHand) {
     // While the sum is more than 21, reduce the sum by 10 for every ace in the hand to avoid busting if possible
+    while (sumOfGameValues > 21 && numberOfAcesInHand > 0) {
+        sumOfGameValues -= 10;
+        numberOfAcesInHand--;
+    }
+
+    return sumOfGameValues;
+}
+
+/**
+ * This function returns true if the optimal sum of the input "handToCheck" (see sumOptimal()) counts an Ace as 11, so
+ * the next card cannot bust the hand.
+ */
+bool Blackjack::isSoft(Hand &handToCheck) {
+    int sum = 0;
+    int numberOfAcesInHand = 0;
+    for (int i = 0; i < handToCheck.getSize(); ++i) {
+        Card cardToCheck = handToCheck.getCardAtIndex(i);
+        if (!cardToCheck.isFaceDown()) {
+            sum += cardToCheck.getGameValue();
+            numberOfAcesInHand += cardToCheck.isAce();
+        }
+    }
+    // Every Ace that does not have to be counted as 1 is counted as 11
     while (sum > 21 && numberOfAcesInHand > 0) {
         sum -= 10;
         numberOfAcesInHand--;
     }
-
-    return sum;
+    return numberOfAcesInHand > 0;
 }
 
 /**
  * This function request the player to place a bet for the coming round. It shows the balance, so the player knows how
  * much they can spend. Then the player is asked to input an integer for how much they want to bet. The input is first
- * checked for being numerical (not a string with letters or symbols), whether it is at least 1, and whether the player
- * has enough money to place the bet. When all checks are passed, the bet is returned as an integer.
+ * checked for being a whole number of at most 9 digits (see Money::parseWholeAmount()), whether it is at least 1, and
+ * whether the player has enough money to place the bet. When all checks are passed, the bet is returned as a whole
+ * amount of Money.
  */
-unsigned int Blackjack::requestBetAmount() {
-    cout << endl << "YOUR BALANCE: " << playerMoney << endl;
+SubTask<Money> Blackjack::requestBetAmount() {
+    *output << endl << "YOUR BALANCE: " << playerMoney << endl;
 
-    unsigned int bet;
+    Money bet;
 
     while (true) {
         string betStr;
-        cout << "Please place your bet (an integer of at least 1):" << endl;
-        cin >> betStr;
-
-        // Checking if the string is a number. Principle adapted from:
-        // https://www.tutorialspoint.com/cplusplus-program-to-check-if-input-is-an-integer-or-a-string
-        bool inputIsNumerical = true;
-        for (char i : betStr) { // Checking one by one all the characters that the user entered
-            if (!isdigit(i)) {
-                inputIsNumerical = false;
-                cout << "Your input is not a whole number, or contains letters. Please try again." << endl;
-                break;
-            }
+        *output << "Please place your bet (an integer of at least 1):" << endl;
+        // If the input has ended, the game has been quit and a bet of 0 is returned
+        if (!co_await readUserInput(betStr, TableQuestion::BET)) {
+            break;
         }
-        if (inputIsNumerical) {
-            bet = stoi(betStr); // Converting the bet string to an integer
-
-            if (bet < 1) {
-                cout << "Sorry, this bet is below the minimum bet of 1. Please try again." << endl;
-            } else if (bet > playerMoney) {
-                cout << "Sorry, you do not have enough money to place this bet. Please try again." << endl;
-            } else {
-                break;
-            }
+
+        // Checking if the string is a whole number that is not too long, and converting it to a bet
+        if (!Money::parseWholeAmount(betStr, bet)) {
+            *output << "Your input is not a whole number of at most " << Money::MAXIMUM_WHOLE_AMOUNT_DIGITS
+                    << " digits, or contains letters. Please try again." << endl;
+        } else if (bet < MINIMUM_BET) {
+            *output << "Sorry, this bet is below the minimum bet of 1. Please try again." << endl;
+        } else if (bet > playerMoney) {
+            *output << "Sorry, you do not have enough money to place this bet. Please try again." << endl;
+        } else {
+            break;
         }
     }
 
-    return bet;
+    co_return bet;
 }
 
 /**
  * This function handles paying the player the right amount of money based on the conclusion of the round (see
- * concludeRound()). For a normal win, the factor is 1, so the player gets back twice their bet. In case of
- * winning with a Blackjack, the payout rate is 2:3, so the player gets back their bet times factor 1.5 + their bet.
+ * concludeRound()). For a normal win, the ratio is 1:1, so the player gets back twice their bet. In case of
+ * winning with a Blackjack, the payout ratio is 3:2 (or 6:5, see setBlackjackPayout()), so the player gets back
+ * their bet times 1.5 + their bet. For a tie, the ratio is 0:1, so the player only gets back their bet. Payouts
+ * that do not come out at a whole cent are rounded down (see Money::payout()).
+ */
+void Blackjack::payout(Money bet, PayoutRatio ratio) {
+    playerMoney += bet + bet.payout(ratio);
+}
+
+/**
+ * This function prints an overview of the player's remaining balance and the bet they placed to the input "stream".
+ */
+void Blackjack::printBalanceAndBet(std::ostream &stream) {
+    stream << "YOUR BALANCE: " << playerMoney << " | YOUR BET: " << thisRoundBet << endl;
+}
+
+/**
+ * This function deals one card to the input "handToDealTo", face down if "faceDown" is true. The card is drawn from the
+ * card source of the game (see useCardSource()), or generated randomly by the Card class if the game has no card source.
+ */
+void Blackjack::dealCard(Hand &handToDealTo, bool faceDown) {
+    INSTRUMENT_PHASE(DEAL);
+    INSTRUMENT_COUNT(CARDS_DEALT, 1);
+    if (cardSource != nullptr) {
+        handToDealTo.addRandomCards(1, *cardSource);
+    } else {
+        handToDealTo.addRandomCards(1);
+    }
+    // A face-down card is published as the back of a card, so the spectators do not see it either
+    handToDealTo.setCardFaceDown(handToDealTo.getSize() - 1, faceDown);
+    if (broadcast != nullptr) {
+        uint8_t seat = &handToDealTo == &dealerHand ? TableEvent::DEALER_SEAT : TableEvent::PLAYER_SEAT;
+        Card dealtCard = handToDealTo.getCardAtIndex(handToDealTo.getSize() - 1);
+        publishEvent(TableEvent::CARD_DEALT, seat, (uint8_t) dealtCard.getGlyphIndex());
+    }
+}
+
+/**
+ * This function returns true if the dealer's open card and hole card are a blackjack. Only the game values of the two
+ * cards are added up, so peeking does not show the hole card to anyone.
+ */
+bool Blackjack::dealerPeeksBlackjack() {
+    int openCardValue = dealerHand.getCardAtIndex(0).getGameValue();
+    // The dealer only peeks when the open card can make a blackjack, which the player sees happen
+    if (openCardValue < 10) {
+        return false;
+    }
+    *output << "The dealer peeks at the hole card for blackjack..." << endl;
+    return isBlackjack(openCardValue + dealerHand.getCardAtIndex(1).getGameValue(), 2);
+}
+
+/**
+ * This function turns the dealer's hole card face up, if the dealer has one lying face down, and publishes it.
  */
-void Blackjack::payout(double bet, double factor) {
-    playerMoney = playerMoney + thisRoundBet * factor + thisRoundBet;
+void Blackjack::revealHoleCard() {
+    if (dealerHand.getSize() < 2 || !dealerHand.getCardAtIndex(1).isFaceDown()) {
+        return;
+    }
+    dealerHand.setCardFaceDown(1, false);
+    publishEvent(TableEvent::HOLE_CARD_REVEALED, TableEvent::DEALER_SEAT,
+                 (uint8_t) dealerHand.getCardAtIndex(1).getGlyphIndex());
 }
 
 /**
- * This function prints an overview of the player's remaining balance and the bet they placed.
+ * This function deals the dealer's second card face up when the player has reached 21 at a table without a hole card
+ * (see HoleCardRule). A dealer's blackjack still beats a 21 of more cards, and ties with a player's blackjack.
  */
-void Blackjack::printBalanceAndBet() {
-    cout << "YOUR BALANCE: " << playerMoney << " | YOUR BET: " << thisRoundBet << endl;
+SubTask<> Blackjack::dealDealerSecondCard() {
+    if (holeCardRule != HoleCardRule::NO_HOLE_CARD || dealerHand.getSize() != 1) {
+        co_return;
+    }
+    dealCard(dealerHand);
+    printDealerAndPlayerHands();
+    co_await waitSeconds(SECONDS_BETWEEN_DRAWS);
+}
+
+/**
+ * This function publishes an event of the input "type" for the current round to the spectators, with the input
+ * "seat", "value" and "amount" (see TableEvent). Without a broadcast, nothing happens.
+ */
+void Blackjack::publishEvent(TableEvent::Type type, uint8_t seat, uint8_t value, Money amount) {
+    if (broadcast == nullptr) {
+        return;
+    }
+    TableEvent event;
+    event.type = type;
+    event.seat = seat;
+    event.value = value;
+    event.round = roundsPlayed;
+    event.amount = amount;
+    broadcast->publish(event);
 }
 
 /**
- * This function uses thread and chrono to sleep the program for as many seconds as specified by the parameter
- * "secondsToWait". This can be used as a delay to add timed pauses within the program where necessary. This method
- * of pausing a program was learned from https://cplusplus.com/reference/thread/this_thread/sleep_for/.
+ * This function pauses the program for as many seconds as specified by the parameter "secondsToWait". This can be
+ * used as a delay to add timed pauses within the program where necessary. The actual pausing is delegated to the
+ * pacer of the game, so the pause may also be skipped entirely. With a remote player, the round waits for a timer of
+ * the player's scheduler instead, without blocking the thread.
  */
-void Blackjack::waitSeconds(int secondsToWait) {
-    // Delaying the program for a "secondsToWait" amount of seconds. method was learned from:
-    // https://cplusplus.com/reference/thread/this_thread/sleep_for/
-    std::this_thread::sleep_for(std::chrono::seconds(secondsToWait));
+SubTask<> Blackjack::waitSeconds(int secondsToWait) {
+    if (remotePlayer != nullptr) {
+        co_await remotePlayer->scheduler.sleep(secondsToWait);
+        co_return;
+    }
+    pacer->pause(secondsToWait);
 }
 
 Hand playerHand = Hand();
 Hand dealerHand = Hand();
 
+/**
+ * Default constructor: defines a game of Blackjack that sleeps the program in between card draws.
+ */
+Blackjack::Blackjack() {}
+
+/**
+ * Constructor for a game of Blackjack that uses the input Pacer "pacer_" for the pauses in between card draws.
+ * For example, a ZeroDelayPacer runs the game without any pauses. Note that the pacer is not copied, so it must
+ * outlive the Blackjack object.
+ */
+Blackjack::Blackjack(Pacer &pacer_) : pacer(&pacer_) {}
+
+/**
+ * This function reads the next word the user entered into "userInput". If the input has ended (for example because a
+ * script has been played completely), the game is quit and false is returned. A remote player is sent the question of
+ * the input "questionType" instead, and the round waits for their answer.
+ */
+SubTask<bool> Blackjack::readUserInput(string &userInput, TableQuestion::Type questionType) {
+    if (remotePlayer != nullptr) {
+        int dealerCardValue = dealerHand.getSize() > 0 ? dealerHand.getCardAtIndex(0).getGameValue() : 0;
+        remotePlayer->questions.send(TableQuestion{questionType, playerMoney, (int) sumOptimal(playerHand),
+                                                   isSoft(playerHand), dealerCardValue});
+        CoroutineScheduler::Clock::time_point questionTime = remotePlayer->scheduler.now();
+        userInput = co_await remotePlayer->answers.receive();
+        Metrics::count(Metrics::ACTIONS, 1);
+        Metrics::observe(Metrics::ACTION_LATENCY,
+                         std::chrono::duration<double>(remotePlayer->scheduler.now() - questionTime).count());
+        co_return true;
+    }
+
+    if (*input >> userInput) {
+        co_return true;
+    }
+    quitGame();
+    co_return false;
+}
+
 /**
  * This function launches the game and takes the to sort of a 'main menu'. It welcomes the user and asks them
  * whether they want to start playing a round of Blackjack or want to quit the program. Based on the user's entered
- * response in the form of a letter, this function calls the playRound() or quitGame() functions.
+ * response in the form of a letter, this function calls the playRound() or quitGame() functions. The game itself is
+ * played by playGame(), which this function runs to its end on the calling thread: the answers are read from the input
+ * and the pauses are made by the pacer, so the game never has to wait for a scheduler.
  */
 void Blackjack::launchGame() {
-    cout << endl << "Welcome to:" << endl;
+    SubTask<> game = playGame();
+    game.runToEnd();
+}
+
+/**
+ * This function plays the game: it welcomes the user and asks them whether they want to start playing rounds of
+ * Blackjack or want to quit. The rounds are played one after the other until the player quits or runs out of money. It
+ * is a coroutine, which launchGame() runs to its end on the calling thread and an AsyncTable on its scheduler.
+ */
+SubTask<> Blackjack::playGame() {
+    Metrics::changeGauge(Metrics::OPEN_TABLES, 1);
+    *output << endl << "Welcome to:" << endl;
     printOpeningTitle(); // Printing the title of the game in large ASCII art graphics
-    cout << "Enter 's' to start or 'q' to quit the game: " << endl;
+    *output << "Enter 's' to start or 'q' to quit the game: " << endl;
 
     string userInput;
-    while (true) {
-        cin >> userInput;
+    while (co_await readUserInput(userInput, TableQuestion::START_OR_QUIT)) {
         if (userInput == "s" || userInput == "S") {
-            playRound();
+            // Rounds are played one after the other until the player quits or runs out of money
+            while (gameIsRunning) {
+                co_await playRound();
+            }
             break;
         } else if (userInput == "q" || userInput == "Q") {
             quitGame();
             break;
         } else {
-            cout << "Invalid input, please try again. Enter 's' to start or 'q' to quit the game" << endl;
+            *output << "Invalid input, please try again. Enter 's' to start or 'q' to quit the game" << endl;
         }
     }
+    Metrics::changeGauge(Metrics::OPEN_TABLES, -1);
 }
 
 /**
- * This function exits the program with code 0 (successful exit)
+ * This function ends the game. It says goodbye to the player and stops the rounds, after which launchGame() returns.
  */
 void Blackjack::quitGame() {
-    cout << "Thank you for playing Casino++ Blackjack. Goodbye!" << endl;
-    exit(0); // Exit code 0 for successful exit
+    *output << "Thank you for playing Casino++ Blackjack. Goodbye!" << endl;
+    gameIsRunning = false;
+}
+
+/**
+ * This function sets up the game for a scripted session. The user input is read from the input stream "commands"
+ * instead of the keyboard, nothing is printed to the console and the game is played without pauses. The stream is not
+ * copied, so it must outlive the scripted session.
+ */
+void Blackjack::useScriptedSession(std::istream &commands) {
+    input = &commands;
+    output = &silentOutput;
+    pacer = &zeroDelayPacer;
+    redrawHands = false;
+}
+
+/**
+ * This function makes the game deal its cards from the input "cardSource_", for example a Shoe, instead of generating
+ * random cards. The card source is not copied, so it must outlive the game.
+ */
+void Blackjack::useCardSource(CardSource &cardSource_) {
+    cardSource = &cardSource_;
+}
+
+/**
+ * This function connects the game to the account "accountName_" in the input "accountStore_". The balance of the
+ * account is used as the player's balance (a new account starts with the usual starting money), and every bet and
+ * payout is stored in the account, so the balance survives quitting the game. The store is not copied, so it must
+ * outlive the game.
+ */
+void Blackjack::useAccount(AccountStore &accountStore_, const string &accountName_) {
+    accountStore = &accountStore_;
+    accountName = accountName_;
+
+    // A new account, or one that cannot place the minimum bet anymore, starts with the starting money
+    if (!accountStore->hasAccount(accountName) || accountStore->getAccount(accountName).balance < MINIMUM_BET) {
+        accountStore->setBalance(accountName, MONEY_AT_START);
+    }
+    playerMoney = accountStore->getAccount(accountName).balance;
+}
+
+/**
+ * This function publishes every step of a round as a typed event to the input "broadcast_", for spectators and
+ * other consumers (see TableBroadcast.h). The broadcast is not copied, so it must outlive the game.
+ */
+void Blackjack::useBroadcast(TableBroadcast &broadcast_) {
+    broadcast = &broadcast_;
+}
+
+/**
+ * This function lets the game be played by the input "remotePlayer_" instead of a user at the console: every question
+ * is sent to the player, and the round waits for the answer and for the pauses on the player's scheduler without
+ * blocking the thread, so the game must be played with playGame() on that scheduler. Nothing is printed. The
+ * connection is not copied, so it must outlive the game.
+ */
+void Blackjack::useRemotePlayer(RemotePlayer &remotePlayer_) {
+    remotePlayer = &remotePlayer_;
+    output = &silentOutput;
+    redrawHands = false;
+}
+
+/**
+ * This function sets whether the table is redrawn in place at the top of the terminal ("inPlace" is true, the
+ * default) or printed below the previous one, scrolling the terminal.
+ */
+void Blackjack::setRedrawInPlace(bool inPlace) {
+    redrawInPlace = inPlace;
+}
+
+/**
+ * This function sets the payout "ratio" of a blackjack, which is 3:2 by default. Many casinos pay only 6:5.
+ */
+void Blackjack::setBlackjackPayout(PayoutRatio ratio) {
+    blackjackPayout = ratio;
+}
+
+/**
+ * This function sets whether the dealer gets a hole card and peeks for blackjack ("rule" is PEEK, the default) or only
+ * gets a second card after the player stands or reaches 21 (NO_HOLE_CARD), see HoleCardRule.
+ */
+void Blackjack::setHoleCardRule(HoleCardRule rule) {
+    holeCardRule = rule;
+}
+
+/**
+ * This function sets the balance of the player to the input "amount", for example to start with more than the usual
+ * starting money.
+ */
+void Blackjack::setPlayerMoney(Money amount) {
+    playerMoney = amount;
+}
+
+/**
+ * This function returns the current balance of the player.
+ */
+Money Blackjack::getPlayerMoney() const {
+    return playerMoney;
+}
+
+/**
+ * This function returns the amount of rounds that have been played in this game.
+ */
+int Blackjack::getRoundsPlayed() const {
+    return roundsPlayed;
 }
@@ -13,36 +13,136 @@
 #ifndef PIE_CPP_BLACKJACK_BLACKJACK_H
 #define PIE_CPP_BLACKJACK_BLACKJACK_H
 
+#include <iostream>
+#include <istream>
+#include <ostream>
+
+#include "AccountStore.h"
+#include "CoroutineScheduler.h"
 #include "Hand.h"
+#include "Money.h"
+#include "Pacer.h"
+#include "TableBroadcast.h"
+#include "TerminalScreen.h"
+
+// The possible outcomes of a round of Blackjack, as seen from the player
+enum class RoundOutcome {
+    PLAYER_BLACKJACK,
+    PLAYER_WIN,
+    PUSH,
+    DEALER_WIN,
+    DEALER_BLACKJACK
+};
+
+// How the dealer gets their second card. With a hole card (American rules), the dealer gets it face down right after
+// the player's second card, and peeks at it when the open card is an Ace or a 10: a dealer's blackjack ends the round
+// before the player's turn. Without a hole card (European rules, ENHC), the dealer only gets it after the player stands
+// or reaches 21, so a dealer's blackjack still beats a player's 21 of more cards
+enum class HoleCardRule {
+    PEEK,
+    NO_HOLE_CARD
+};
+
+// What the game asks its player before it waits for the answer
+struct TableQuestion {
+    enum Type {
+        START_OR_QUIT, // the answer is "s" or "q"
+        BET,           // the answer is the bet
+        HIT_OR_STAND,  // the answer is "h" or "s"
+        TABLE_CLOSED   // no answer, the player leaves the table
+    };
+
+    Type type = BET;
+    Money balance;           // the balance of the player
+    int playerSum = 0;       // the optimal sum of the player's hand, for HIT_OR_STAND
+    bool isSoft = false;     // whether that sum counts an Ace as 11
+    int dealerCardValue = 0; // the game value of the dealer's open card
+};
+
+// The connection of a game to a player who answers through channels on a CoroutineScheduler instead of at the
+// console, like a player at the other end of a network connection. The game sends its questions, and waits for the
+// answers and for the pauses between the cards without blocking the thread
+struct RemotePlayer {
+    CoroutineScheduler &scheduler;
+    Channel<TableQuestion> questions; // from the table to the player
+    Channel<string> answers;          // from the player to the table
+
+    /**
+     * Constructor for a connection on the input "scheduler_", which is not copied, so it must outlive the connection.
+     */
+    explicit RemotePlayer(CoroutineScheduler &scheduler_)
+            : scheduler(scheduler_), questions(scheduler_), answers(scheduler_) {}
+};
 
 class Blackjack {
 private:
     const int SECONDS_BETWEEN_DRAWS = 2;
-    const double MONEY_AT_START = 10;
+    const Money MONEY_AT_START = Money::fromWholeAmount(10);
+    const Money MINIMUM_BET = Money::fromWholeAmount(1);
 
-    double playerMoney = MONEY_AT_START;
-    double thisRoundBet = 0;
+    Money playerMoney = MONEY_AT_START;
+    Money thisRoundBet;
+    PayoutRatio blackjackPayout = {3, 2};
+    HoleCardRule holeCardRule = HoleCardRule::PEEK;
+
+    // The pacer decides how the pauses between draws are made (see Pacer.h). By default, the thread is put to sleep.
+    SleepingPacer defaultPacer;
+    ZeroDelayPacer zeroDelayPacer;
+    Pacer *pacer = &defaultPacer;
+
+    // The user input is read from "input" and all text of the game is written to "output". By default, these are the
+    // keyboard and the console, but a scripted session reads from a script and writes to the silent output stream,
+    // which discards everything (an ostream without a buffer does not write anything).
+    std::istream *input = &std::cin;
+    std::ostream *output = &std::cout;
+    std::ostream silentOutput{nullptr};
+    bool redrawHands = true;
+
+    // The table is redrawn in place at the top of the terminal, writing only what has changed (see TerminalScreen.h)
+    TerminalScreen screen;
+    bool redrawInPlace = true;
+
+    // The cards are drawn from the card source if there is one, or generated randomly by the Card class otherwise
+    CardSource *cardSource = nullptr;
+
+    // If the player has an account, every bet and payout is stored in the account store (see useAccount())
+    AccountStore *accountStore = nullptr;
+    string accountName;
+
+    // If the events of the table are consumed, every step of a round is published to the broadcast (see useBroadcast())
+    TableBroadcast *broadcast = nullptr;
+
+    // If the player is a remote player, the game asks them and waits on their scheduler (see useRemotePlayer())
+    RemotePlayer *remotePlayer = nullptr;
+
+    bool gameIsRunning = true;
+    int roundsPlayed = 0;
 
     /**
-     * This function manages a full round of Blackjack. To start the game, it draws the dealer a card and the player two
-     * cards. In between draws, the cards are reprinted to the console and the program is paused to mimic the real world
-     * dynamics of a dealer handing out cards. This gives the user time to process the information. Using a while-loop
-     * and based on the user's entered response (gathered from calling requestHitOrStand()), the player is drawn another
-     * card (hit) or they are not given cards anymore (stand). When the user stands, the dealer is dealt cards as long
-     * as their sum of cards is below 17. After this process concludeRound() is called to decide the winner of the round.
+     * This function manages a full round of Blackjack. To start the game, it deals the cards like at a real table: a
+     * card for the player, the dealer's open card, the player's second card and (with a hole card, see HoleCardRule)
+     * the dealer's hole card face down. If the dealer peeks and has blackjack, the round is over. In between draws, the
+     * cards are reprinted to the console and the program is paused to mimic the real world dynamics of a dealer handing
+     * out cards. This gives the user time to process the information. Using a while-loop and based on the user's entered
+     * response (gathered from calling requestHitOrStand()), the player is drawn another card (hit) or they are not given
+     * cards anymore (stand). When the user stands, the dealer turns over the hole card and is dealt cards as long as
+     * their sum of cards is below 17. After this process concludeRound() is called to decide the winner of the round.
+     * The round is a coroutine: it co_awaits the answers of the player and the pauses (see readUserInput() and
+     * waitSeconds()), so with a remote player the thread can play other tables in the meantime.
      */
-    void playRound();
+    SubTask<> playRound();
 
     /**
-     * This function concludes a round of Blackjack by determining the outcome of the round based on the final card sums.
-     * It evaluates all possible scenarios such as busting (sum > 21), winning with a higher sum, having a tie and it
-     * checks the presence of a blackjack (an Ace with a 10-value card) in the initial two cards.
+     * This function concludes a round of Blackjack by determining the outcome of the round based on the final card sums
+     * (see determineOutcome()). It evaluates all possible scenarios such as busting (sum > 21), winning with a higher
+     * sum, having a tie and it checks the presence of a blackjack (an Ace with a 10-value card) in the initial two
+     * cards.
      *
-     * Using boolean states for who won, the function prints the result of the round using the ASCII by calling printYouWon()
-     * and printYouLost(),as well as messages for winning with a blackjack or achieving a tie. Finally, based on user
-     * input, a new round is started or the program is quit.
+     * Based on the outcome, the function prints the result of the round using the ASCII by calling printYouWon() and
+     * printYouLost(), as well as messages for winning with a blackjack or achieving a tie, and pays out the player.
+     * Finally, based on user input, the game continues with a new round or is quit.
      */
-    void concludeRound();
+    SubTask<> concludeRound();
 
     /**
      * This function prints ASCII art for the opening title of the game made with: https://patorjk.com/software/taag/
@@ -60,74 +160,241 @@ private:
     void printYouLost();
 
     /**
-     * This function prints a horizontal border with a line of '=' characters to visually separate console information
+     * This function prints a horizontal border with a line of '=' characters to visually separate console information,
+     * to the input "stream".
      */
-    void printConsoleSeparationLine();
+    void printConsoleSeparationLine(std::ostream &stream);
 
     /**
      * This function asks the player whether they want to hit (receive another card) or stand (stop receiving cards), and
      * expects a single character as input. When a valid character is entered, the function returns the player's decision
      * as a string "hit" or "stand".
      */
-    string requestHitOrStand();
+    SubTask<string> requestHitOrStand();
 
     /**
-     * This function prints an overview of the hands of the dealer and the player. It calls the printHorizontal()
-     * function to do the actual Hand printing. First the dealer's hand is printed (along with the current cards sum) and
-     * underneath the player's hand is printed (also along with the current cards sum).
+     * This function prints an overview of the hands of the dealer and the player. It calls the renderHorizontal()
+     * function to put the cards of a Hand together. First the dealer's hand is printed (along with the current cards
+     * sum) and underneath the player's hand is printed (also along with the current cards sum). The overview is
+     * redrawn in place by the TerminalScreen, unless the game is set to scroll (see setRedrawInPlace()).
      */
     void printDealerAndPlayerHands();
 
+
     /**
-     * This function calculates and returns the optimal sum of a hand of cards according to standard Blackjack rules.
-     * It iterates through each card in the hand, adding their game values to the total sum. Additionally, it keeps track
-     * of the number of Aces in the hand as they can have a flexible value of 1 or 11. In case the sum exceeds 21 (busting),
-     * the function adjusts the value of Aces from 11 to 1 to minimize the total sum and avoid busting.
+     * This function request the player to place a bet for the coming round. It shows the balance, so the player knows
+     * how much they can spend. Then the player is asked to input an integer for how much they want to bet. The input is
+     * first checked for being a whole number of at most 9 digits (see Money::parseWholeAmount()), whether it is at
+     * least 1, and whether the player has enough money to place the bet. When all checks are passed, the bet is
+     * returned as a whole amount of Money.
      */
-    unsigned int sumOptimal(Hand &handToSum);
+    SubTask<Money> requestBetAmount();
 
     /**
-     * This function request the player to place a bet for the coming round. It shows the balance, so the player knows how
-     * much they can spend. Then the player is asked to input an integer for how much they want to bet. The input is first
-     * checked for being numerical (not a string with letters or symbols), whether it is at least 1, and whether the player
-     * has enough money to place the bet. When all checks are passed, the bet is returned as an integer.
+     * This function handles paying the player the right amount of money based on the conclusion of the round (see
+     * concludeRound()). For a normal win, the ratio is 1:1, so the player gets back twice their bet. In case of
+     * winning with a Blackjack, the payout ratio is 3:2 (or 6:5, see setBlackjackPayout()), so the player gets back
+     * their bet times 1.5 + their bet. For a tie, the ratio is 0:1, so the player only gets back their bet. Payouts
+     * that do not come out at a whole cent are rounded down (see Money::payout()).
      */
-    unsigned int requestBetAmount();
+    void payout(Money bet, PayoutRatio ratio);
 
     /**
-     * This function handles paying the player the right amount of money based on the conclusion of the round (see
-     * concludeRound()). For a normal win, the factor is 1, so the player gets back twice their bet. In case of
-     * winning with a Blackjack, the payout rate is 2:3, so the player gets back their bet times factor 1.5 + their bet.
+     * This function prints an overview of the player's remaining balance and the bet they placed to the input "stream".
+     */
+    void printBalanceAndBet(std::ostream &stream);
+
+    /**
+     * This function publishes an event of the input "type" for the current round to the spectators, with the input
+     * "seat", "value" and "amount" (see TableEvent). Without a broadcast, nothing happens.
+     */
+    void publishEvent(TableEvent::Type type, uint8_t seat = 0, uint8_t value = 0, Money amount = Money());
+
+    /**
+     * This function deals one card to the input "handToDealTo", face down if "faceDown" is true. The card is drawn from
+     * the card source of the game (see useCardSource()), or generated randomly by the Card class if the game has no card
+     * source.
+     */
+    void dealCard(Hand &handToDealTo, bool faceDown = false);
+
+    /**
+     * This function returns true if the dealer's open card and hole card are a blackjack. Only the game values of the
+     * two cards are added up, so peeking does not show the hole card to anyone.
+     */
+    bool dealerPeeksBlackjack();
+
+    /**
+     * This function deals the dealer's second card face up when the player has reached 21 at a table without a hole
+     * card (see HoleCardRule). A dealer's blackjack still beats a 21 of more cards, and ties with a player's blackjack.
      */
-    void payout(double bet, double factor);
+    SubTask<> dealDealerSecondCard();
 
     /**
-     * This function prints an overview of the player's remaining balance and the bet they placed.
+     * This function turns the dealer's hole card face up, if the dealer has one lying face down, and publishes it.
      */
-    void printBalanceAndBet();
+    void revealHoleCard();
 
     /**
-     * This function uses thread and chrono to sleep the program for as many seconds as specified by the parameter
-     * "secondsToWait". This can be used as a delay to add timed pauses within the program where necessary. This method
-     * of pausing a program was learned from https://cplusplus.com/reference/thread/this_thread/sleep_for/.
+     * This function pauses the program for as many seconds as specified by the parameter "secondsToWait". This can be
+     * used as a delay to add timed pauses within the program where necessary. The actual pausing is delegated to the
+     * pacer of the game, so the pause may also be skipped entirely. With a remote player, the round waits for a timer
+     * of the player's scheduler instead, without blocking the thread.
      */
-    void waitSeconds(int secondsToWait);
+    SubTask<> waitSeconds(int secondsToWait);
+
+    /**
+     * This function reads the next word the user entered into "userInput". If the input has ended (for example because a
+     * script has been played completely), the game is quit and false is returned. A remote player is sent the question
+     * of the input "questionType" instead, and the round waits for their answer.
+     */
+    SubTask<bool> readUserInput(string &userInput, TableQuestion::Type questionType);
 
 public:
     Hand playerHand;
     Hand dealerHand;
 
+    /**
+     * This function calculates and returns the optimal sum of a hand of cards according to standard Blackjack rules.
+     * It iterates through each card in the hand, adding their game values to the total sum. Additionally, it keeps track
+     * of the number of Aces in the hand as they can have a flexible value of 1 or 11. In case the sum exceeds 21 (busting),
+     * the function adjusts the value of Aces from 11 to 1 to minimize the total sum and avoid busting. Cards lying face
+     * down (the dealer's hole card) are not counted, as the player does not know them yet.
+     */
+    static unsigned int sumOptimal(Hand &handToSum);
+
+    /**
+     * This function calculates and returns the optimal sum of a hand from the sum of the game values of its cards
+     * ("sumOfGameValues", with every Ace counted as 11) and the amount of Aces in the hand ("numberOfAcesInHand"). In
+     * case the sum exceeds 21 (busting), the value of Aces is adjusted from 11 to 1 to minimize the total sum and avoid
+     * busting.
+     */
+    static unsigned int sumOptimal(int sumOfGameValues, int numberOfAcesInHand);
+
+    /**
+     * This function returns true if the optimal sum of the input "handToCheck" (see sumOptimal()) counts an Ace as 11,
+     * so the next card cannot bust the hand.
+     */
+    static bool isSoft(Hand &handToCheck);
+
+    /**
+     * This function returns true if a hand with the input "sumOfGameValues" (with every Ace counted as 11) and
+     * "cardCount" is a blackjack: an Ace and a 10-value card are the only two cards that add up to 21. This is how the
+     * dealer peeks for a blackjack, in the console game and in the simulations.
+     */
+    static bool isBlackjack(int sumOfGameValues, int cardCount) {
+        return cardCount == 2 && sumOfGameValues == 21;
+    }
+
+    /**
+     * This function determines the outcome of a round based on the final sums and the amount of cards of the player
+     * ("playerSum", "playerCardCount") and the dealer ("dealerSum", "dealerCardCount"). It evaluates all possible
+     * scenarios such as busting (sum > 21), winning with a higher sum, having a tie and it checks the presence of a
+     * blackjack (21 with the initial two cards). The function only uses plain numbers, so the same rules can be used by
+     * the console game and by simulations.
+     */
+    static RoundOutcome determineOutcome(int playerSum, int playerCardCount, int dealerSum, int dealerCardCount);
+
+    /**
+     * Default constructor: defines a game of Blackjack that sleeps the program in between card draws.
+     */
+    Blackjack();
+
+    /**
+     * Constructor for a game of Blackjack that uses the input Pacer "pacer_" for the pauses in between card draws.
+     * For example, a ZeroDelayPacer runs the game without any pauses. Note that the pacer is not copied, so it must
+     * outlive the Blackjack object.
+     */
+    explicit Blackjack(Pacer &pacer_);
+
     /**
      * This function launches the game and takes the to sort of a 'main menu'. It welcomes the user and asks them
      * whether they want to start playing a round of Blackjack or want to quit the program. Based on the user's entered
-     * response in the form of a letter, this function calls the playRound() or quitGame() functions.
+     * response in the form of a letter, this function calls the playRound() or quitGame() functions. The game itself
+     * is played by playGame(), which this function runs to its end on the calling thread: the answers are read from
+     * the input and the pauses are made by the pacer, so the game never has to wait for a scheduler.
      */
     void launchGame();
 
     /**
-     * This function exits the program with code 0 (successful exit)
+     * This function plays the game: it welcomes the user and asks them whether they want to start playing rounds of
+     * Blackjack or want to quit. The rounds are played one after the other until the player quits or runs out of
+     * money. It is a coroutine, which launchGame() runs to its end on the calling thread and an AsyncTable on its
+     * scheduler.
+     */
+    SubTask<> playGame();
+
+    /**
+     * This function ends the game. It says goodbye to the player and stops the rounds, after which launchGame() returns.
      */
     void quitGame();
+
+    /**
+     * This function sets up the game for a scripted session. The user input is read from the input stream "commands"
+     * instead of the keyboard, nothing is printed to the console and the game is played without pauses. The stream is not
+     * copied, so it must outlive the scripted session.
+     */
+    void useScriptedSession(std::istream &commands);
+
+    /**
+     * This function makes the game deal its cards from the input "cardSource_", for example a Shoe, instead of
+     * generating random cards. The card source is not copied, so it must outlive the game.
+     */
+    void useCardSource(CardSource &cardSource_);
+
+    /**
+     * This function connects the game to the account "accountName_" in the input "accountStore_". The balance of the
+     * account is used as the player's balance (a new account starts with the usual starting money), and every bet and
+     * payout is stored in the account, so the balance survives quitting the game. The store is not copied, so it must
+     * outlive the game.
+     */
+    void useAccount(AccountStore &accountStore_, const string &accountName_);
+
+    /**
+     * This function publishes every step of a round as a typed event to the input "broadcast_", for spectators and
+     * other consumers (see TableBroadcast.h). The broadcast is not copied, so it must outlive the game.
+     */
+    void useBroadcast(TableBroadcast &broadcast_);
+
+    /**
+     * This function lets the game be played by the input "remotePlayer_" instead of a user at the console: every
+     * question is sent to the player, and the round waits for the answer and for the pauses on the player's scheduler
+     * without blocking the thread, so the game must be played with playGame() on that scheduler. Nothing is printed.
+     * The connection is not copied, so it must outlive the game.
+     */
+    void useRemotePlayer(RemotePlayer &remotePlayer_);
+
+    /**
+     * This function sets whether the table is redrawn in place at the top of the terminal ("inPlace" is true, the
+     * default) or printed below the previous one, scrolling the terminal.
+     */
+    void setRedrawInPlace(bool inPlace);
+
+    /**
+     * This function sets the payout "ratio" of a blackjack, which is 3:2 by default. Many casinos pay only 6:5.
+     */
+    void setBlackjackPayout(PayoutRatio ratio);
+
+    /**
+     * This function sets whether the dealer gets a hole card and peeks for blackjack ("rule" is PEEK, the default) or
+     * only gets a second card after the player stands or reaches 21 (NO_HOLE_CARD), see HoleCardRule.
+     */
+    void setHoleCardRule(HoleCardRule rule);
+
+    /**
+     * This function sets the balance of the player to the input "amount", for example to start with more than the
+     * usual starting money.
+     */
+    void setPlayerMoney(Money amount);
+
+    /**
+     * This function returns the current balance of the player.
+     */
+    Money getPlayerMoney() const;
+
+    /**
+     * This function returns the amount of rounds that have been played in this game.
+     */
+    int getRoundsPlayed() const;
 };
 
 
@@ -13,10 +13,8 @@
 #include <vector>
 #include <string>
 
-// A little "library" by Vincent Godin that allows the use of color in cout:
-// https://www.codeproject.com/Articles/16431/Add-color-to-your-std-cout
-// From the .h file, we can see that the available colors are blue, red, green, yellow and white
-#include "ConsoleColor.h"
+#include "CardGlyphs.h"
+#include "Instrumentation.h"
 
 // Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
 using std::cout, std::endl, std::cerr, std::cin, std::vector, std::string, std::left, std::right, std::to_string,
@@ -27,18 +25,7 @@ using std::cout, std::endl, std::cerr, std::cin, std::vector, std::string, std::
  */
 string Card::generateRandomCardValueString() {
     int randomValue = rand() % 13 + 1;
-
-    if (randomValue == 1) {
-        return "A";
-    } else if (randomValue == 11) {
-        return "J";
-    } else if (randomValue == 12) {
-        return "Q";
-    } else if (randomValue == 13) {
-        return "K";
-    } else {
-        return to_string(randomValue);
-    }
+    return faceValueOfRank(randomValue);
 }
 
 /**
@@ -90,6 +77,7 @@ void Card::errorCheckCardSymbol(const string &symbolString) {
  * Default constructor: defines a Card object with random face value and symbol if no input parameters are provided
  */
 Card::Card() {
+    INSTRUMENT_COUNT(CARDS_CREATED, 1);
     faceValueString = generateRandomCardValueString();
     symbolString = generateRandomCardSymbolString();
 }
@@ -108,12 +96,23 @@ Card::Card() {
  * A King of clubs card would be specified as Card("K", "clubs").
  */
 Card::Card(string faceValueString_, string symbolString_) {
+    INSTRUMENT_COUNT(CARDS_CREATED, 1);
     errorCheckCardValue(faceValueString_);
     errorCheckCardSymbol(symbolString_);
     faceValueString = faceValueString_;
     symbolString = symbolString_;
 }
 
+/**
+ * Constructor for a Card object with the face value of the input "rank" (1-13, see faceValueOfRank()) and a random
+ * symbol. This is used to turn a rank drawn from a CardSource into a Card that can be added to a Hand.
+ */
+Card::Card(int rank) {
+    INSTRUMENT_COUNT(CARDS_CREATED, 1);
+    faceValueString = faceValueOfRank(rank);
+    symbolString = generateRandomCardSymbolString();
+}
+
 /**
  * This function sets or modifies the face value of a Card object to the input string "newFaceValue".
  */
@@ -193,6 +192,64 @@ bool Card::isAce() {
     }
 }
 
+/**
+ * This function turns the Card object face down if the input "faceDown_" is true, and face up otherwise.
+ */
+void Card::setFaceDown(bool faceDown_) {
+    faceDown = faceDown_;
+}
+
+/**
+ * This function returns true if the Card object lies face down.
+ */
+bool Card::isFaceDown() {
+    return faceDown;
+}
+
+/**
+ * This function returns the game value of a card rank given as an integer "rank", where 1 is an Ace, 2-10 are the
+ * number cards and 11, 12 and 13 are the Jack, Queen and King. Like getGameValue(), an Ace is returned as 11. This
+ * allows simulations to work with plain integer ranks instead of Card objects.
+ */
+int Card::gameValueOfRank(int rank) {
+    if (rank == 1) {
+        return 11;
+    } else if (rank >= 10) {
+        return 10;
+    } else {
+        return rank;
+    }
+}
+
+/**
+ * This function returns the face value string of a card rank given as an integer "rank": "A" for 1, "2"-"10" for
+ * the number cards and "J", "Q" and "K" for 11, 12 and 13.
+ */
+string Card::faceValueOfRank(int rank) {
+    if (rank == 1) {
+        return "A";
+    } else if (rank == 11) {
+        return "J";
+    } else if (rank == 12) {
+        return "Q";
+    } else if (rank == 13) {
+        return "K";
+    } else {
+        return to_string(rank);
+    }
+}
+
+/**
+ * This function returns the index of the Card's glyph in the atlas of prerendered cards (see CardGlyphs.h), or the
+ * glyph of the back of a card if the Card lies face down.
+ */
+int Card::getGlyphIndex() {
+    if (faceDown) {
+        return CardGlyphs::FACE_DOWN;
+    }
+    return CardGlyphs::glyphIndex(faceValueString, symbolString);
+}
+
 /**
  * This function prints a Card object to the console in a graphical way, based on its faceValueString and its
  * symbolString. This is an example of a printed card where faceValueString = "5" and symbolString = "hearts":
@@ -203,60 +260,15 @@ bool Card::isAce() {
  *  |        ♥ |
  *  |        5 |
  *  +----------+
+ *
+ * The lines of the card are copied from its glyph in the atlas of prerendered cards (see CardGlyphs.h).
  */
 void Card::printCard() {
-    cout << "+----------+" << endl;
-
-    // Printing the top row with value
-    cout << "| ";
-    // The color is based on the symbol
-    // if the symbol is red, then the text is printed in red, else in white/black
-    if (symbolString == "hearts" || symbolString == "diamonds") {
-        cout << red << left << setw(2) << faceValueString << white << "       |";
-    } else {
-        cout << left << setw(2) << faceValueString << "       |";
-    }
-    cout << endl;
-
-    // Printing the top row with symbol
-    // in order to get to the symbols and not the card cardsData
-    char symbolIcon = cardSymbolStringToIconChar(symbolString);
-
-    // Printing the left border of the card in white/black
-    cout << "| ";
-    // If the symbol is hearts or diamonds, print it in red and else in white/black
-    if (symbolString == "hearts" || symbolString == "diamonds") {
-        cout << red << symbolIcon << white;
-    } else {
-        cout << symbolIcon;
-    }
-    // Printing the right border of the card in white/black
-    cout << "        |" << endl;
-
-    // Printing the empty middle row of a card
-    cout << "|          |" << endl;
-
-    // Printing the bottom row with symbol
-    cout << "|        ";
-    // if the symbol is hearts or diamonds, print it in red and else in white/black
-    if (symbolString == "hearts" || symbolString == "diamonds") {
-        cout << red << symbolIcon << white;
-    } else {
-        cout << symbolIcon;
+    string cardText;
+    int glyphIndex = getGlyphIndex();
+    for (int line = 0; line < CardGlyphs::LINES_PER_CARD; ++line) {
+        CardGlyphs::appendLine(cardText, glyphIndex, line);
+        cardText += '\n';
     }
-    cout << " |" << endl;
-
-    // Printing the bottom row(s) with value(s)
-    cout << "|       ";
-    // The color is based on the symbol, which is i+1 in the vector
-    // If the symbol is red, then the text is printed in red, else in white/black
-    if (symbolString == "hearts" || symbolString == "diamonds") {
-        cout << red << right << setw(2) << faceValueString << white;
-    } else {
-        cout << right << setw(2) << faceValueString;
-    }
-    cout << " |" << endl;
-
-    // Printing the bottom border
-    cout << "+----------+" << endl;
+    cout << cardText;
 }
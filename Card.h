@@ -17,6 +17,7 @@ class Card {
 private:
     string faceValueString; // the face value is the value as printed on a card, being 2-10, A, J, Q or K
     string symbolString;
+    bool faceDown = false; // a card lying face down, like the dealer's hole card, is not known to the player
 
     // Defining the card symbol characters based on this online forum discussion:
     // https://www.daniweb.com/programming/software-development/threads/296311/can-i-get-the-cards-suit-symbols-as-a-character
@@ -70,6 +71,12 @@ public:
      */
     Card(string faceValueString_, string symbolString_);
 
+    /**
+     * Constructor for a Card object with the face value of the input "rank" (1-13, see faceValueOfRank()) and a random
+     * symbol. This is used to turn a rank drawn from a CardSource into a Card that can be added to a Hand.
+     */
+    explicit Card(int rank);
+
     /**
      * This function sets or modifies the face value of a Card object to the input string "newFaceValue".
      */
@@ -108,6 +115,35 @@ public:
      */
     bool isAce();
 
+    /**
+     * This function turns the Card object face down if the input "faceDown_" is true, and face up otherwise.
+     */
+    void setFaceDown(bool faceDown_);
+
+    /**
+     * This function returns true if the Card object lies face down.
+     */
+    bool isFaceDown();
+
+    /**
+     * This function returns the game value of a card rank given as an integer "rank", where 1 is an Ace, 2-10 are the
+     * number cards and 11, 12 and 13 are the Jack, Queen and King. Like getGameValue(), an Ace is returned as 11. This
+     * allows simulations to work with plain integer ranks instead of Card objects.
+     */
+    static int gameValueOfRank(int rank);
+
+    /**
+     * This function returns the face value string of a card rank given as an integer "rank": "A" for 1, "2"-"10" for
+     * the number cards and "J", "Q" and "K" for 11, 12 and 13.
+     */
+    static string faceValueOfRank(int rank);
+
+    /**
+     * This function returns the index of the Card's glyph in the atlas of prerendered cards (see CardGlyphs.h), or the
+     * glyph of the back of a card if the Card lies face down.
+     */
+    int getGlyphIndex();
+
     /**
      * This function prints a Card object to the console in a graphical way, based on its faceValueString and its
      * symbolString. This is an example of a printed card where faceValueString = "5" and symbolString = "hearts":
@@ -118,6 +154,8 @@ public:
      *  |        ♥ |
      *  |        5 |
      *  +----------+
+     *
+     * The lines of the card are copied from its glyph in the atlas of prerendered cards (see CardGlyphs.h).
      */
     void printCard();
 };
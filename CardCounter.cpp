@@ -0,0 +1,65 @@
+/**
+ * The CardCounter class keeps the running counts of several card counting systems at the same time. Card counting
+ * players give every rank a small weight (for example +1 for low cards and -1 for high cards in Hi-Lo) and add up the
+ * weights of all cards they have seen. A high count means many low cards have been dealt, so the remaining cards are
+ * rich in tens and Aces, which is good for the player.
+ *
+ * All weights are stored in one small table with a row per rank and a column per counting system, so observing a
+ * card only adds one row of the table to the running counts. The true count (the running count divided by the amount
+ * of decks that have not been dealt yet) is calculated from the running count when asked, so it costs nothing extra
+ * while dealing.
+ *
+ * The supported counting systems are Hi-Lo, KO (Knock-Out), Hi-Opt I, Omega II and the Zen Count. KO is an unbalanced
+ * count: its weights do not add up to zero over a deck, so it starts at 4 - 4 x decks instead of 0 and reaches +4 on
+ * average at the end of the shoe.
+ */
+
+#include "CardCounter.h"
+
+/**
+ * This function resets all running counts for a freshly shuffled shoe of "amountOfDecks" decks.
+ */
+void CardCounter::reset(int amountOfDecks) {
+    for (int &runningCount : runningCounts) {
+        runningCount = 0;
+    }
+    // KO is unbalanced (+4 per deck), so it starts below zero to end at +4 on average
+    runningCounts[(int) CountingSystem::KO] = 4 - 4 * amountOfDecks;
+}
+
+/**
+ * This function returns the running count of the input counting "system".
+ */
+int CardCounter::getRunningCount(CountingSystem system) {
+    return runningCounts[(int) system];
+}
+
+/**
+ * This function returns the true count of the input counting "system": the running count divided by the amount of
+ * decks that have not been dealt yet ("decksRemaining"). To avoid dividing by (almost) zero at the very end of a
+ * shoe, at least half a deck is assumed to remain.
+ */
+double CardCounter::getTrueCount(CountingSystem system, double decksRemaining) {
+    if (decksRemaining < 0.5) {
+        decksRemaining = 0.5;
+    }
+    return runningCounts[(int) system] / decksRemaining;
+}
+
+/**
+ * This function returns the name of the input counting "system", for example "Hi-Lo".
+ */
+string CardCounter::getName(CountingSystem system) {
+    switch (system) {
+        case CountingSystem::HI_LO:
+            return "Hi-Lo";
+        case CountingSystem::KO:
+            return "KO";
+        case CountingSystem::HI_OPT_I:
+            return "Hi-Opt I";
+        case CountingSystem::OMEGA_II:
+            return "Omega II";
+        default:
+            return "Zen Count";
+    }
+}
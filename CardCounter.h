@@ -0,0 +1,94 @@
+/**
+ * The CardCounter class keeps the running counts of several card counting systems at the same time. Card counting
+ * players give every rank a small weight (for example +1 for low cards and -1 for high cards in Hi-Lo) and add up the
+ * weights of all cards they have seen. A high count means many low cards have been dealt, so the remaining cards are
+ * rich in tens and Aces, which is good for the player.
+ *
+ * All weights are stored in one small table with a row per rank and a column per counting system, so observing a
+ * card only adds one row of the table to the running counts. The true count (the running count divided by the amount
+ * of decks that have not been dealt yet) is calculated from the running count when asked, so it costs nothing extra
+ * while dealing.
+ *
+ * The supported counting systems are Hi-Lo, KO (Knock-Out), Hi-Opt I, Omega II and the Zen Count. KO is an unbalanced
+ * count: its weights do not add up to zero over a deck, so it starts at 4 - 4 x decks instead of 0 and reaches +4 on
+ * average at the end of the shoe.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_CARDCOUNTER_H
+#define PIE_CPP_BLACKJACK_CARDCOUNTER_H
+
+#include <string>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string;
+
+enum class CountingSystem {
+    HI_LO,
+    KO,
+    HI_OPT_I,
+    OMEGA_II,
+    ZEN_COUNT
+};
+
+class CardCounter {
+public:
+    static const int AMOUNT_OF_COUNTING_SYSTEMS = 5;
+
+private:
+    // The weights per rank (row 1 is an Ace, rows 10-13 are the ten-valued cards) and per counting system (columns in
+    // the order of the CountingSystem enum). Row 0 is not used.
+    static constexpr int COUNT_WEIGHTS[14][AMOUNT_OF_COUNTING_SYSTEMS] = {
+            // Hi-Lo, KO, Hi-Opt I, Omega II, Zen
+            {0,  0,  0,  0,  0},  // (not used)
+            {-1, -1, 0,  0,  -1}, // A
+            {1,  1,  0,  1,  1},  // 2
+            {1,  1,  1,  1,  1},  // 3
+            {1,  1,  1,  2,  2},  // 4
+            {1,  1,  1,  2,  2},  // 5
+            {1,  1,  1,  2,  2},  // 6
+            {0,  1,  0,  1,  1},  // 7
+            {0,  0,  0,  0,  0},  // 8
+            {0,  0,  0,  -1, 0},  // 9
+            {-1, -1, -1, -2, -2}, // 10
+            {-1, -1, -1, -2, -2}, // J
+            {-1, -1, -1, -2, -2}, // Q
+            {-1, -1, -1, -2, -2}  // K
+    };
+
+    int runningCounts[AMOUNT_OF_COUNTING_SYSTEMS] = {};
+
+public:
+    /**
+     * This function resets all running counts for a freshly shuffled shoe of "amountOfDecks" decks.
+     */
+    void reset(int amountOfDecks);
+
+    /**
+     * This function adds the weights of a card with the input "rank" (1-13) to the running counts of all systems.
+     */
+    void observe(int rank) {
+        const int *weights = COUNT_WEIGHTS[rank];
+        for (int system = 0; system < AMOUNT_OF_COUNTING_SYSTEMS; ++system) {
+            runningCounts[system] += weights[system];
+        }
+    }
+
+    /**
+     * This function returns the running count of the input counting "system".
+     */
+    int getRunningCount(CountingSystem system);
+
+    /**
+     * This function returns the true count of the input counting "system": the running count divided by the amount of
+     * decks that have not been dealt yet ("decksRemaining"). To avoid dividing by (almost) zero at the very end of a
+     * shoe, at least half a deck is assumed to remain.
+     */
+    double getTrueCount(CountingSystem system, double decksRemaining);
+
+    /**
+     * This function returns the name of the input counting "system", for example "Hi-Lo".
+     */
+    static string getName(CountingSystem system);
+};
+
+
+#endif //PIE_CPP_BLACKJACK_CARDCOUNTER_H
@@ -0,0 +1,99 @@
+/**
+ * The CardGlyphs class holds the graphical representation of every card, prerendered by the compiler (constexpr) into
+ * an atlas of glyphs: the 52 card faces and the back of a face-down card. A glyph is the 7 lines of a card as text,
+ * including the colour codes of red cards, so drawing a card is copying its lines into the text of the table (the frame)
+ * instead of formatting the face value and switching the colour of the console for every line.
+ *
+ * Every line is 12 characters wide on the screen. The colour codes are ANSI escape codes, which take up no space on
+ * the screen: bright red for hearts and diamonds, and back to white after them, like the red and white manipulators of
+ * ConsoleColor.h. The Windows console only understands these codes once enableColourCodes() has been called.
+ *
+ * Example of the glyph of the 5 of hearts, and of a face-down card:
+ *  +----------+    +----------+
+ *  | 5        |    |//////////|
+ *  | ♥        |    |//////////|
+ *  |          |    |//////////|
+ *  |        ♥ |    |//////////|
+ *  |        5 |    |//////////|
+ *  +----------+    +----------+
+ */
+
+#include "CardGlyphs.h"
+
+// Only the Windows console has to be told about the colour codes, other terminals understand them already
+#ifdef _WIN32
+#include <windows.h>
+
+// Older versions of windows.h do not define the console mode that understands colour codes yet
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#endif
+
+/**
+ * This function checks at compile time that every line of every glyph is LINE_WIDTH characters wide on the screen
+ * (not counting the colour codes), so the cards of a hand line up.
+ */
+static constexpr bool glyphLinesHaveTheSameWidth() {
+    for (const CardGlyphs::Glyph &glyph : CardGlyphs::ATLAS.glyphs) {
+        for (const CardGlyphs::Line &line : glyph.lines) {
+            int width = 0;
+            for (int i = 0; i < line.length; ++i) {
+                if (line.text[i] == '\x1b') {
+                    // Skipping a colour code up to and including its closing 'm'
+                    while (line.text[i] != 'm') {
+                        i++;
+                    }
+                } else {
+                    width++;
+                }
+            }
+            if (width != CardGlyphs::LINE_WIDTH) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static_assert(glyphLinesHaveTheSameWidth(), "The lines of the card glyphs do not have the same width");
+
+/**
+ * This function returns the index in the atlas of the card with the input "faceValue" ("2"-"10", "A", "J", "Q" or
+ * "K") and "symbol" ("hearts", "diamonds", "clubs" or "spades"), as they are stored in a Card.
+ */
+int CardGlyphs::glyphIndex(const string &faceValue, const string &symbol) {
+    int rank;
+    if (faceValue == "A") {
+        rank = 1;
+    } else if (faceValue == "J") {
+        rank = 11;
+    } else if (faceValue == "Q") {
+        rank = 12;
+    } else if (faceValue == "K") {
+        rank = 13;
+    } else {
+        rank = std::stoi(faceValue);
+    }
+
+    int suit = 0;
+    while (suit < AMOUNT_OF_SUITS - 1 && symbol != SUIT_NAMES[suit]) {
+        suit++;
+    }
+    return glyphIndex(rank, suit);
+}
+
+/**
+ * This function lets the Windows console show the colour codes in the glyphs as colours (instead of printing
+ * them as text). It only needs to be called once, before the first card is drawn. Other terminals understand the
+ * colour codes already, so elsewhere it does nothing.
+ */
+void CardGlyphs::enableColourCodes() {
+#ifdef _WIN32
+    HANDLE hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(hStdout, &mode)) {
+        SetConsoleMode(hStdout, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+}
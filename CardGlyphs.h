@@ -0,0 +1,173 @@
+/**
+ * The CardGlyphs class holds the graphical representation of every card, prerendered by the compiler (constexpr) into
+ * an atlas of glyphs: the 52 card faces and the back of a face-down card. A glyph is the 7 lines of a card as text,
+ * including the colour codes of red cards, so drawing a card is copying its lines into the text of the table (the frame)
+ * instead of formatting the face value and switching the colour of the console for every line.
+ *
+ * Every line is 12 characters wide on the screen. The colour codes are ANSI escape codes, which take up no space on
+ * the screen: bright red for hearts and diamonds, and back to white after them, like the red and white manipulators of
+ * ConsoleColor.h. The Windows console only understands these codes once enableColourCodes() has been called.
+ *
+ * Example of the glyph of the 5 of hearts, and of a face-down card:
+ *  +----------+    +----------+
+ *  | 5        |    |//////////|
+ *  | ♥        |    |//////////|
+ *  |          |    |//////////|
+ *  |        ♥ |    |//////////|
+ *  |        5 |    |//////////|
+ *  +----------+    +----------+
+ */
+
+#ifndef PIE_CPP_BLACKJACK_CARDGLYPHS_H
+#define PIE_CPP_BLACKJACK_CARDGLYPHS_H
+
+#include <string>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string;
+
+class CardGlyphs {
+public:
+    static const int LINES_PER_CARD = 7;
+    static const int LINE_WIDTH = 12;    // the width of a line on the screen
+    static const int LINE_CAPACITY = 24; // the width plus two colour codes
+    static const int AMOUNT_OF_SUITS = 4;
+    static const int AMOUNT_OF_GLYPHS = 13 * AMOUNT_OF_SUITS + 1;
+    static const int FACE_DOWN = AMOUNT_OF_GLYPHS - 1; // the glyph of the back of a card
+
+    // The suits in the order of the atlas. The first two are red
+    static constexpr const char *SUIT_NAMES[AMOUNT_OF_SUITS] = {"hearts", "diamonds", "clubs", "spades"};
+    // The same symbol characters as the Card class (♥, ♦, ♣, ♠)
+    static constexpr char SUIT_ICONS[AMOUNT_OF_SUITS] = {'\x03', '\x04', '\x05', '\x06'};
+
+    struct Line {
+        char text[LINE_CAPACITY] = {};
+        int length = 0;
+    };
+
+    struct Glyph {
+        Line lines[LINES_PER_CARD] = {};
+    };
+
+    struct Atlas {
+        Glyph glyphs[AMOUNT_OF_GLYPHS] = {};
+    };
+
+    /**
+     * This function returns the index in the atlas of the card with the input "rank" (1 for an Ace up to 13 for a King)
+     * and "suit" (an index into SUIT_NAMES).
+     */
+    static constexpr int glyphIndex(int rank, int suit) {
+        return (rank - 1) * AMOUNT_OF_SUITS + suit;
+    }
+
+private:
+    /**
+     * This function adds the input "text" to the end of the input "line".
+     */
+    static constexpr void appendText(Line &line, const char *text) {
+        for (int i = 0; text[i] != '\0'; ++i) {
+            line.text[line.length++] = text[i];
+        }
+    }
+
+    /**
+     * This function adds the face value or symbol "text" to the end of the input "line", right aligned in a column of
+     * 2 characters if "alignRight" is true and left aligned otherwise. Red cards ("isRed") get the colour codes around
+     * it.
+     */
+    static constexpr void appendColouredText(Line &line, const char *text, bool alignRight, bool isRed) {
+        int textLength = 0;
+        while (text[textLength] != '\0') {
+            textLength++;
+        }
+        if (alignRight && textLength < 2) {
+            appendText(line, " ");
+        }
+        appendText(line, isRed ? "\x1b[91m" : "");
+        appendText(line, text);
+        appendText(line, isRed ? "\x1b[37m" : "");
+        if (!alignRight && textLength < 2) {
+            appendText(line, " ");
+        }
+    }
+
+    /**
+     * This function renders the glyph with the input "index" in the atlas, see the description at the top of this
+     * file.
+     */
+    static constexpr Glyph renderGlyph(int index) {
+        Glyph glyph;
+        appendText(glyph.lines[0], "+----------+");
+        appendText(glyph.lines[LINES_PER_CARD - 1], "+----------+");
+        if (index == FACE_DOWN) {
+            for (int line = 1; line < LINES_PER_CARD - 1; ++line) {
+                appendText(glyph.lines[line], "|//////////|");
+            }
+            return glyph;
+        }
+
+        const char *faceValues[13] = {"A", "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K"};
+        const char *faceValue = faceValues[index / AMOUNT_OF_SUITS];
+        int suit = index % AMOUNT_OF_SUITS;
+        const char symbol[2] = {SUIT_ICONS[suit], '\0'};
+        bool isRed = suit < 2;
+
+        appendText(glyph.lines[1], "| ");
+        appendColouredText(glyph.lines[1], faceValue, false, isRed);
+        appendText(glyph.lines[1], "       |");
+        appendText(glyph.lines[2], "| ");
+        appendColouredText(glyph.lines[2], symbol, false, isRed);
+        appendText(glyph.lines[2], "       |");
+        appendText(glyph.lines[3], "|          |");
+        appendText(glyph.lines[4], "|       ");
+        appendColouredText(glyph.lines[4], symbol, true, isRed);
+        appendText(glyph.lines[4], " |");
+        appendText(glyph.lines[5], "|       ");
+        appendColouredText(glyph.lines[5], faceValue, true, isRed);
+        appendText(glyph.lines[5], " |");
+        return glyph;
+    }
+
+    /**
+     * This function renders the glyphs of all cards and the face-down card.
+     */
+    static constexpr Atlas renderAtlas() {
+        Atlas atlas;
+        for (int index = 0; index < AMOUNT_OF_GLYPHS; ++index) {
+            atlas.glyphs[index] = renderGlyph(index);
+        }
+        return atlas;
+    }
+
+public:
+    // The atlas is defined below the class, as the compiler can only run the functions above once the class is
+    // complete
+    static const Atlas ATLAS;
+
+    /**
+     * This function returns the index in the atlas of the card with the input "faceValue" ("2"-"10", "A", "J", "Q" or
+     * "K") and "symbol" ("hearts", "diamonds", "clubs" or "spades"), as they are stored in a Card.
+     */
+    static int glyphIndex(const string &faceValue, const string &symbol);
+
+    /**
+     * This function adds line "line" (0 up to LINES_PER_CARD) of the glyph with the input "index" to the end of the
+     * input "frame".
+     */
+    static void appendLine(string &frame, int index, int line) {
+        const Line &glyphLine = ATLAS.glyphs[index].lines[line];
+        frame.append(glyphLine.text, glyphLine.length);
+    }
+
+    /**
+     * This function lets the Windows console show the colour codes in the glyphs as colours (instead of printing
+     * them as text). It only needs to be called once, before the first card is drawn. Other terminals understand the
+     * colour codes already, so elsewhere it does nothing.
+     */
+    static void enableColourCodes();
+};
+
+inline constexpr CardGlyphs::Atlas CardGlyphs::ATLAS = CardGlyphs::renderAtlas();
+
+
+#endif //PIE_CPP_BLACKJACK_CARDGLYPHS_H
@@ -0,0 +1,47 @@
+/**
+ * The CardSource class defines where the cards of a game come from. The Card class can generate a random card by
+ * itself, which models a deck with an infinite amount of cards. Simulations however need to draw millions of cards
+ * quickly, need their own random number generator per thread and need to be able to model other kinds of decks. A
+ * CardSource therefore draws card ranks as plain integers (1 is an Ace, 2-10 are the number cards and 11, 12 and 13
+ * are the Jack, Queen and King), see Card::gameValueOfRank() for their game values.
+ *
+ * The InfiniteDeck class is the simplest card source: like the Card class, every rank has the same chance of being
+ * drawn on every draw, no matter which cards were drawn before.
+ */
+
+#include "CardSource.h"
+
+/**
+ * This function returns the true count of the cards that have been drawn so far, which card counting players base
+ * their bets and decisions on. A card source that cannot be counted (like an infinite deck) always returns 0.
+ */
+double CardSource::getTrueCount() {
+    return 0;
+}
+
+/**
+ * This function tells the card source that a round has finished. Card sources that need to do something in between
+ * rounds (such as shuffling) can do so here. By default, nothing happens.
+ */
+void CardSource::finishRound() {}
+
+/**
+ * Constructor for an infinite deck with its own random number generator, seeded with the input "seed". Two decks
+ * with the same seed draw the same cards.
+ */
+InfiniteDeck::InfiniteDeck(uint64_t seed) : randomGenerator(seed) {}
+
+/**
+ * This function draws the next card and returns its rank (1-13). Every rank has the same chance of being drawn.
+ */
+int InfiniteDeck::drawRank() {
+    return rankDistribution(randomGenerator);
+}
+
+/**
+ * This function returns 32 uniformly distributed random bits from the generator of the deck, for simulations that
+ * pick a result with one random number instead of drawing cards (see DealerTable).
+ */
+uint32_t InfiniteDeck::drawRandomBits() {
+    return (uint32_t) (randomGenerator() >> 32);
+}
@@ -0,0 +1,106 @@
+/**
+ * The ContinuousShuffler class models a continuous shuffling machine (CSM), as used at tables that never reshuffle a
+ * whole shoe. Instead of a shoe with a cut card, the machine holds the cards in a number of slots (shelves):
+ *  - after every round, the cards that were dealt in it go back into the machine. Every card is put into a random
+ *    slot, on top of or below the cards already in that slot;
+ *  - the dealer takes the cards from a delivery buffer. When fewer cards than the minimum are left in the buffer, the
+ *    machine drops the whole contents of a random slot into it.
+ *
+ * Because of this, cards that were just played can come back after only a few rounds, and the cards in the buffer
+ * are not a fresh random order. Putting a card back and delivering a card each cost the same no matter how many
+ * decks the machine holds, so simulations with a CSM run as fast as with a shoe. A CSM cannot be counted, so the true
+ * count is always 0.
+ */
+
+
+#include "ContinuousShuffler.h"
+
+#include <algorithm>
+
+/**
+ * Constructor for a machine with "amountOfDecks" standard decks, spread over "amountOfSlots" slots, which keeps at
+ * least "bufferMinimum_" cards in its delivery buffer. The machine picks its slots with its own random number
+ * generator, seeded with the input "seed".
+ */
+ContinuousShuffler::ContinuousShuffler(int amountOfDecks, int amountOfSlots, int bufferMinimum_, uint64_t seed)
+        : bufferMinimum(bufferMinimum_), slots(std::max(1, amountOfSlots)), randomGenerator(seed) {
+    // Every deck has 4 cards of every rank, which are loaded into the machine one by one like discards
+    for (int deck = 0; deck < amountOfDecks; ++deck) {
+        for (int rank = 1; rank <= 13; ++rank) {
+            for (int suit = 0; suit < 4; ++suit) {
+                insertIntoRandomSlot(rank);
+            }
+        }
+    }
+}
+
+/**
+ * This function puts a card with the input "rank" into a random slot, on top of or below the cards in it.
+ */
+void ContinuousShuffler::insertIntoRandomSlot(int rank) {
+    // The upper 32 bits pick the slot without a division, the lowest bit picks the top or the bottom
+    uint64_t randomBits = randomGenerator();
+    deque<int> &slot = slots[((randomBits >> 32) * slots.size()) >> 32];
+    if (randomBits & 1) {
+        slot.push_front(rank);
+    } else {
+        slot.push_back(rank);
+    }
+}
+
+/**
+ * This function drops the cards of a random slot that is not empty into the delivery buffer.
+ */
+void ContinuousShuffler::releaseRandomSlot() {
+    // Most slots hold cards, so a random slot is almost always fine. Otherwise the next slot that holds cards is taken
+    size_t first = ((randomGenerator() >> 32) * slots.size()) >> 32;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        deque<int> &slot = slots[(first + i) % slots.size()];
+        if (!slot.empty()) {
+            deliveryBuffer.insert(deliveryBuffer.end(), slot.begin(), slot.end());
+            slot.clear();
+            return;
+        }
+    }
+}
+
+/**
+ * This function deals the next card from the delivery buffer and returns its rank (1-13). The buffer is filled
+ * up from the slots first if it holds fewer cards than the minimum.
+ */
+int ContinuousShuffler::drawRank() {
+    while ((int) deliveryBuffer.size() < std::max(1, bufferMinimum)) {
+        size_t bufferSize = deliveryBuffer.size();
+        releaseRandomSlot();
+        if (deliveryBuffer.size() == bufferSize) {
+            break; // the machine is empty
+        }
+    }
+    if (deliveryBuffer.empty()) {
+        // All cards are on the table, which only happens with a tiny machine. The dealt cards go back in first
+        finishRound();
+        releaseRandomSlot();
+    }
+
+    int rank = deliveryBuffer.front();
+    deliveryBuffer.pop_front();
+    dealtCards.push_back(rank);
+    return rank;
+}
+
+/**
+ * This function puts all cards that were dealt during the round that has just finished back into random slots.
+ */
+void ContinuousShuffler::finishRound() {
+    for (int rank : dealtCards) {
+        insertIntoRandomSlot(rank);
+    }
+    dealtCards.clear();
+}
+
+/**
+ * This function returns the amount of cards in the delivery buffer.
+ */
+int ContinuousShuffler::getCardsInBuffer() {
+    return (int) deliveryBuffer.size();
+}
@@ -0,0 +1,71 @@
+/**
+ * The ContinuousShuffler class models a continuous shuffling machine (CSM), as used at tables that never reshuffle a
+ * whole shoe. Instead of a shoe with a cut card, the machine holds the cards in a number of slots (shelves):
+ *  - after every round, the cards that were dealt in it go back into the machine. Every card is put into a random
+ *    slot, on top of or below the cards already in that slot;
+ *  - the dealer takes the cards from a delivery buffer. When fewer cards than the minimum are left in the buffer, the
+ *    machine drops the whole contents of a random slot into it.
+ *
+ * Because of this, cards that were just played can come back after only a few rounds, and the cards in the buffer
+ * are not a fresh random order. Putting a card back and delivering a card each cost the same no matter how many
+ * decks the machine holds, so simulations with a CSM run as fast as with a shoe. A CSM cannot be counted, so the true
+ * count is always 0.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_CONTINUOUSSHUFFLER_H
+#define PIE_CPP_BLACKJACK_CONTINUOUSSHUFFLER_H
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::deque, std::vector;
+
+#include "CardSource.h"
+
+class ContinuousShuffler : public CardSource {
+private:
+    int bufferMinimum;
+    vector<deque<int>> slots;
+    deque<int> deliveryBuffer;
+    vector<int> dealtCards; // the cards of the current round, which go back into the machine after the round
+    std::mt19937_64 randomGenerator;
+
+    /**
+     * This function puts a card with the input "rank" into a random slot, on top of or below the cards in it.
+     */
+    void insertIntoRandomSlot(int rank);
+
+    /**
+     * This function drops the cards of a random slot that is not empty into the delivery buffer.
+     */
+    void releaseRandomSlot();
+
+public:
+    /**
+     * Constructor for a machine with "amountOfDecks" standard decks, spread over "amountOfSlots" slots, which keeps at
+     * least "bufferMinimum_" cards in its delivery buffer. The machine picks its slots with its own random number
+     * generator, seeded with the input "seed".
+     */
+    ContinuousShuffler(int amountOfDecks, int amountOfSlots, int bufferMinimum_, uint64_t seed);
+
+    /**
+     * This function deals the next card from the delivery buffer and returns its rank (1-13). The buffer is filled
+     * up from the slots first if it holds fewer cards than the minimum.
+     */
+    int drawRank() override;
+
+    /**
+     * This function puts all cards that were dealt during the round that has just finished back into random slots.
+     */
+    void finishRound() override;
+
+    /**
+     * This function returns the amount of cards in the delivery buffer.
+     */
+    int getCardsInBuffer();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_CONTINUOUSSHUFFLER_H
@@ -0,0 +1,113 @@
+/**
+ * The CoroutineScheduler class runs many coroutines (C++20) on one thread, like the rounds of many tables that each
+ * wait for their own player (see AsyncTable.h). A coroutine does not block the thread while it waits for something: it
+ * suspends with co_await, and the scheduler resumes it once that something is there. A coroutine can wait for:
+ *  - a pause, with "co_await scheduler.sleep(seconds)": it is resumed once the pause is over (a timer);
+ *  - a message, with "co_await channel.receive()": it is resumed once a message has been sent into the Channel, for
+ *    example the decision of a player.
+ * A coroutine can also wait for another coroutine, a SubTask, like a function call that may wait in between: the round
+ * of a game waits for the bet of the player in requestBetAmount(), which waits for the answer (see Blackjack.h).
+ * The scheduler keeps the coroutines that can go on in a queue and the running timers in a heap ordered by the moment
+ * they end, and run() resumes them one after the other. A waiting coroutine only takes the memory of its frame (its
+ * local variables), instead of a whole thread with its stack, so thousands of rounds can wait at the same time.
+ *
+ * The scheduler either runs on the real time, in which case run() sleeps until the next timer ends when no coroutine
+ * can go on, or on a simulated time, which jumps straight to the end of the next timer. With the simulated time, the
+ * pauses are kept in the order of the rounds (which table goes first), but nobody waits for them (like the
+ * ZeroDelayPacer, see Pacer.h).
+ */
+
+#include "CoroutineScheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "Metrics.h"
+
+/**
+ * Constructor for a scheduler without coroutines. It runs on a simulated time if "useSimulatedTime" is true, and on the
+ * real time otherwise (see the description at the top of this file).
+ */
+CoroutineScheduler::CoroutineScheduler(bool useSimulatedTime)
+        : USE_SIMULATED_TIME(useSimulatedTime), START_TIME(Clock::now()), simulatedTime(START_TIME) {}
+
+/**
+ * This function returns the current time of the scheduler.
+ */
+CoroutineScheduler::Clock::time_point CoroutineScheduler::now() const {
+    return USE_SIMULATED_TIME ? simulatedTime : Clock::now();
+}
+
+/**
+ * This function returns the amount of seconds that have passed on the time of the scheduler since it was created.
+ */
+double CoroutineScheduler::getElapsedSeconds() const {
+    return std::chrono::duration<double>(now() - START_TIME).count();
+}
+
+/**
+ * This function returns something a coroutine can co_await to pause for "seconds" seconds.
+ */
+CoroutineScheduler::SleepAwaiter CoroutineScheduler::sleep(double seconds) {
+    return SleepAwaiter{*this, std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds))};
+}
+
+/**
+ * This function puts the input "coroutine" in the queue of coroutines that can go on, for example because the message
+ * it waits for has arrived.
+ */
+void CoroutineScheduler::resumeSoon(std::coroutine_handle<> coroutine) {
+    readyCoroutines.push_back(coroutine);
+    Metrics::changeGauge(Metrics::READY_COROUTINES, 1);
+}
+
+/**
+ * This function starts a timer that resumes the input "coroutine" at the moment "endTime".
+ */
+void CoroutineScheduler::resumeAt(Clock::time_point endTime, std::coroutine_handle<> coroutine) {
+    timers.push(Timer{endTime, timersStarted++, coroutine});
+    Metrics::changeGauge(Metrics::RUNNING_TIMERS, 1);
+}
+
+/**
+ * This function resumes the coroutines that can go on, and those of which the timer has ended, until no coroutine can
+ * go on and no timer is running anymore. The coroutines that are then still waiting for a message wait for something
+ * outside the scheduler.
+ */
+void CoroutineScheduler::run() {
+    while (!readyCoroutines.empty() || !timers.empty()) {
+        // First every coroutine that can go on, including those that were let go on by the others in the meantime
+        while (!readyCoroutines.empty()) {
+            std::coroutine_handle<> coroutine = readyCoroutines.front();
+            readyCoroutines.pop_front();
+            Metrics::changeGauge(Metrics::READY_COROUTINES, -1);
+            resumes++;
+            coroutine.resume();
+        }
+        if (timers.empty()) {
+            break;
+        }
+
+        // Then the time moves on to the end of the next timer, by waiting for it or by jumping to it
+        Clock::time_point nextEndTime = timers.top().endTime;
+        if (USE_SIMULATED_TIME) {
+            simulatedTime = std::max(simulatedTime, nextEndTime);
+        } else {
+            std::this_thread::sleep_until(nextEndTime);
+        }
+        Clock::time_point currentTime = now();
+        while (!timers.empty() && timers.top().endTime <= currentTime) {
+            readyCoroutines.push_back(timers.top().coroutine);
+            timers.pop();
+            Metrics::changeGauge(Metrics::RUNNING_TIMERS, -1);
+            Metrics::changeGauge(Metrics::READY_COROUTINES, 1);
+        }
+    }
+}
+
+/**
+ * This function returns how many times a coroutine has been resumed.
+ */
+uint64_t CoroutineScheduler::getResumes() const {
+    return resumes;
+}
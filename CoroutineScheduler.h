@@ -0,0 +1,302 @@
+/**
+ * The CoroutineScheduler class runs many coroutines (C++20) on one thread, like the rounds of many tables that each
+ * wait for their own player (see AsyncTable.h). A coroutine does not block the thread while it waits for something: it
+ * suspends with co_await, and the scheduler resumes it once that something is there. A coroutine can wait for:
+ *  - a pause, with "co_await scheduler.sleep(seconds)": it is resumed once the pause is over (a timer);
+ *  - a message, with "co_await channel.receive()": it is resumed once a message has been sent into the Channel, for
+ *    example the decision of a player.
+ * A coroutine can also wait for another coroutine, a SubTask, like a function call that may wait in between: the round
+ * of a game waits for the bet of the player in requestBetAmount(), which waits for the answer (see Blackjack.h).
+ * The scheduler keeps the coroutines that can go on in a queue and the running timers in a heap ordered by the moment
+ * they end, and run() resumes them one after the other. A waiting coroutine only takes the memory of its frame (its
+ * local variables), instead of a whole thread with its stack, so thousands of rounds can wait at the same time.
+ *
+ * The scheduler either runs on the real time, in which case run() sleeps until the next timer ends when no coroutine
+ * can go on, or on a simulated time, which jumps straight to the end of the next timer. With the simulated time, the
+ * pauses are kept in the order of the rounds (which table goes first), but nobody waits for them (like the
+ * ZeroDelayPacer, see Pacer.h).
+ */
+
+#ifndef PIE_CPP_BLACKJACK_COROUTINESCHEDULER_H
+#define PIE_CPP_BLACKJACK_COROUTINESCHEDULER_H
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::vector;
+
+// A coroutine run by the CoroutineScheduler. It starts running as soon as it is called, until it waits for the first
+// time. Its frame is destroyed together with the Task, so the Task must outlive everything the coroutine waits for
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; } // keeps the frame, so isDone() can be asked
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Task(std::coroutine_handle<promise_type> handle_) : handle(handle_) {}
+
+public:
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    Task &operator=(Task &&) = delete;
+
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    /**
+     * This function returns true if the coroutine has finished.
+     */
+    bool isDone() const { return !handle || handle.done(); }
+};
+
+// Keeps the result of a SubTask until the awaiting coroutine takes it
+template<typename T>
+struct SubTaskResult {
+    std::optional<T> result;
+
+    void return_value(T value) { result = std::move(value); }
+    T takeResult() { return std::move(*result); }
+};
+
+template<>
+struct SubTaskResult<void> {
+    void return_void() {}
+    void takeResult() {}
+};
+
+// A coroutine that another coroutine waits for with co_await, and that returns a T (or nothing). It only starts when it
+// is awaited, and runs on the thread of the awaiting coroutine. If it finishes without waiting for anything, the
+// awaiting coroutine simply goes on, so a whole game that never has to wait (see Blackjack::launchGame()) runs like
+// ordinary function calls. Otherwise, the awaiting coroutine is resumed as soon as the SubTask is done
+template<typename T = void>
+class SubTask {
+public:
+    struct promise_type;
+
+private:
+    // What a finished SubTask waits for: it goes on with the awaiting coroutine, unless that one is still starting it
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept {
+            promise_type &promise = coroutine.promise();
+            if (promise.isStarting || !promise.continuation) {
+                return std::noop_coroutine();
+            }
+            return promise.continuation;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+public:
+    struct promise_type : SubTaskResult<T> {
+        std::coroutine_handle<> continuation; // the awaiting coroutine
+        bool isStarting = false;              // the awaiting coroutine is running this one until it first waits
+
+        SubTask get_return_object() { return SubTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit SubTask(std::coroutine_handle<promise_type> handle_) : handle(handle_) {}
+
+public:
+    SubTask(SubTask &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    SubTask(const SubTask &) = delete;
+    SubTask &operator=(const SubTask &) = delete;
+    SubTask &operator=(SubTask &&) = delete;
+
+    ~SubTask() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    /**
+     * This function runs the SubTask until it finishes or first waits, and returns false if it has finished, so the
+     * awaiting coroutine goes on straight away instead of being resumed later.
+     */
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+        promise_type &promise = handle.promise();
+        promise.continuation = awaiting;
+        promise.isStarting = true;
+        handle.resume();
+        promise.isStarting = false;
+        return !handle.done();
+    }
+
+    T await_resume() { return handle.promise().takeResult(); }
+
+    /**
+     * This function runs the SubTask to its end on the calling thread, without a coroutine awaiting it. Everything it
+     * waits for must already be there, as nothing would resume it.
+     */
+    void runToEnd() {
+        handle.resume();
+        if (!handle.done()) {
+            std::terminate();
+        }
+    }
+};
+
+class CoroutineScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Timer {
+        Clock::time_point endTime;
+        uint64_t number; // timers that end at the same moment resume in the order in which they were started
+        std::coroutine_handle<> coroutine;
+
+        bool operator>(const Timer &other) const {
+            return endTime != other.endTime ? endTime > other.endTime : number > other.number;
+        }
+    };
+
+    const bool USE_SIMULATED_TIME;
+    const Clock::time_point START_TIME;
+    Clock::time_point simulatedTime;
+
+    std::deque<std::coroutine_handle<>> readyCoroutines;
+    std::priority_queue<Timer, vector<Timer>, std::greater<Timer>> timers;
+    uint64_t timersStarted = 0;
+    uint64_t resumes = 0;
+
+public:
+    // What "co_await scheduler.sleep(seconds)" waits for
+    struct SleepAwaiter {
+        CoroutineScheduler &scheduler;
+        Clock::duration duration;
+
+        bool await_ready() const { return duration <= Clock::duration::zero(); }
+
+        void await_suspend(std::coroutine_handle<> coroutine) {
+            scheduler.resumeAt(scheduler.now() + duration, coroutine);
+        }
+
+        void await_resume() const {}
+    };
+
+    /**
+     * Constructor for a scheduler without coroutines. It runs on a simulated time if "useSimulatedTime" is true, and
+     * on the real time otherwise (see the description at the top of this file).
+     */
+    explicit CoroutineScheduler(bool useSimulatedTime);
+
+    /**
+     * This function returns the current time of the scheduler.
+     */
+    Clock::time_point now() const;
+
+    /**
+     * This function returns the amount of seconds that have passed on the time of the scheduler since it was created.
+     */
+    double getElapsedSeconds() const;
+
+    /**
+     * This function returns something a coroutine can co_await to pause for "seconds" seconds.
+     */
+    SleepAwaiter sleep(double seconds);
+
+    /**
+     * This function puts the input "coroutine" in the queue of coroutines that can go on, for example because the
+     * message it waits for has arrived.
+     */
+    void resumeSoon(std::coroutine_handle<> coroutine);
+
+    /**
+     * This function starts a timer that resumes the input "coroutine" at the moment "endTime".
+     */
+    void resumeAt(Clock::time_point endTime, std::coroutine_handle<> coroutine);
+
+    /**
+     * This function resumes the coroutines that can go on, and those of which the timer has ended, until no coroutine
+     * can go on and no timer is running anymore. The coroutines that are then still waiting for a message wait for
+     * something outside the scheduler.
+     */
+    void run();
+
+    /**
+     * This function returns how many times a coroutine has been resumed.
+     */
+    uint64_t getResumes() const;
+};
+
+// A queue of messages of type T to a coroutine on the same scheduler. One coroutine at a time waits for the next
+// message with "co_await channel.receive()". Sending a message never waits
+template<typename T>
+class Channel {
+private:
+    CoroutineScheduler &scheduler;
+    std::deque<T> messages;
+    std::coroutine_handle<> receiver; // the coroutine waiting for a message, if any
+
+public:
+    // What "co_await channel.receive()" waits for
+    struct ReceiveAwaiter {
+        Channel &channel;
+
+        bool await_ready() const { return !channel.messages.empty(); }
+        void await_suspend(std::coroutine_handle<> coroutine) { channel.receiver = coroutine; }
+
+        T await_resume() {
+            T message = std::move(channel.messages.front());
+            channel.messages.pop_front();
+            return message;
+        }
+    };
+
+    /**
+     * Constructor for an empty channel, of which the receiver is resumed by the input "scheduler_". The scheduler is
+     * not copied, so it must outlive the channel.
+     */
+    explicit Channel(CoroutineScheduler &scheduler_) : scheduler(scheduler_) {}
+
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+    /**
+     * This function returns something a coroutine can co_await to receive the next message.
+     */
+    ReceiveAwaiter receive() { return ReceiveAwaiter{*this}; }
+
+    /**
+     * This function adds the input "message" to the end of the queue, and lets the receiver go on if it was waiting.
+     */
+    void send(T message) {
+        messages.push_back(std::move(message));
+        if (receiver) {
+            scheduler.resumeSoon(std::exchange(receiver, nullptr));
+        }
+    }
+};
+
+
+#endif //PIE_CPP_BLACKJACK_COROUTINESCHEDULER_H
@@ -0,0 +1,46 @@
+/**
+ * The DealerTable class describes how the dealer's hand ends on an infinite deck, for every open card of the dealer.
+ * With an infinite deck every rank has the same chance on every draw, so the dealer's draws (hitting as long as the
+ * sum is below 17, see RoundSimulator::standAndSettle()) only depend on the open card. The chance of every final total
+ * can therefore be calculated once, and a simulation can pick the dealer's final total with a single random number
+ * instead of drawing card after card.
+ *
+ * The tables are calculated by the compiler (constexpr), so the program does not spend any time on them at startup:
+ *  1. for every state of the dealer's hand (the sum with every Ace counted as 1, and whether there is an Ace) the
+ *     chance of every final total is calculated, starting with the highest sums. Every card makes this sum higher, so
+ *     the states that can follow a state have always been calculated before it;
+ *  2. for every open card, one more card is drawn. Two cards with a sum of 21 are a blackjack;
+ *  3. the chances of every open card are turned into an alias table (Walker's alias method, as built by Vose): every
+ *     column of the table holds one final total with a threshold, and an alias for the rest of the column. Sampling
+ *     picks a column and compares with its threshold, both with the same 32-bit random number.
+ *
+ * There are 7 final totals: 17, 18, 19, 20 and 21 in three or more cards, a blackjack and a bust.
+ */
+
+#include "DealerTable.h"
+
+/**
+ * This function checks at compile time that the chances of the final totals add up to 1 for every dealer card value.
+ */
+static constexpr bool distributionsAddUpToOne() {
+    for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+        double total = 0;
+        for (int final = 0; final < DealerTable::AMOUNT_OF_FINAL_TOTALS; ++final) {
+            total += DealerTable::DISTRIBUTIONS.probabilities[dealerCardValue][final];
+        }
+        if (total < 1 - 1e-12 || total > 1 + 1e-12) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(distributionsAddUpToOne(), "The chances of the dealer's final totals do not add up to 1");
+
+/**
+ * This function returns the chance that the dealer ends with the input final total "final" (an index into
+ * FINAL_SUMS) when their open card has the game value "dealerCardValue" (2-11).
+ */
+double DealerTable::getProbability(int dealerCardValue, int final) {
+    return DISTRIBUTIONS.probabilities[dealerCardValue][final];
+}
@@ -0,0 +1,195 @@
+/**
+ * The DealerTable class describes how the dealer's hand ends on an infinite deck, for every open card of the dealer.
+ * With an infinite deck every rank has the same chance on every draw, so the dealer's draws (hitting as long as the
+ * sum is below 17, see RoundSimulator::standAndSettle()) only depend on the open card. The chance of every final total
+ * can therefore be calculated once, and a simulation can pick the dealer's final total with a single random number
+ * instead of drawing card after card.
+ *
+ * The tables are calculated by the compiler (constexpr), so the program does not spend any time on them at startup:
+ *  1. for every state of the dealer's hand (the sum with every Ace counted as 1, and whether there is an Ace) the
+ *     chance of every final total is calculated, starting with the highest sums. Every card makes this sum higher, so
+ *     the states that can follow a state have always been calculated before it;
+ *  2. for every open card, one more card is drawn. Two cards with a sum of 21 are a blackjack;
+ *  3. the chances of every open card are turned into an alias table (Walker's alias method, as built by Vose): every
+ *     column of the table holds one final total with a threshold, and an alias for the rest of the column. Sampling
+ *     picks a column and compares with its threshold, both with the same 32-bit random number.
+ *
+ * There are 7 final totals: 17, 18, 19, 20 and 21 in three or more cards, a blackjack and a bust.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_DEALERTABLE_H
+#define PIE_CPP_BLACKJACK_DEALERTABLE_H
+
+#include <cstdint>
+
+class DealerTable {
+public:
+    static const int AMOUNT_OF_FINAL_TOTALS = 7;
+    static const int FINAL_BLACKJACK = 5;
+    static const int FINAL_BUST = 6;
+
+    // The optimal sum and the card count of every final total, as Blackjack::determineOutcome() expects them. Only
+    // whether the dealer has exactly 2 cards matters there, so 3 stands for "3 or more cards"
+    static constexpr int FINAL_SUMS[AMOUNT_OF_FINAL_TOTALS] = {17, 18, 19, 20, 21, 21, 22};
+    static constexpr int FINAL_CARD_COUNTS[AMOUNT_OF_FINAL_TOTALS] = {3, 3, 3, 3, 3, 2, 3};
+
+    struct Distributions {
+        // probabilities[dealer card value][final total], for the dealer card values 2-11 (an Ace is 11)
+        double probabilities[12][AMOUNT_OF_FINAL_TOTALS] = {};
+    };
+
+    struct AliasTable {
+        // A column is picked with a chance of 1/7 and gives its own final total if the random fraction is below the
+        // threshold (a fraction of 2^32), and its alias otherwise
+        uint64_t thresholds[AMOUNT_OF_FINAL_TOTALS] = {};
+        uint8_t aliases[AMOUNT_OF_FINAL_TOTALS] = {};
+    };
+
+    /**
+     * This function calculates the chance of every final total of the dealer for every dealer card value (2-11) on an
+     * infinite deck, see the description at the top of this file.
+     */
+    static constexpr Distributions calculateDistributions() {
+        // The chance of drawing a card with the game value 1 (an Ace) to 10: the 10 has 4 ranks (10, J, Q, K)
+        double cardChances[11] = {};
+        for (int value = 1; value <= 10; ++value) {
+            cardChances[value] = value == 10 ? 4.0 / 13.0 : 1.0 / 13.0;
+        }
+
+        // 1. fromState[hard sum][has an Ace][final total], where the hard sum counts every Ace as 1. The dealer draws
+        // from a hard sum of at most 16, so the highest reachable hard sum is 26
+        double fromState[27][2][AMOUNT_OF_FINAL_TOTALS] = {};
+        for (int hardSum = 26; hardSum >= 2; --hardSum) {
+            for (int hasAce = 0; hasAce <= 1; ++hasAce) {
+                int sum = hasAce == 1 && hardSum + 10 <= 21 ? hardSum + 10 : hardSum;
+                if (sum > 21) {
+                    fromState[hardSum][hasAce][FINAL_BUST] = 1;
+                } else if (sum >= 17) {
+                    fromState[hardSum][hasAce][sum - 17] = 1;
+                } else {
+                    for (int value = 1; value <= 10; ++value) {
+                        int nextHasAce = value == 1 ? 1 : hasAce;
+                        for (int final = 0; final < AMOUNT_OF_FINAL_TOTALS; ++final) {
+                            fromState[hardSum][hasAce][final] +=
+                                    cardChances[value] * fromState[hardSum + value][nextHasAce][final];
+                        }
+                    }
+                }
+            }
+        }
+
+        // 2. The open card and the second card of the dealer
+        Distributions distributions;
+        for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+            int openHardSum = dealerCardValue == 11 ? 1 : dealerCardValue;
+            for (int value = 1; value <= 10; ++value) {
+                int hardSum = openHardSum + value;
+                int hasAce = dealerCardValue == 11 || value == 1 ? 1 : 0;
+                if (hasAce == 1 && hardSum == 11) {
+                    distributions.probabilities[dealerCardValue][FINAL_BLACKJACK] += cardChances[value];
+                    continue;
+                }
+                for (int final = 0; final < AMOUNT_OF_FINAL_TOTALS; ++final) {
+                    distributions.probabilities[dealerCardValue][final] +=
+                            cardChances[value] * fromState[hardSum][hasAce][final];
+                }
+            }
+        }
+        return distributions;
+    }
+
+    /**
+     * This function builds the alias table of the input "probabilities" of the final totals with the method of Vose:
+     * columns that are too small for their chance are filled up with a column that is too large.
+     */
+    static constexpr AliasTable buildAliasTable(const double (&probabilities)[AMOUNT_OF_FINAL_TOTALS]) {
+        double scaled[AMOUNT_OF_FINAL_TOTALS] = {};
+        int small[AMOUNT_OF_FINAL_TOTALS] = {};
+        int large[AMOUNT_OF_FINAL_TOTALS] = {};
+        int amountSmall = 0;
+        int amountLarge = 0;
+        for (int final = 0; final < AMOUNT_OF_FINAL_TOTALS; ++final) {
+            scaled[final] = probabilities[final] * AMOUNT_OF_FINAL_TOTALS;
+            if (scaled[final] < 1) {
+                small[amountSmall++] = final;
+            } else {
+                large[amountLarge++] = final;
+            }
+        }
+
+        AliasTable table;
+        while (amountSmall > 0 && amountLarge > 0) {
+            int column = small[--amountSmall];
+            int alias = large[--amountLarge];
+            table.thresholds[column] = (uint64_t) (scaled[column] * 4294967296.0);
+            table.aliases[column] = (uint8_t) alias;
+            // The large column gives away what the small column lacks
+            scaled[alias] -= 1 - scaled[column];
+            if (scaled[alias] < 1) {
+                small[amountSmall++] = alias;
+            } else {
+                large[amountLarge++] = alias;
+            }
+        }
+
+        // What is left over is full up to rounding errors, so these columns always give their own final total
+        while (amountSmall > 0) {
+            int column = small[--amountSmall];
+            table.thresholds[column] = 4294967296ULL;
+            table.aliases[column] = (uint8_t) column;
+        }
+        while (amountLarge > 0) {
+            int column = large[--amountLarge];
+            table.thresholds[column] = 4294967296ULL;
+            table.aliases[column] = (uint8_t) column;
+        }
+        return table;
+    }
+
+    struct AliasTables {
+        AliasTable ofDealerCardValue[12]; // for the dealer card values 2-11
+    };
+
+    /**
+     * This function builds the alias tables of all dealer card values (2-11) from the input "distributions".
+     */
+    static constexpr AliasTables buildAliasTables(const Distributions &distributions) {
+        AliasTables tables;
+        for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+            tables.ofDealerCardValue[dealerCardValue] = buildAliasTable(distributions.probabilities[dealerCardValue]);
+        }
+        return tables;
+    }
+
+    // Both tables are defined below the class, as the compiler can only run the functions above once the class is
+    // complete
+    static const Distributions DISTRIBUTIONS;
+    static const AliasTables ALIAS_TABLES;
+
+    /**
+     * This function picks the final total of the dealer (an index into FINAL_SUMS and FINAL_CARD_COUNTS) for the input
+     * "dealerCardValue" (2-11), using the input "randomBits" as a uniformly distributed 32-bit random number. It is
+     * constexpr (and therefore inline), so simulations can use it in their innermost loops.
+     */
+    static constexpr int sampleFinalTotal(int dealerCardValue, uint32_t randomBits) {
+        const AliasTable &table = ALIAS_TABLES.ofDealerCardValue[dealerCardValue];
+        // Multiplying by 7 gives the column in the upper 32 bits and a uniform fraction in the lower 32 bits
+        uint64_t scaledBits = (uint64_t) randomBits * AMOUNT_OF_FINAL_TOTALS;
+        int column = (int) (scaledBits >> 32);
+        uint64_t fraction = (uint32_t) scaledBits;
+        return fraction < table.thresholds[column] ? column : table.aliases[column];
+    }
+
+    /**
+     * This function returns the chance that the dealer ends with the input final total "final" (an index into
+     * FINAL_SUMS) when their open card has the game value "dealerCardValue" (2-11).
+     */
+    static double getProbability(int dealerCardValue, int final);
+};
+
+inline constexpr DealerTable::Distributions DealerTable::DISTRIBUTIONS = DealerTable::calculateDistributions();
+inline constexpr DealerTable::AliasTables DealerTable::ALIAS_TABLES =
+        DealerTable::buildAliasTables(DealerTable::DISTRIBUTIONS);
+
+
+#endif //PIE_CPP_BLACKJACK_DEALERTABLE_H
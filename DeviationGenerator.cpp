@@ -0,0 +1,239 @@
+/**
+ * The DeviationGenerator class finds the index plays of a card counting player: the true counts at which the best
+ * decision for a hand changes. Basic strategy (see BasicStrategyPolicy) gives the best decision when nothing is known
+ * about the remaining cards, but with many tens left in the shoe (a high count) standing on a stiff hand becomes
+ * better, and with many low cards left hitting becomes better.
+ *
+ * The generator plays many rounds from a Shoe with basic strategy, using the same rules as Blackjack::playRound() (see
+ * RoundSimulator). Every time the player has to decide on a hard total of 12-16, both hitting and standing are played
+ * out on exactly the same upcoming cards of the shoe (see ShoeLookahead), after which the round continues as normal.
+ * The difference between the two outcomes is added to the bucket of the true count at that moment, per player total
+ * and dealer card. Because both decisions see the same cards, the difference has a much smaller variance than two
+ * separate simulations would have.
+ *
+ * For every total and dealer card, the index is the true count at which the average difference changes sign, found
+ * by linear interpolation between the two buckets around the sign change. The rounds are played in blocks that are
+ * spread over all cores, and every block has its own shoe seeded with its block number. The differences are always
+ * multiples of half a bet, so they are added up exactly as whole numbers of half bets, which makes the table
+ * independent of the amount of threads.
+ */
+
+#include "DeviationGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "BankrollSimulator.h"
+#include "RoundSimulator.h"
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cout, std::endl, std::setw, std::fixed, std::setprecision, std::showpos, std::noshowpos;
+
+/**
+ * This function returns the position of the bucket for the input player "total" (12-16), "dealerCardValue" (2-11)
+ * and true count "bucket" (0 is the lowest true count) in a vector of buckets.
+ */
+int DeviationGenerator::bucketIndex(int total, int dealerCardValue, int bucket) {
+    return ((total - LOWEST_TOTAL) * 10 + (dealerCardValue - 2)) * AMOUNT_OF_BUCKETS + bucket;
+}
+
+/**
+ * Constructor for a DeviationGenerator with the input "settings_".
+ */
+DeviationGenerator::DeviationGenerator(const DeviationSettings &settings_)
+        : settings(settings_), buckets((HIGHEST_TOTAL - LOWEST_TOTAL + 1) * 10 * AMOUNT_OF_BUCKETS) {}
+
+/**
+ * This function plays the rounds of block number "block" with a shoe seeded with the block number, and adds the
+ * sampled decisions to the input "blockBuckets".
+ */
+void DeviationGenerator::simulateBlock(long long block, vector<DeviationBucket> &blockBuckets) {
+    Shoe shoe(settings.amountOfDecks, settings.penetration, settings.seed + block);
+    shoe.setCountingSystem(settings.countingSystem);
+    SamplingPolicy policy(shoe, blockBuckets);
+    RoundSimulator simulator(shoe, policy);
+    simulator.setHoleCardRule(settings.holeCardRule);
+    policy.playAgainstDealerOf(simulator);
+
+    long long roundsInBlock = std::min((long long) ROUNDS_PER_BLOCK, settings.rounds - block * ROUNDS_PER_BLOCK);
+    for (long long round = 0; round < roundsInBlock; ++round) {
+        simulator.playRound();
+    }
+}
+
+/**
+ * This function plays all rounds, spread over the threads, and merges the sampled decisions.
+ */
+void DeviationGenerator::run() {
+    auto startTime = std::chrono::steady_clock::now();
+
+    int amountOfThreads = settings.threads;
+    if (amountOfThreads <= 0) {
+        amountOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    long long amountOfBlocks = (settings.rounds + ROUNDS_PER_BLOCK - 1) / ROUNDS_PER_BLOCK;
+
+    // The threads take the next block that has not been played yet, and every thread has its own buckets
+    std::atomic<long long> nextBlock(0);
+    vector<vector<DeviationBucket>> threadBuckets(amountOfThreads, vector<DeviationBucket>(buckets.size()));
+    vector<std::thread> threads;
+    for (int t = 0; t < amountOfThreads; ++t) {
+        threads.emplace_back([this, t, amountOfBlocks, &nextBlock, &threadBuckets]() {
+            for (long long block = nextBlock++; block < amountOfBlocks; block = nextBlock++) {
+                simulateBlock(block, threadBuckets[t]);
+            }
+        });
+    }
+
+    for (int t = 0; t < amountOfThreads; ++t) {
+        threads[t].join();
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            buckets[i].samples += threadBuckets[t][i].samples;
+            buckets[i].sumOfHalfBetDifferences += threadBuckets[t][i].sumOfHalfBetDifferences;
+        }
+    }
+
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * This function returns the index of the input player "total" against "dealerCardValue": the true count at which
+ * hitting and standing are equally good. If one decision is better at all sampled counts, "alwaysHit" or
+ * "alwaysStand" is set instead. If there are not enough samples, false is returned.
+ */
+bool DeviationGenerator::findIndex(int total, int dealerCardValue, double &index, bool &alwaysHit,
+                                   bool &alwaysStand) {
+    alwaysHit = false;
+    alwaysStand = false;
+
+    bool hasPreviousBucket = false;
+    double previousTrueCount = 0;
+    double previousDifference = 0;
+    bool hitWasBetterSomewhere = false;
+    bool standWasBetterSomewhere = false;
+
+    for (int bucket = 0; bucket < AMOUNT_OF_BUCKETS; ++bucket) {
+        DeviationBucket &statistics = buckets[bucketIndex(total, dealerCardValue, bucket)];
+        if (statistics.samples < (uint64_t) MINIMUM_SAMPLES_PER_BUCKET) {
+            continue;
+        }
+
+        // The average gain of hitting instead of standing, in bets
+        double difference = 0.5 * statistics.sumOfHalfBetDifferences / statistics.samples;
+        double trueCount = LOWEST_TRUE_COUNT + bucket;
+        hitWasBetterSomewhere = hitWasBetterSomewhere || difference > 0;
+        standWasBetterSomewhere = standWasBetterSomewhere || difference <= 0;
+
+        // Interpolating linearly between the two buckets where the best decision changes from hitting to standing
+        if (hasPreviousBucket && previousDifference > 0 && difference <= 0) {
+            index = previousTrueCount + previousDifference * (trueCount - previousTrueCount) /
+                                        (previousDifference - difference);
+            return true;
+        }
+        hasPreviousBucket = true;
+        previousTrueCount = trueCount;
+        previousDifference = difference;
+    }
+
+    if (!hasPreviousBucket) {
+        return false;
+    }
+    alwaysHit = hitWasBetterSomewhere && !standWasBetterSomewhere;
+    alwaysStand = !alwaysHit;
+    return true;
+}
+
+/**
+ * This function prints the table of indices to the console, with a row per player total and a column per dealer
+ * card. A number means: stand at this true count or higher and hit below it. "H" and "S" mean always hit or always
+ * stand within the sampled counts, "-" means there were not enough samples.
+ */
+void DeviationGenerator::printTable() {
+    cout << "Index plays (" << CardCounter::getName(settings.countingSystem) << ", " << settings.amountOfDecks
+         << " decks, " << settings.rounds << " rounds in " << elapsedSeconds << " s)" << endl;
+    cout << "Stand at or above the shown true count, hit below it" << endl << endl;
+
+    cout << "Hard ";
+    for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+        cout << setw(7) << (dealerCardValue == 11 ? string("A") : std::to_string(dealerCardValue));
+    }
+    cout << endl;
+
+    for (int total = LOWEST_TOTAL; total <= HIGHEST_TOTAL; ++total) {
+        cout << setw(4) << total << " ";
+        for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+            double index = 0;
+            bool alwaysHit = false;
+            bool alwaysStand = false;
+            if (!findIndex(total, dealerCardValue, index, alwaysHit, alwaysStand)) {
+                cout << setw(7) << "-";
+            } else if (alwaysHit) {
+                cout << setw(7) << "H";
+            } else if (alwaysStand) {
+                cout << setw(7) << "S";
+            } else {
+                cout << setw(7) << fixed << setprecision(1) << showpos << index << noshowpos;
+            }
+        }
+        cout << endl;
+    }
+}
+
+/**
+ * Constructor for a SamplingPolicy that looks ahead in the input "shoe_" and records into the input "buckets_".
+ */
+SamplingPolicy::SamplingPolicy(Shoe &shoe_, vector<DeviationBucket> &buckets_) : shoe(shoe_), buckets(buckets_) {}
+
+/**
+ * This function makes the policy play out both decisions against the dealer's hand of the input "simulator_", including
+ * the hole card, which the player does not know but which is already out of the shoe. The simulator is not copied, so
+ * it must outlive the policy.
+ */
+void SamplingPolicy::playAgainstDealerOf(const RoundSimulator &simulator_) {
+    simulator = &simulator_;
+}
+
+/**
+ * This function samples the decision if it is on a hard total of 12-16, and returns the basic strategy decision.
+ */
+bool SamplingPolicy::shouldHit(int playerSum, bool isSoft, int dealerCardValue, double trueCount) {
+    if (!isSoft && playerSum >= DeviationGenerator::LOWEST_TOTAL && playerSum <= DeviationGenerator::HIGHEST_TOTAL) {
+        // A hard hand only needs its sum (all Aces already count as 1), and with 3 cards it can never be a blackjack
+        SimulatedHand playerHand;
+        playerHand.sumOfGameValues = playerSum;
+        playerHand.cardCount = 3;
+        // The dealer's hand as it lies on the table. Without a simulator, the hole card is played out from the shoe
+        SimulatedHand dealerHand;
+        if (simulator != nullptr) {
+            dealerHand = simulator->getDealerHand();
+        } else {
+            dealerHand.sumOfGameValues = dealerCardValue;
+            dealerHand.numberOfAces = dealerCardValue == 11 ? 1 : 0;
+            dealerHand.cardCount = 1;
+            dealerHand.firstCardValue = dealerCardValue;
+        }
+
+        // Standing and hitting (followed by basic strategy) are played out on the same upcoming cards
+        ShoeLookahead standCards(shoe);
+        RoundOutcome standOutcome = RoundSimulator::standAndSettle(playerHand, dealerHand, standCards);
+
+        ShoeLookahead hitCards(shoe);
+        SimulatedHand hitHand = playerHand;
+        hitHand.addRank(hitCards.drawRank());
+        RoundOutcome hitOutcome = RoundSimulator::finishRound(hitHand, dealerHand, hitCards, basicStrategy);
+
+        int bucket = (int) std::lround(trueCount) - DeviationGenerator::LOWEST_TRUE_COUNT;
+        bucket = std::max(0, std::min(bucket, DeviationGenerator::AMOUNT_OF_BUCKETS - 1));
+        DeviationBucket &statistics = buckets[DeviationGenerator::bucketIndex(playerSum, dealerCardValue, bucket)];
+        statistics.samples++;
+        statistics.sumOfHalfBetDifferences += (int64_t) std::lround(
+                2 * (BankrollSimulator::winFactor(hitOutcome) - BankrollSimulator::winFactor(standOutcome)));
+    }
+
+    return basicStrategy.shouldHit(playerSum, isSoft, dealerCardValue, trueCount);
+}
@@ -0,0 +1,136 @@
+/**
+ * The DeviationGenerator class finds the index plays of a card counting player: the true counts at which the best
+ * decision for a hand changes. Basic strategy (see BasicStrategyPolicy) gives the best decision when nothing is known
+ * about the remaining cards, but with many tens left in the shoe (a high count) standing on a stiff hand becomes
+ * better, and with many low cards left hitting becomes better.
+ *
+ * The generator plays many rounds from a Shoe with basic strategy, using the same rules as Blackjack::playRound() (see
+ * RoundSimulator). Every time the player has to decide on a hard total of 12-16, both hitting and standing are played
+ * out on exactly the same upcoming cards of the shoe (see ShoeLookahead), after which the round continues as normal.
+ * The difference between the two outcomes is added to the bucket of the true count at that moment, per player total
+ * and dealer card. Because both decisions see the same cards, the difference has a much smaller variance than two
+ * separate simulations would have.
+ *
+ * For every total and dealer card, the index is the true count at which the average difference changes sign, found
+ * by linear interpolation between the two buckets around the sign change. The rounds are played in blocks that are
+ * spread over all cores, and every block has its own shoe seeded with its block number. The differences are always
+ * multiples of half a bet, so they are added up exactly as whole numbers of half bets, which makes the table
+ * independent of the amount of threads.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_DEVIATIONGENERATOR_H
+#define PIE_CPP_BLACKJACK_DEVIATIONGENERATOR_H
+
+#include <cstdint>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::vector;
+
+#include "CardCounter.h"
+#include "PlayerPolicy.h"
+#include "RoundSimulator.h"
+#include "Shoe.h"
+
+struct DeviationSettings {
+    int amountOfDecks = 6;
+    double penetration = 0.75;
+    long long rounds = 20000000;
+    int threads = 0; // 0 uses all cores of the computer
+    uint64_t seed = 1;
+    CountingSystem countingSystem = CountingSystem::HI_LO;
+    HoleCardRule holeCardRule = HoleCardRule::PEEK;
+};
+
+// The amount of times a decision was sampled in a true count bucket, and the sum of the differences between hitting
+// and standing in half bets
+struct DeviationBucket {
+    uint64_t samples = 0;
+    int64_t sumOfHalfBetDifferences = 0;
+};
+
+class DeviationGenerator {
+public:
+    static const int LOWEST_TOTAL = 12;
+    static const int HIGHEST_TOTAL = 16;
+    static const int LOWEST_TRUE_COUNT = -10;
+    static const int HIGHEST_TRUE_COUNT = 10;
+    static const int AMOUNT_OF_BUCKETS = HIGHEST_TRUE_COUNT - LOWEST_TRUE_COUNT + 1;
+
+    /**
+     * This function returns the position of the bucket for the input player "total" (12-16), "dealerCardValue" (2-11)
+     * and true count "bucket" (0 is the lowest true count) in a vector of buckets.
+     */
+    static int bucketIndex(int total, int dealerCardValue, int bucket);
+
+private:
+    const int ROUNDS_PER_BLOCK = 100000;
+    const int MINIMUM_SAMPLES_PER_BUCKET = 500;
+
+    DeviationSettings settings;
+    vector<DeviationBucket> buckets;
+    double elapsedSeconds = 0;
+
+    /**
+     * This function plays the rounds of block number "block" with a shoe seeded with the block number, and adds the
+     * sampled decisions to the input "blockBuckets".
+     */
+    void simulateBlock(long long block, vector<DeviationBucket> &blockBuckets);
+
+    /**
+     * This function returns the index of the input player "total" against "dealerCardValue": the true count at which
+     * hitting and standing are equally good. If one decision is better at all sampled counts, "alwaysHit" or
+     * "alwaysStand" is set instead. If there are not enough samples, false is returned.
+     */
+    bool findIndex(int total, int dealerCardValue, double &index, bool &alwaysHit, bool &alwaysStand);
+
+public:
+    /**
+     * Constructor for a DeviationGenerator with the input "settings_".
+     */
+    explicit DeviationGenerator(const DeviationSettings &settings_);
+
+    /**
+     * This function plays all rounds, spread over the threads, and merges the sampled decisions.
+     */
+    void run();
+
+    /**
+     * This function prints the table of indices to the console, with a row per player total and a column per dealer
+     * card. A number means: stand at this true count or higher and hit below it. "H" and "S" mean always hit or always
+     * stand within the sampled counts, "-" means there were not enough samples.
+     */
+    void printTable();
+};
+
+/**
+ * The SamplingPolicy class plays basic strategy, but every time it is asked for a decision on a hard total of 12-16
+ * it first plays out both hitting and standing on the upcoming cards of the shoe and records the difference.
+ */
+class SamplingPolicy : public PlayerPolicy {
+private:
+    Shoe &shoe;
+    vector<DeviationBucket> &buckets;
+    BasicStrategyPolicy basicStrategy;
+    const RoundSimulator *simulator = nullptr; // the simulator whose dealer's hand is played out
+
+public:
+    /**
+     * Constructor for a SamplingPolicy that looks ahead in the input "shoe_" and records into the input "buckets_".
+     */
+    SamplingPolicy(Shoe &shoe_, vector<DeviationBucket> &buckets_);
+
+    /**
+     * This function makes the policy play out both decisions against the dealer's hand of the input "simulator_",
+     * including the hole card, which the player does not know but which is already out of the shoe. The simulator is
+     * not copied, so it must outlive the policy.
+     */
+    void playAgainstDealerOf(const RoundSimulator &simulator_);
+
+    /**
+     * This function samples the decision if it is on a hard total of 12-16, and returns the basic strategy decision.
+     */
+    bool shouldHit(int playerSum, bool isSoft, int dealerCardValue, double trueCount) override;
+};
+
+
+#endif //PIE_CPP_BLACKJACK_DEVIATIONGENERATOR_H
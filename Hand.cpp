@@ -8,143 +8,32 @@
  */
 
 #include <iostream>
-#include <iomanip>
 #include <vector>
 #include <string>
 
 // Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
-using std::cout, std::endl, std::cerr, std::cin, std::vector, std::string, std::left, std::right, std::to_string,
-        std::setw, std::stoi;
-
-// A little "library" by Vincent Godin that allows the use of color in cout:
-// https://www.codeproject.com/Articles/16431/Add-color-to-your-std-cout
-// From the .h file, we can see that the available colors are blue, red, green, yellow and white
-#include "ConsoleColor.h"
+using std::cout, std::vector, std::string;
 
+#include "CardGlyphs.h"
 #include "Hand.h"
 
 /**
- * This function is responsible for printing the horizontal border(s) of the graphical representations of a Card or
- * multiple cards. These are found at the top and bottom of a card. As input, it takes a vector of cards to be printed
- * and it then prints a border for every card in this vector.
- *
- * For example if 3 cards are to be printed, the output looks like this:
- * "+----------+    +----------+    +----------+"
- */
-void Hand::printHorizontalCardBorders(const vector<Card> cardsToPrint) {
-    // Printing the top borders
-    for (Card cardToPrint: cardsToPrint) {
-        cout << "+----------+" << '\t';
-    }
-    cout << endl;
-}
-
-/**
- * This function is responsible for printing the empty row(s) of the graphical representations of a Card or multiple
- * cards. These are found in the middle of a card. As input, it takes a vector of cards to be printed and it then
- * prints an empty row for every card in this vector.
- *
- * For example if 3 cards are to be printed, the output looks like this:
- * "|          |    |          |    |          |"
+ * This function adds the cards of the input "cardsInRow" next to each other to the end of the input "frame", line
+ * by line. Every line of a card is copied from its glyph in the CardGlyphs atlas, followed by a tab.
  */
-void Hand::printEmptyCardRow(const vector<Card> cardsToPrint) {
-    for (Card cardToPrint: cardsToPrint) {
-        cout << "|          |" << '\t';
+void Hand::appendRowOfCards(string &frame, const vector<Card> &cardsInRow) {
+    vector<int> glyphIndices;
+    for (Card cardInRow: cardsInRow) {
+        glyphIndices.push_back(cardInRow.getGlyphIndex());
     }
-    cout << endl;
-}
 
-/**
- * This function is responsible for printing the value row(s) of the graphical representations of a Card or
- * multiple cards. These are found on the top left and bottom right of a card. As input, it takes a vector of cards
- * to be printed and the alignment of the value on the card. The alignment input can be "left" or "right". It then
- * prints a value row for every card in this vector, taking into consideration the desired alignment of the value on
- * the card.
- *
- * For example, 3 cards with left alignment could result in this output:
- * "| A        |    | 2        |    | 3        |"
- *
- * The same 3 cards with right alignment would result in this output:
- * "|        A |    |        2 |    |        3 |"
- */
-void Hand::printCardValueRow(const vector<Card> cardsToPrint, const string alignment) {
-    if (alignment == "left") { // The top position prints the values left aligned
-        // Printing the top row(s) with value(s)
-        for (Card cardToPrint: cardsToPrint) {
-            cout << "| ";
-            // The color is based on the symbol
-            // if the symbol is red, then the text is printed in red, else in white/black
-            if (cardToPrint.getSymbol() == "hearts" || cardToPrint.getSymbol() == "diamonds") {
-                cout << red << left << setw(2) << cardToPrint.getFaceValue() << white << "       |" << '\t';
-            } else {
-                cout << left << setw(2) << cardToPrint.getFaceValue() << "       |" << '\t';
-            }
+    for (int line = 0; line < CardGlyphs::LINES_PER_CARD; ++line) {
+        for (int glyphIndex: glyphIndices) {
+            CardGlyphs::appendLine(frame, glyphIndex, line);
+            frame += '\t';
         }
-    } else if (alignment == "right") { // The same principle, but for the bottom row it is aligned on the right
-        for (Card cardToPrint: cardsToPrint) {
-            cout << "|       ";
-            if (cardToPrint.getSymbol() == "hearts" || cardToPrint.getSymbol() == "diamonds") {
-                cout << red << right << setw(2) << cardToPrint.getFaceValue() << white;
-            } else {
-                cout << right << setw(2) << cardToPrint.getFaceValue();
-            }
-            cout << " |" << '\t';
-        }
-    } else {
-        cerr << "Error in printCardValueRow: position not defined correctly" << endl;
+        frame += '\n';
     }
-    cout << endl;
-}
-
-/**
- * This function is responsible for printing the symbol row(s) of the graphical representations of a Card or
- * multiple cards. These are found on the top left and bottom right of a card. As input, it takes a vector of cards
- * to be printed and the alignment of the symbol on the card. The alignment input can be "left" or "right". It then
- * prints a symbol row for every card in this vector, taking into consideration the desired alignment of the symbol
- * on the card.
- *
- * For example, 3 cards with left alignment could result in this output:
- * "| ♥        |    | ♠        |    | ♦        |"
- *
- * The same 3 cards with right alignment would result in this output:
- * "|        ♥ |    |        ♠ |    |        ♦ |"
- */
-void Hand::printCardSymbolRow(const vector<Card> cardsToPrint, const string alignment) {
-    // Printing the top row(s) with symbol(s)
-    // Going through the vector starting at the 2nd value (i=1) and skipping every other value
-    // in order to get to the symbols and not the card cardsData
-    if (alignment == "left") { // The top position prints the symbols left aligned
-        for (Card cardToPrint: cardsToPrint) {
-            char symbol = cardToPrint.cardSymbolStringToIconChar(cardToPrint.getSymbol());
-
-            // Printing the left border of the card in white/black
-            cout << white << "| ";
-            // If the symbol is hearts or diamonds, print it in red and else in white/black
-            if (cardToPrint.getSymbol() == "hearts" || cardToPrint.getSymbol() == "diamonds") {
-                cout << red << symbol << white;
-            } else {
-                cout << symbol;
-            }
-            // Printing the right border of the card in white/black
-            cout << "        |" << '\t';
-        }
-    } else if (alignment == "right") { // The same principle, but for the bottom row it is aligned on the right
-        for (Card cardToPrint: cardsToPrint) {
-            char symbol = cardToPrint.cardSymbolStringToIconChar(cardToPrint.getSymbol());
-
-            cout << white << "|        ";
-            // if the symbol is hearts or diamonds, print it in red and else in white/black
-            if (cardToPrint.getSymbol() == "hearts" || cardToPrint.getSymbol() == "diamonds") {
-                cout << red << symbol << white;
-            } else {
-                cout << symbol;
-            }
-            cout << " |" << '\t';
-        }
-    } else {
-        cerr << "Error in printCardValueRow: position not defined correctly" << endl;
-    }
-    cout << endl;
 }
 
 /**
@@ -169,6 +58,16 @@ void Hand::addRandomCards(int amountOfCardsToAdd) {
     }
 }
 
+/**
+ * This function adds an amount of cards drawn from the input "cardSource" to the Hand object, for example from a
+ * Shoe. It takes an integer value that specifies how many cards need to be drawn and added.
+ */
+void Hand::addRandomCards(int amountOfCardsToAdd, CardSource &cardSource) {
+    for (int i = 0; i < amountOfCardsToAdd; i++) {
+        cardsInHand.push_back(Card(cardSource.drawRank()));
+    }
+}
+
 /**
  * This function removes the lastly added Card object from a hand of cards.
  */
@@ -199,6 +98,14 @@ Card Hand::getCardAtIndex(int index) {
     return cardsInHand[index];
 }
 
+/**
+ * This function turns the Card object at the input "index" face down if "faceDown" is true, and face up otherwise. A
+ * face-down card is drawn as the back of a card.
+ */
+void Hand::setCardFaceDown(int index, bool faceDown) {
+    cardsInHand[index].setFaceDown(faceDown);
+}
+
 /**
  * This function prints a hand of cards vertically, one after the other.
  */
@@ -215,9 +122,9 @@ void Hand::printVertical() {
  * The console can display a finite amount of cards next to each other before running out of space. The max amount
  * of cards will be determined by factors like the IDE and console settings. This value can be adjusted from the
  * private constant "MAX_CARDS_PER_PRINT_ROW" in this class. This function takes sections from the hand of cards that
- * don't contain more cards than this constant specifies. The rows of cards are then printed by combining 7 layers
- * of strings as defined by the sub-functions. If a full row of cards is printed, and there are more cards in the
- * hand, a new row is printed. This repeats until all cards have been printed to the console.
+ * don't contain more cards than this constant specifies. The rows of cards are then put together from the 7 lines
+ * of the cards' glyphs (see CardGlyphs.h). If a full row of cards is done, and there are more cards in the hand, a
+ * new row is started. This repeats until all cards are in the frame, which is printed to the console at once.
  *
  * Example for a hand of three cards:
  *  +----------+    +----------+    +----------+
@@ -229,32 +136,30 @@ void Hand::printVertical() {
  *  +----------+    +----------+    +----------+
  */
 void Hand::printHorizontal() {
+    cout << renderHorizontal();
+}
+
+/**
+ * This function returns the text that printHorizontal() prints (the frame), so it can be combined with other text
+ * before printing.
+ */
+string Hand::renderHorizontal() {
     // Calculating the amount of card rows based on the hand size and the maximum amount of cards per printing row
     int amountOfRows = ((cardsInHand.size() - 1) / MAX_CARDS_PER_PRINT_ROW) + 1;
 
-    // Printing the rows of cards in the console one by one
+    string frame;
+    frame.reserve(amountOfRows * CardGlyphs::LINES_PER_CARD * MAX_CARDS_PER_PRINT_ROW * CardGlyphs::LINE_CAPACITY);
+    // Adding the rows of cards to the frame one by one
     for (int rowOfCards = 1; rowOfCards <= amountOfRows; rowOfCards++) {
-        // Extracting sections of the hand that are no longer than MAX_CARDS_PER_PRINT_ROW for printing individual
-        // rows of cards
+        // Extracting sections of the hand that are no longer than MAX_CARDS_PER_PRINT_ROW for the individual rows of
+        // cards
         vector<Card> cardsInThisRow = getSectionOfHand(
                 ((MAX_CARDS_PER_PRINT_ROW * rowOfCards) - MAX_CARDS_PER_PRINT_ROW) + 1,
                 MAX_CARDS_PER_PRINT_ROW * rowOfCards);
 
-        // Printing the top borders of the cards ("+----------+")
-        printHorizontalCardBorders(cardsInThisRow);
-        // Printing the cards' top rows with values (e.g. "| 5        |")
-        printCardValueRow(cardsInThisRow, "left");
-        // Printing the cards' top rows with symbols (e.g. "| ♥        |")
-        printCardSymbolRow(cardsInThisRow, "left");
-        // Printing the empty middle rows of the cards ("|          |")
-        printEmptyCardRow(cardsInThisRow);
-        // Printing the cards' bottom rows with symbols (e.g. "|        ♥ |")
-        printCardSymbolRow(cardsInThisRow, "right");
-        // Printing the cards' bottom rows with values (e.g. "|        5 |")
-        printCardValueRow(cardsInThisRow, "right");
-        // Printing the bottom borders of the cards ("+----------+")
-        printHorizontalCardBorders(cardsInThisRow);
+        appendRowOfCards(frame, cardsInThisRow);
     }
+    return frame;
 }
 
 /**
@@ -16,6 +16,7 @@
 using std::string, std::vector;
 
 #include "Card.h"
+#include "CardSource.h"
 
 class Hand {
 private:
@@ -30,54 +31,10 @@ private:
     const char spades = '\x06';  //♠
 
     /**
-     * This function is responsible for printing the horizontal border(s) of the graphical representations of a Card or
-     * multiple cards. These are found at the top and bottom of a card. As input, it takes a vector of cards to be printed
-     * and it then prints a border for every card in this vector.
-     *
-     * For example if 3 cards are to be printed, the output looks like this:
-     * "+----------+    +----------+    +----------+"
-     */
-    void printHorizontalCardBorders(const vector<Card> cardsToPrint);
-
-    /**
-     * This function is responsible for printing the empty row(s) of the graphical representations of a Card or multiple
-     * cards. These are found in the middle of a card. As input, it takes a vector of cards to be printed and it then
-     * prints an empty row for every card in this vector.
-     *
-     * For example if 3 cards are to be printed, the output looks like this:
-     * "|          |    |          |    |          |"
-     */
-    void printEmptyCardRow(const vector<Card> cardsToPrint);
-
-    /**
-     * This function is responsible for printing the value row(s) of the graphical representations of a Card or
-     * multiple cards. These are found on the top left and bottom right of a card. As input, it takes a vector of cards
-     * to be printed and the alignment of the value on the card. The alignment input can be "left" or "right". It then
-     * prints a value row for every card in this vector, taking into consideration the desired alignment of the value on
-     * the card.
-     *
-     * For example, 3 cards with left alignment could result in this output:
-     * "| A        |    | 2        |    | 3        |"
-     *
-     * The same 3 cards with right alignment would result in this output:
-     * "|        A |    |        2 |    |        3 |"
-     */
-    void printCardValueRow(const vector<Card> cardsToPrint, const string alignment);
-
-    /**
-     * This function is responsible for printing the symbol row(s) of the graphical representations of a Card or
-     * multiple cards. These are found on the top left and bottom right of a card. As input, it takes a vector of cards
-     * to be printed and the alignment of the symbol on the card. The alignment input can be "left" or "right". It then
-     * prints a symbol row for every card in this vector, taking into consideration the desired alignment of the symbol
-     * on the card.
-     *
-     * For example, 3 cards with left alignment could result in this output:
-     * "| ♥        |    | ♠        |    | ♦        |"
-     *
-     * The same 3 cards with right alignment would result in this output:
-     * "|        ♥ |    |        ♠ |    |        ♦ |"
+     * This function adds the cards of the input "cardsInRow" next to each other to the end of the input "frame", line
+     * by line. Every line of a card is copied from its glyph in the CardGlyphs atlas, followed by a tab.
      */
-    void printCardSymbolRow(const vector<Card> cardsToPrint, const string alignment);
+    void appendRowOfCards(string &frame, const vector<Card> &cardsInRow);
 
 public:
     /**
@@ -96,6 +53,12 @@ public:
      */
     void addRandomCards(int amountOfCardsToAdd);
 
+    /**
+     * This function adds an amount of cards drawn from the input "cardSource" to the Hand object, for example from a
+     * Shoe. It takes an integer value that specifies how many cards need to be drawn and added.
+     */
+    void addRandomCards(int amountOfCardsToAdd, CardSource &cardSource);
+
     /**
      * This function removes the lastly added Card object from a hand of cards.
      */
@@ -118,6 +81,12 @@ public:
      */
     Card getCardAtIndex(int index);
 
+    /**
+     * This function turns the Card object at the input "index" face down if "faceDown" is true, and face up otherwise.
+     * A face-down card is drawn as the back of a card.
+     */
+    void setCardFaceDown(int index, bool faceDown);
+
     /**
      * This function prints a hand of cards vertically, one after the other.
      */
@@ -129,9 +98,9 @@ public:
      * The console can display a finite amount of cards next to each other before running out of space. The max amount
      * of cards will be determined by factors like the IDE and console settings. This value can be adjusted from the
      * private constant "MAX_CARDS_PER_PRINT_ROW" in this class. This function takes sections from the hand of cards that
-     * don't contain more cards than this constant specifies. The rows of cards are then printed by combining 7 layers
-     * of strings as defined by the sub-functions. If a full row of cards is printed, and there are more cards in the
-     * hand, a new row is printed. This repeats until all cards have been printed to the console.
+     * don't contain more cards than this constant specifies. The rows of cards are then put together from the 7 lines
+     * of the cards' glyphs (see CardGlyphs.h). If a full row of cards is done, and there are more cards in the hand, a
+     * new row is started. This repeats until all cards are in the frame, which is printed to the console at once.
      *
      * Example for a hand of three cards:
      *  +----------+    +----------+    +----------+
@@ -144,6 +113,12 @@ public:
      */
     void printHorizontal();
 
+    /**
+     * This function returns the text that printHorizontal() prints (the frame), so it can be combined with other text
+     * before printing.
+     */
+    string renderHorizontal();
+
     /**
      * This function returns a section of a Hand of cards as a vector of Card objects. The section is defined by the
      * input integers start and end. The start and end values represent the actual positions of the cards as you would
@@ -0,0 +1,219 @@
+/**
+ * The HandBatch class evaluates many Blackjack hands at once. Simulations evaluate millions of hands, and calling
+ * Blackjack::sumOptimal() for one hand after the other wastes most of the processor. A HandBatch therefore stores its
+ * hands as a structure of arrays: one array with the sum of the game values of every hand (every Ace counted as 11)
+ * and one array with the amount of Aces of every hand. This is all that is needed to calculate the optimal sum.
+ *
+ * The evaluate() function calculates the optimal sum, whether the hand is soft (an Ace still counts as 11) and whether
+ * the hand is bust for all hands using SIMD instructions: with AVX2, 16 hands are handled per instruction and two
+ * registers (32 hands) per step, with SSE2 8 hands per instruction. Without either, a plain loop is used. The ace
+ * reduction loop of Blackjack::sumOptimal() is done in lockstep: as long as any hand in a register is above 21 with an
+ * Ace left, 10 is subtracted from exactly those hands, so the results are the same as those of sumOptimal().
+ *
+ * The arrays are padded to a multiple of 32 hands, so the SIMD loops never have to handle a partial register.
+ */
+
+#include "HandBatch.h"
+
+#include <algorithm>
+
+// The SIMD instructions are only used when the compiler is allowed to use them (for example with -mavx2 or
+// -march=native, or /arch:AVX2 for MSVC). SSE2 is available on every 64-bit x86 processor.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HAND_BATCH_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HAND_BATCH_USE_SSE2
+#endif
+
+/**
+ * Constructor for a batch of "amountOfHands_" empty hands.
+ */
+HandBatch::HandBatch(int amountOfHands_)
+        : amountOfHands(amountOfHands_),
+          paddedAmountOfHands((amountOfHands_ + HANDS_PER_STEP - 1) / HANDS_PER_STEP * HANDS_PER_STEP),
+          sumsOfGameValues(paddedAmountOfHands, 0), numbersOfAces(paddedAmountOfHands, 0),
+          cardCounts(paddedAmountOfHands, 0), optimalSums(paddedAmountOfHands, 0), softFlags(paddedAmountOfHands, 0),
+          bustFlags(paddedAmountOfHands, 0) {}
+
+/**
+ * This function empties all hands of the batch.
+ */
+void HandBatch::clear() {
+    std::fill(sumsOfGameValues.begin(), sumsOfGameValues.end(), 0);
+    std::fill(numbersOfAces.begin(), numbersOfAces.end(), 0);
+    std::fill(cardCounts.begin(), cardCounts.end(), 0);
+}
+
+/**
+ * This function adds a card with the input "rank" (1-13) to the hand at the input "index".
+ */
+void HandBatch::addRank(int index, int rank) {
+    sumsOfGameValues[index] += rank == 1 ? 11 : std::min(rank, 10);
+    numbersOfAces[index] += rank == 1;
+    cardCounts[index]++;
+}
+
+/**
+ * This function adds one card to every hand of the batch at once. The input "ranks" holds a rank (1-13) for every
+ * hand, or 0 for hands that should not get a card.
+ */
+void HandBatch::addRanks(const int8_t *ranks) {
+    // Written without branches, so the compiler can turn this loop into SIMD instructions as well
+    for (int i = 0; i < amountOfHands; ++i) {
+        int rank = ranks[i];
+        int isAce = rank == 1;
+        sumsOfGameValues[i] += (int16_t) (isAce * 11 + (1 - isAce) * std::min(rank, 10));
+        numbersOfAces[i] += (int16_t) isAce;
+        cardCounts[i] += (int16_t) (rank != 0);
+    }
+}
+
+/**
+ * This function calculates the optimal sum, soft flag and bust flag of every hand in the batch.
+ */
+void HandBatch::evaluate() {
+#if defined(HAND_BATCH_USE_AVX2)
+    const __m256i twentyOne = _mm256_set1_epi16(21);
+    const __m256i ten = _mm256_set1_epi16(10);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+
+    for (int i = 0; i < paddedAmountOfHands; i += HANDS_PER_STEP) {
+        __m256i sumsA = _mm256_loadu_si256((const __m256i *) &sumsOfGameValues[i]);
+        __m256i sumsB = _mm256_loadu_si256((const __m256i *) &sumsOfGameValues[i + 16]);
+        __m256i acesA = _mm256_loadu_si256((const __m256i *) &numbersOfAces[i]);
+        __m256i acesB = _mm256_loadu_si256((const __m256i *) &numbersOfAces[i + 16]);
+
+        // While any hand is above 21 and has an Ace counting as 11, that Ace is reduced to 1 in exactly those hands
+        while (true) {
+            __m256i reduceA = _mm256_and_si256(_mm256_cmpgt_epi16(sumsA, twentyOne), _mm256_cmpgt_epi16(acesA, zero));
+            __m256i reduceB = _mm256_and_si256(_mm256_cmpgt_epi16(sumsB, twentyOne), _mm256_cmpgt_epi16(acesB, zero));
+            if (_mm256_testz_si256(_mm256_or_si256(reduceA, reduceB), _mm256_or_si256(reduceA, reduceB))) {
+                break;
+            }
+            sumsA = _mm256_sub_epi16(sumsA, _mm256_and_si256(reduceA, ten));
+            sumsB = _mm256_sub_epi16(sumsB, _mm256_and_si256(reduceB, ten));
+            // The masks are -1 in the lanes to reduce, so adding them removes one Ace
+            acesA = _mm256_add_epi16(acesA, reduceA);
+            acesB = _mm256_add_epi16(acesB, reduceB);
+        }
+
+        _mm256_storeu_si256((__m256i *) &optimalSums[i], sumsA);
+        _mm256_storeu_si256((__m256i *) &optimalSums[i + 16], sumsB);
+        _mm256_storeu_si256((__m256i *) &softFlags[i], _mm256_and_si256(_mm256_cmpgt_epi16(acesA, zero), one));
+        _mm256_storeu_si256((__m256i *) &softFlags[i + 16], _mm256_and_si256(_mm256_cmpgt_epi16(acesB, zero), one));
+        _mm256_storeu_si256((__m256i *) &bustFlags[i], _mm256_and_si256(_mm256_cmpgt_epi16(sumsA, twentyOne), one));
+        _mm256_storeu_si256((__m256i *) &bustFlags[i + 16],
+                            _mm256_and_si256(_mm256_cmpgt_epi16(sumsB, twentyOne), one));
+    }
+#elif defined(HAND_BATCH_USE_SSE2)
+    const __m128i twentyOne = _mm_set1_epi16(21);
+    const __m128i ten = _mm_set1_epi16(10);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+
+    for (int i = 0; i < paddedAmountOfHands; i += 8) {
+        __m128i sums = _mm_loadu_si128((const __m128i *) &sumsOfGameValues[i]);
+        __m128i aces = _mm_loadu_si128((const __m128i *) &numbersOfAces[i]);
+
+        // While any hand is above 21 and has an Ace counting as 11, that Ace is reduced to 1 in exactly those hands
+        while (true) {
+            __m128i reduce = _mm_and_si128(_mm_cmpgt_epi16(sums, twentyOne), _mm_cmpgt_epi16(aces, zero));
+            if (_mm_movemask_epi8(reduce) == 0) {
+                break;
+            }
+            sums = _mm_sub_epi16(sums, _mm_and_si128(reduce, ten));
+            // The mask is -1 in the lanes to reduce, so adding it removes one Ace
+            aces = _mm_add_epi16(aces, reduce);
+        }
+
+        _mm_storeu_si128((__m128i *) &optimalSums[i], sums);
+        _mm_storeu_si128((__m128i *) &softFlags[i], _mm_and_si128(_mm_cmpgt_epi16(aces, zero), one));
+        _mm_storeu_si128((__m128i *) &bustFlags[i], _mm_and_si128(_mm_cmpgt_epi16(sums, twentyOne), one));
+    }
+#else
+    for (int i = 0; i < paddedAmountOfHands; ++i) {
+        int sum = sumsOfGameValues[i];
+        int aces = numbersOfAces[i];
+        while (sum > 21 && aces > 0) {
+            sum -= 10;
+            aces--;
+        }
+        optimalSums[i] = (int16_t) sum;
+        softFlags[i] = (int16_t) (aces > 0);
+        bustFlags[i] = (int16_t) (sum > 21);
+    }
+#endif
+}
+
+/**
+ * This function returns the amount of hands in the batch.
+ */
+int HandBatch::getSize() {
+    return amountOfHands;
+}
+
+/**
+ * This function returns the optimal sum of the hand at the input "index", as calculated by the last evaluate().
+ */
+int HandBatch::getOptimalSum(int index) {
+    return optimalSums[index];
+}
+
+/**
+ * This function returns true if the hand at the input "index" was soft at the last evaluate().
+ */
+bool HandBatch::isSoft(int index) {
+    return softFlags[index] != 0;
+}
+
+/**
+ * This function returns true if the hand at the input "index" was bust at the last evaluate().
+ */
+bool HandBatch::isBust(int index) {
+    return bustFlags[index] != 0;
+}
+
+/**
+ * This function returns the amount of cards of the hand at the input "index".
+ */
+int HandBatch::getCardCount(int index) {
+    return cardCounts[index];
+}
+
+/**
+ * These functions return the arrays of the batch, so that other batched code can work on them directly. The arrays
+ * have room for getPaddedSize() hands.
+ */
+int16_t *HandBatch::getSumsOfGameValues() {
+    return sumsOfGameValues.data();
+}
+
+int16_t *HandBatch::getNumbersOfAces() {
+    return numbersOfAces.data();
+}
+
+int16_t *HandBatch::getCardCounts() {
+    return cardCounts.data();
+}
+
+const int16_t *HandBatch::getOptimalSums() {
+    return optimalSums.data();
+}
+
+const int16_t *HandBatch::getSoftFlags() {
+    return softFlags.data();
+}
+
+const int16_t *HandBatch::getBustFlags() {
+    return bustFlags.data();
+}
+
+/**
+ * This function returns the amount of hands the arrays have room for, which is a multiple of HANDS_PER_STEP.
+ */
+int HandBatch::getPaddedSize() {
+    return paddedAmountOfHands;
+}
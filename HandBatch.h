@@ -0,0 +1,112 @@
+/**
+ * The HandBatch class evaluates many Blackjack hands at once. Simulations evaluate millions of hands, and calling
+ * Blackjack::sumOptimal() for one hand after the other wastes most of the processor. A HandBatch therefore stores its
+ * hands as a structure of arrays: one array with the sum of the game values of every hand (every Ace counted as 11)
+ * and one array with the amount of Aces of every hand. This is all that is needed to calculate the optimal sum.
+ *
+ * The evaluate() function calculates the optimal sum, whether the hand is soft (an Ace still counts as 11) and whether
+ * the hand is bust for all hands using SIMD instructions: with AVX2, 16 hands are handled per instruction and two
+ * registers (32 hands) per step, with SSE2 8 hands per instruction. Without either, a plain loop is used. The ace
+ * reduction loop of Blackjack::sumOptimal() is done in lockstep: as long as any hand in a register is above 21 with an
+ * Ace left, 10 is subtracted from exactly those hands, so the results are the same as those of sumOptimal().
+ *
+ * The arrays are padded to a multiple of 32 hands, so the SIMD loops never have to handle a partial register.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_HANDBATCH_H
+#define PIE_CPP_BLACKJACK_HANDBATCH_H
+
+#include <cstdint>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::vector;
+
+class HandBatch {
+public:
+    static const int HANDS_PER_STEP = 32;
+
+private:
+    int amountOfHands;
+    int paddedAmountOfHands;
+
+    // The input of every hand
+    vector<int16_t> sumsOfGameValues;
+    vector<int16_t> numbersOfAces;
+    vector<int16_t> cardCounts;
+
+    // The output of evaluate() for every hand
+    vector<int16_t> optimalSums;
+    vector<int16_t> softFlags; // 1 if an Ace still counts as 11, 0 otherwise
+    vector<int16_t> bustFlags; // 1 if the optimal sum is above 21, 0 otherwise
+
+public:
+    /**
+     * Constructor for a batch of "amountOfHands_" empty hands.
+     */
+    explicit HandBatch(int amountOfHands_);
+
+    /**
+     * This function empties all hands of the batch.
+     */
+    void clear();
+
+    /**
+     * This function adds a card with the input "rank" (1-13) to the hand at the input "index".
+     */
+    void addRank(int index, int rank);
+
+    /**
+     * This function adds one card to every hand of the batch at once. The input "ranks" holds a rank (1-13) for every
+     * hand, or 0 for hands that should not get a card.
+     */
+    void addRanks(const int8_t *ranks);
+
+    /**
+     * This function calculates the optimal sum, soft flag and bust flag of every hand in the batch.
+     */
+    void evaluate();
+
+    /**
+     * This function returns the amount of hands in the batch.
+     */
+    int getSize();
+
+    /**
+     * This function returns the optimal sum of the hand at the input "index", as calculated by the last evaluate().
+     */
+    int getOptimalSum(int index);
+
+    /**
+     * This function returns true if the hand at the input "index" was soft at the last evaluate().
+     */
+    bool isSoft(int index);
+
+    /**
+     * This function returns true if the hand at the input "index" was bust at the last evaluate().
+     */
+    bool isBust(int index);
+
+    /**
+     * This function returns the amount of cards of the hand at the input "index".
+     */
+    int getCardCount(int index);
+
+    /**
+     * These functions return the arrays of the batch, so that other batched code can work on them directly. The arrays
+     * have room for getPaddedSize() hands.
+     */
+    int16_t *getSumsOfGameValues();
+    int16_t *getNumbersOfAces();
+    int16_t *getCardCounts();
+    const int16_t *getOptimalSums();
+    const int16_t *getSoftFlags();
+    const int16_t *getBustFlags();
+
+    /**
+     * This function returns the amount of hands the arrays have room for, which is a multiple of HANDS_PER_STEP.
+     */
+    int getPaddedSize();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_HANDBATCH_H
@@ -0,0 +1,196 @@
+/**
+ * The Instrumentation class measures where the time of the engine goes, in builds with the CMake option
+ * BLACKJACK_INSTRUMENTATION (which defines the macro of the same name). It keeps two kinds of numbers for every thread:
+ *  - counters of the work done: rounds, hands, cards dealt, Card objects created and calls of Blackjack::sumOptimal();
+ *  - for every phase of a round (dealing, the player's decision, the dealer's play, settling, rendering the table and
+ *    writing the event log): how many times it was entered and how many cycles of the processor were spent in it.
+ * The hot paths mark their phases with INSTRUMENT_PHASE(DEAL) at the start of a scope, and count with
+ * INSTRUMENT_COUNT(CARDS_DEALT, 1). Without BLACKJACK_INSTRUMENTATION both macros are empty, so the normal build does
+ * not contain a single instruction of the instrumentation.
+ *
+ * The cycles are read from the time stamp counter of the processor (or a steady clock on processors without one).
+ * Phases can be nested, like rendering inside the dealer's play: a phase only counts the cycles that are not spent
+ * in the phases inside it, so the cycles of all phases together add up to the time spent in any phase. The pauses
+ * between the cards are part of the phase they are in, so the game is best measured with --no-delay.
+ *
+ * Every thread writes only its own numbers, without locks or atomic read-modify-writes, so the counters do not slow
+ * each other down. They are kept after the thread has finished. takeSnapshot() reads the numbers of all threads while
+ * they keep going, and the SnapshotExporter writes such a snapshot regularly to a file or a Unix socket.
+ */
+
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Snapshots are sent to Unix sockets with the POSIX socket functions
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cerr, std::endl;
+
+namespace {
+    const char *PHASE_NAMES[Instrumentation::AMOUNT_OF_PHASES] = {"deal", "player-decision", "dealer-play", "settle",
+                                                                 "render", "log"};
+    const char *COUNTER_NAMES[Instrumentation::AMOUNT_OF_COUNTERS] = {"rounds", "hands", "cards-dealt",
+                                                                     "cards-created", "sum-optimal-calls"};
+    const std::chrono::steady_clock::time_point START_TIME = std::chrono::steady_clock::now();
+}
+
+std::mutex Instrumentation::allThreadsMutex;
+vector<std::unique_ptr<Instrumentation::ThreadNumbers>> Instrumentation::allThreads;
+
+/**
+ * This function creates the numbers of the calling thread and keeps them with those of all threads.
+ */
+Instrumentation::ThreadNumbers *Instrumentation::registerThread() {
+    std::lock_guard<std::mutex> lock(allThreadsMutex);
+    allThreads.push_back(std::make_unique<ThreadNumbers>());
+    allThreads.back()->threadNumber = (int) allThreads.size() - 1;
+    return allThreads.back().get();
+}
+
+/**
+ * This function returns the numbers of all threads so far as text: a line per thread with its counters and the
+ * calls and cycles of its phases, and a line with the totals, in which every phase also gets its share of the
+ * cycles. The snapshot is numbered with "snapshotNumber".
+ */
+string Instrumentation::takeSnapshot(uint64_t snapshotNumber) {
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - START_TIME).count();
+    uint64_t totalCounters[AMOUNT_OF_COUNTERS] = {};
+    uint64_t totalCalls[AMOUNT_OF_PHASES] = {};
+    uint64_t totalCycles[AMOUNT_OF_PHASES] = {};
+
+    std::ostringstream snapshot;
+    snapshot << "snapshot " << snapshotNumber << " after " << elapsedSeconds << " s (phases as calls/cycles)" << endl;
+    std::lock_guard<std::mutex> lock(allThreadsMutex);
+    for (const std::unique_ptr<ThreadNumbers> &numbers : allThreads) {
+        snapshot << "thread " << numbers->threadNumber << ":";
+        for (int counter = 0; counter < AMOUNT_OF_COUNTERS; ++counter) {
+            uint64_t value = numbers->counters[counter].load(std::memory_order_relaxed);
+            totalCounters[counter] += value;
+            snapshot << " " << COUNTER_NAMES[counter] << "=" << value;
+        }
+        for (int phase = 0; phase < AMOUNT_OF_PHASES; ++phase) {
+            uint64_t calls = numbers->phaseCalls[phase].load(std::memory_order_relaxed);
+            uint64_t cycles = numbers->phaseCycles[phase].load(std::memory_order_relaxed);
+            totalCalls[phase] += calls;
+            totalCycles[phase] += cycles;
+            snapshot << " " << PHASE_NAMES[phase] << "=" << calls << "/" << cycles;
+        }
+        snapshot << endl;
+    }
+
+    uint64_t cyclesInPhases = 0;
+    for (uint64_t cycles : totalCycles) {
+        cyclesInPhases += cycles;
+    }
+    snapshot << "total:";
+    for (int counter = 0; counter < AMOUNT_OF_COUNTERS; ++counter) {
+        snapshot << " " << COUNTER_NAMES[counter] << "=" << totalCounters[counter];
+    }
+    for (int phase = 0; phase < AMOUNT_OF_PHASES; ++phase) {
+        double share = cyclesInPhases > 0 ? 100.0 * totalCycles[phase] / cyclesInPhases : 0;
+        snapshot << " " << PHASE_NAMES[phase] << "=" << totalCalls[phase] << "/" << totalCycles[phase] << "("
+                 << share << "%)";
+    }
+    snapshot << endl;
+    return snapshot.str();
+}
+
+/**
+ * Constructor for an exporter that writes a snapshot every "intervalMilliseconds" milliseconds, and a last one when
+ * it is destroyed. If the input "destination" starts with "unix:", every snapshot is sent over a new connection to
+ * the Unix socket at the path after it (and skipped if nothing listens there). Otherwise, the destination is a file,
+ * which is replaced in one step by every snapshot, so a reader never sees half a snapshot.
+ */
+SnapshotExporter::SnapshotExporter(const string &destination, int intervalMilliseconds)
+        : DESTINATION(destination), INTERVAL(std::max(1, intervalMilliseconds)) {
+#ifdef _WIN32
+    if (DESTINATION.rfind("unix:", 0) == 0) {
+        cerr << "Error: snapshots cannot be sent to a Unix socket on Windows, use a file instead" << endl;
+        exit(-1);
+    }
+#endif
+    exportThread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(stopMutex);
+        while (!stopCondition.wait_for(lock, INTERVAL, [this]() { return isStopping; })) {
+            writeSnapshot();
+        }
+    });
+}
+
+/**
+ * Destructor: stops the background thread and writes the last snapshot.
+ */
+SnapshotExporter::~SnapshotExporter() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        isStopping = true;
+    }
+    stopCondition.notify_one();
+    exportThread.join();
+    writeSnapshot();
+}
+
+/**
+ * This function writes a new snapshot to the destination, see the constructor.
+ */
+void SnapshotExporter::writeSnapshot() {
+    string snapshot = Instrumentation::takeSnapshot(++snapshotsWritten);
+
+#ifndef _WIN32
+    if (DESTINATION.rfind("unix:", 0) == 0) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        string path = DESTINATION.substr(5);
+        if (path.size() >= sizeof(address.sun_path)) {
+            cerr << "Error: the socket path \"" << path << "\" is too long" << endl;
+            exit(-1);
+        }
+        path.copy(address.sun_path, path.size());
+
+        int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connection < 0) {
+            return;
+        }
+        // Nobody listening is not an error: the snapshot is skipped, and the next one tries again
+        if (connect(connection, (sockaddr *) &address, sizeof(address)) == 0) {
+#ifdef MSG_NOSIGNAL
+            const int SEND_FLAGS = MSG_NOSIGNAL; // a listener that hangs up must not end the program
+#else
+            const int SEND_FLAGS = 0;
+#endif
+            size_t sent = 0;
+            while (sent < snapshot.size()) {
+                ssize_t amount = send(connection, snapshot.data() + sent, snapshot.size() - sent, SEND_FLAGS);
+                if (amount <= 0) {
+                    break;
+                }
+                sent += amount;
+            }
+        }
+        close(connection);
+        return;
+    }
+#endif
+
+    // Renaming replaces the old snapshot in one step
+    string temporaryFileName = DESTINATION + ".tmp";
+    {
+        std::ofstream file(temporaryFileName, std::ios::trunc);
+        if (!file) {
+            cerr << "Error: the snapshot file \"" << temporaryFileName << "\" could not be written" << endl;
+            exit(-1);
+        }
+        file << snapshot;
+    }
+    std::filesystem::rename(temporaryFileName, DESTINATION);
+}
@@ -0,0 +1,232 @@
+/**
+ * The Instrumentation class measures where the time of the engine goes, in builds with the CMake option
+ * BLACKJACK_INSTRUMENTATION (which defines the macro of the same name). It keeps two kinds of numbers for every thread:
+ *  - counters of the work done: rounds, hands, cards dealt, Card objects created and calls of Blackjack::sumOptimal();
+ *  - for every phase of a round (dealing, the player's decision, the dealer's play, settling, rendering the table and
+ *    writing the event log): how many times it was entered and how many cycles of the processor were spent in it.
+ * The hot paths mark their phases with INSTRUMENT_PHASE(DEAL) at the start of a scope, and count with
+ * INSTRUMENT_COUNT(CARDS_DEALT, 1). Without BLACKJACK_INSTRUMENTATION both macros are empty, so the normal build does
+ * not contain a single instruction of the instrumentation.
+ *
+ * The cycles are read from the time stamp counter of the processor (or a steady clock on processors without one).
+ * Phases can be nested, like rendering inside the dealer's play: a phase only counts the cycles that are not spent
+ * in the phases inside it, so the cycles of all phases together add up to the time spent in any phase. The pauses
+ * between the cards are part of the phase they are in, so the game is best measured with --no-delay.
+ *
+ * Every thread writes only its own numbers, without locks or atomic read-modify-writes, so the counters do not slow
+ * each other down. They are kept after the thread has finished. takeSnapshot() reads the numbers of all threads while
+ * they keep going, and the SnapshotExporter writes such a snapshot regularly to a file or a Unix socket.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_INSTRUMENTATION_H
+#define PIE_CPP_BLACKJACK_INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The time stamp counter is read with the __rdtsc() intrinsic
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define INSTRUMENTATION_HAS_TIME_STAMP_COUNTER
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define INSTRUMENTATION_HAS_TIME_STAMP_COUNTER
+#endif
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::vector;
+
+class Instrumentation {
+public:
+    enum Phase {
+        NO_PHASE = -1,
+        DEAL,
+        PLAYER_DECISION,
+        DEALER_PLAY,
+        SETTLE,
+        RENDER,
+        LOG,
+        AMOUNT_OF_PHASES
+    };
+
+    enum Counter {
+        ROUNDS,
+        HANDS,
+        CARDS_DEALT,
+        CARDS_CREATED,     // Card objects constructed (not copied)
+        SUM_OPTIMAL_CALLS, // sums of a whole Hand by Blackjack::sumOptimal()
+        AMOUNT_OF_COUNTERS
+    };
+
+private:
+    // The numbers of one thread. Only that thread writes them, so a relaxed load and store is enough to add to them,
+    // while other threads can still read them
+    struct alignas(64) ThreadNumbers {
+        int threadNumber = 0;
+        std::atomic<uint64_t> counters[AMOUNT_OF_COUNTERS] = {};
+        std::atomic<uint64_t> phaseCalls[AMOUNT_OF_PHASES] = {};
+        std::atomic<uint64_t> phaseCycles[AMOUNT_OF_PHASES] = {};
+
+        // The phase the thread is in and the cycle at which its last uncounted stretch started
+        Phase currentPhase = NO_PHASE;
+        uint64_t stretchStart = 0;
+    };
+
+    static inline thread_local ThreadNumbers *threadNumbers = nullptr;
+
+    // The numbers of all threads that have been instrumented. They are never freed, so a snapshot can still read the
+    // numbers of finished threads
+    static std::mutex allThreadsMutex;
+    static vector<std::unique_ptr<ThreadNumbers>> allThreads;
+
+    /**
+     * This function creates the numbers of the calling thread and keeps them with those of all threads.
+     */
+    static ThreadNumbers *registerThread();
+
+    /**
+     * This function returns the numbers of the calling thread, which are created the first time.
+     */
+    static ThreadNumbers &forThisThread() {
+        if (threadNumbers == nullptr) {
+            threadNumbers = registerThread();
+        }
+        return *threadNumbers;
+    }
+
+    /**
+     * This function adds the input "amount" to the input "number", which only the calling thread writes.
+     */
+    static void add(std::atomic<uint64_t> &number, uint64_t amount) {
+        number.store(number.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    /**
+     * This function adds the cycles since the last stretch started to the current phase of the input "numbers", and
+     * starts a new stretch at "now".
+     */
+    static void closeStretch(ThreadNumbers &numbers, uint64_t now) {
+        if (numbers.currentPhase != NO_PHASE) {
+            add(numbers.phaseCycles[numbers.currentPhase], now - numbers.stretchStart);
+        }
+        numbers.stretchStart = now;
+    }
+
+public:
+    // Marks a phase from its construction to the end of its scope, see INSTRUMENT_PHASE
+    class PhaseTimer {
+    private:
+        ThreadNumbers &numbers;
+        Phase outerPhase;
+
+    public:
+        /**
+         * Constructor for a timer that puts the calling thread in the input "phase" until the timer is destroyed.
+         */
+        explicit PhaseTimer(Phase phase) : numbers(forThisThread()), outerPhase(numbers.currentPhase) {
+            closeStretch(numbers, readCycleCounter());
+            numbers.currentPhase = phase;
+            add(numbers.phaseCalls[phase], 1);
+        }
+
+        ~PhaseTimer() {
+            closeStretch(numbers, readCycleCounter());
+            numbers.currentPhase = outerPhase;
+        }
+
+        PhaseTimer(const PhaseTimer &) = delete;
+        PhaseTimer &operator=(const PhaseTimer &) = delete;
+    };
+
+    /**
+     * This function returns the current cycle of the time stamp counter, or the ticks of a steady clock on processors
+     * without one.
+     */
+    static uint64_t readCycleCounter() {
+#ifdef INSTRUMENTATION_HAS_TIME_STAMP_COUNTER
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    /**
+     * This function adds the input "amount" to the input "counter" of the calling thread.
+     */
+    static void count(Counter counter, uint64_t amount) {
+        add(forThisThread().counters[counter], amount);
+    }
+
+    /**
+     * This function returns true if the program was built with BLACKJACK_INSTRUMENTATION.
+     */
+    static constexpr bool isEnabled() {
+#ifdef BLACKJACK_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * This function returns the numbers of all threads so far as text: a line per thread with its counters and the
+     * calls and cycles of its phases, and a line with the totals, in which every phase also gets its share of the
+     * cycles. The snapshot is numbered with "snapshotNumber".
+     */
+    static string takeSnapshot(uint64_t snapshotNumber);
+};
+
+// Writes a snapshot of the Instrumentation regularly, on a background thread
+class SnapshotExporter {
+private:
+    const string DESTINATION;
+    const std::chrono::milliseconds INTERVAL;
+    uint64_t snapshotsWritten = 0;
+
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool isStopping = false;
+    std::thread exportThread;
+
+    /**
+     * This function writes a new snapshot to the destination, see the constructor.
+     */
+    void writeSnapshot();
+
+public:
+    /**
+     * Constructor for an exporter that writes a snapshot every "intervalMilliseconds" milliseconds, and a last one when
+     * it is destroyed. If the input "destination" starts with "unix:", every snapshot is sent over a new connection to
+     * the Unix socket at the path after it (and skipped if nothing listens there). Otherwise, the destination is a file,
+     * which is replaced in one step by every snapshot, so a reader never sees half a snapshot.
+     */
+    SnapshotExporter(const string &destination, int intervalMilliseconds);
+
+    /**
+     * Destructor: stops the background thread and writes the last snapshot.
+     */
+    ~SnapshotExporter();
+
+    SnapshotExporter(const SnapshotExporter &) = delete;
+    SnapshotExporter &operator=(const SnapshotExporter &) = delete;
+};
+
+#ifdef BLACKJACK_INSTRUMENTATION
+// Puts the thread in the phase "phase" (like DEAL) until the end of the scope, at most once per scope
+#define INSTRUMENT_PHASE(phase) Instrumentation::PhaseTimer instrumentedPhase(Instrumentation::phase)
+// Adds "amount" to the counter "counter" (like CARDS_DEALT) of the thread
+#define INSTRUMENT_COUNT(counter, amount) Instrumentation::count(Instrumentation::counter, amount)
+#else
+#define INSTRUMENT_PHASE(phase)
+#define INSTRUMENT_COUNT(counter, amount)
+#endif
+
+
+#endif //PIE_CPP_BLACKJACK_INSTRUMENTATION_H
@@ -0,0 +1,77 @@
+/**
+ * The Ledger class keeps the balances of many seats (players at tables) that are settled at the same time by different
+ * threads. Money is kept in cents (whole numbers, see Money.h), so the balances are exact, no matter how many rounds
+ * are settled.
+ *
+ * Threads do not change the balances themselves, which would need a lock around every settlement. Instead, every
+ * writing thread has its own queue (a ring buffer with one writer and one reader), into which it posts its debits and
+ * credits without any lock: posting writes the entry and then moves the write position forward. The entries are
+ * applied to the balances in batches by applyPending(), which takes the entries of all queues at once. Only if a
+ * queue is full, the writer applies the entries itself.
+ *
+ * A snapshot of the balances is taken in between batches, so it is consistent: it contains every entry of a writer up
+ * to some moment, in the order in which the writer posted them, and nothing after it.
+ */
+
+#include "Ledger.h"
+
+/**
+ * Constructor for a ledger with "amountOfSeats" seats that start with a balance of 0, and "amountOfWriters" queues
+ * for the threads that post to it.
+ */
+Ledger::Ledger(int amountOfSeats, int amountOfWriters) : balances(amountOfSeats) {
+    for (int writer = 0; writer < amountOfWriters; ++writer) {
+        queues.push_back(std::make_unique<WriterQueue>());
+    }
+}
+
+/**
+ * This function posts "amount" (positive for a credit, negative for a debit) to the balance of "seat",
+ * without a lock. Every "writer" (0 up to the amount of writers) must only be used by one thread at a time. The
+ * balance changes when the entry is applied, see applyPending().
+ */
+void Ledger::post(int writer, int seat, Money amount) {
+    WriterQueue &queue = *queues[writer];
+    uint64_t position = queue.writePosition.load(std::memory_order_relaxed);
+    // A full queue is emptied by the writer itself, so posting never has to wait for another thread
+    while (position - queue.readPosition.load(std::memory_order_acquire) == QUEUE_CAPACITY) {
+        applyPending();
+    }
+    queue.entries[position & (QUEUE_CAPACITY - 1)] = {seat, amount};
+    // Releasing the new position makes the entry visible to applyPending() before the position itself
+    queue.writePosition.store(position + 1, std::memory_order_release);
+}
+
+/**
+ * This function applies all entries that have been posted so far to the balances, one queue after the other, and
+ * returns the amount of entries it applied.
+ */
+uint64_t Ledger::applyPending() {
+    std::lock_guard<std::mutex> lock(applyMutex);
+    uint64_t applied = 0;
+    for (std::unique_ptr<WriterQueue> &queue : queues) {
+        uint64_t readPosition = queue->readPosition.load(std::memory_order_relaxed);
+        uint64_t writePosition = queue->writePosition.load(std::memory_order_acquire);
+        for (uint64_t position = readPosition; position < writePosition; ++position) {
+            const LedgerEntry &entry = queue->entries[position & (QUEUE_CAPACITY - 1)];
+            balances[entry.seat] += entry.amount;
+        }
+        // Releasing the read position hands the applied places in the queue back to the writer
+        queue->readPosition.store(writePosition, std::memory_order_release);
+        applied += writePosition - readPosition;
+    }
+    entriesApplied += applied;
+    return applied;
+}
+
+/**
+ * This function applies all posted entries and returns a consistent snapshot of the balances of all seats.
+ */
+LedgerSnapshot Ledger::getSnapshot() {
+    applyPending();
+    std::lock_guard<std::mutex> lock(applyMutex);
+    LedgerSnapshot snapshot;
+    snapshot.balances = balances;
+    snapshot.entriesApplied = entriesApplied;
+    return snapshot;
+}
@@ -0,0 +1,83 @@
+/**
+ * The Ledger class keeps the balances of many seats (players at tables) that are settled at the same time by different
+ * threads. Money is kept in cents (whole numbers, see Money.h), so the balances are exact, no matter how many rounds
+ * are settled.
+ *
+ * Threads do not change the balances themselves, which would need a lock around every settlement. Instead, every
+ * writing thread has its own queue (a ring buffer with one writer and one reader), into which it posts its debits and
+ * credits without any lock: posting writes the entry and then moves the write position forward. The entries are
+ * applied to the balances in batches by applyPending(), which takes the entries of all queues at once. Only if a
+ * queue is full, the writer applies the entries itself.
+ *
+ * A snapshot of the balances is taken in between batches, so it is consistent: it contains every entry of a writer up
+ * to some moment, in the order in which the writer posted them, and nothing after it.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_LEDGER_H
+#define PIE_CPP_BLACKJACK_LEDGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Money.h"
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::vector;
+
+struct LedgerEntry {
+    int seat;
+    Money amount; // positive for a credit to the seat, negative for a debit
+};
+
+struct LedgerSnapshot {
+    vector<Money> balances; // the balance of every seat
+    uint64_t entriesApplied = 0;
+};
+
+class Ledger {
+private:
+    static const int QUEUE_CAPACITY = 1 << 16; // a power of 2, so a position is turned into an index with a mask
+
+    struct WriterQueue {
+        vector<LedgerEntry> entries = vector<LedgerEntry>(QUEUE_CAPACITY);
+        // The writer and the reader each move their own position, on separate cache lines
+        alignas(64) std::atomic<uint64_t> writePosition{0};
+        alignas(64) std::atomic<uint64_t> readPosition{0};
+    };
+
+    vector<std::unique_ptr<WriterQueue>> queues;
+
+    // The balances are only changed by applyPending(), one batch at a time
+    std::mutex applyMutex;
+    vector<Money> balances;
+    uint64_t entriesApplied = 0;
+
+public:
+    /**
+     * Constructor for a ledger with "amountOfSeats" seats that start with a balance of 0, and "amountOfWriters" queues
+     * for the threads that post to it.
+     */
+    Ledger(int amountOfSeats, int amountOfWriters);
+
+    /**
+     * This function posts "amount" (positive for a credit, negative for a debit) to the balance of "seat",
+     * without a lock. Every "writer" (0 up to the amount of writers) must only be used by one thread at a time. The
+     * balance changes when the entry is applied, see applyPending().
+     */
+    void post(int writer, int seat, Money amount);
+
+    /**
+     * This function applies all entries that have been posted so far to the balances, one queue after the other, and
+     * returns the amount of entries it applied.
+     */
+    uint64_t applyPending();
+
+    /**
+     * This function applies all posted entries and returns a consistent snapshot of the balances of all seats.
+     */
+    LedgerSnapshot getSnapshot();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_LEDGER_H
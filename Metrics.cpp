@@ -0,0 +1,308 @@
+/**
+ * The Metrics class keeps the numbers an operator watches while the tables are running, and the MetricsEndpoint
+ * serves them over HTTP on the local computer in the text format of Prometheus, so a Prometheus server (or curl) can
+ * collect them from "http://127.0.0.1:<port>/metrics". There are three kinds of metrics:
+ *  - counters, which only go up: rounds, actions of the players, events published to spectators and bytes written to
+ *    the screen, the event log and the account log. A rate like rounds per second is calculated from two scrapes;
+ *  - gauges, which go up and down: the tables that are open, and the depths of the queues (coroutines that can go on,
+ *    running timers of the CoroutineScheduler and account records waiting for the next fsync);
+ *  - histograms, which count observations in buckets: how long the players take to act, and how long an fsync of the
+ *    AccountStore takes. Every bucket counts the observations up to its bound.
+ *
+ * Unlike the Instrumentation (see Instrumentation.h), the metrics are always on, so they must be cheap. Every thread
+ * adds to its own numbers, without locks or atomic read-modify-writes, and a gauge is kept as the sum of the changes
+ * made by all threads. The numbers of all threads are only added up when the metrics are scraped. The numbers of
+ * finished threads are kept, so the counters never go down.
+ */
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+// The endpoint uses the socket functions of Winsock on Windows and of POSIX elsewhere, which are nearly the same
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cerr, std::endl, std::to_string;
+
+namespace {
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+
+    void closeSocket(SocketHandle socketToClose) {
+        closesocket(socketToClose);
+    }
+#else
+    using SocketHandle = int;
+    const SocketHandle INVALID_SOCKET = -1;
+
+    void closeSocket(SocketHandle socketToClose) {
+        close(socketToClose);
+    }
+#endif
+
+#ifdef MSG_NOSIGNAL
+    const int SEND_FLAGS = MSG_NOSIGNAL; // a scraper that hangs up must not end the program
+#else
+    const int SEND_FLAGS = 0;
+#endif
+
+    struct MetricDescription {
+        const char *name;
+        const char *labels; // empty, or the labels that tell this metric apart from others with the same name
+        const char *help;
+    };
+
+    const MetricDescription COUNTERS[Metrics::AMOUNT_OF_COUNTERS] = {
+            {"blackjack_rounds_total", "", "Rounds started at all tables."},
+            {"blackjack_actions_total", "", "Answers of the players to the questions of the tables."},
+            {"blackjack_events_published_total", "", "Events published to the spectators of the table."},
+            {"blackjack_bytes_written_total", "destination=\"screen\"", "Bytes written, by destination."},
+            {"blackjack_bytes_written_total", "destination=\"event_log\"", "Bytes written, by destination."},
+            {"blackjack_bytes_written_total", "destination=\"account_log\"", "Bytes written, by destination."}};
+
+    const MetricDescription GAUGES[Metrics::AMOUNT_OF_GAUGES] = {
+            {"blackjack_open_tables", "", "Tables that are playing."},
+            {"blackjack_queue_depth", "queue=\"ready_coroutines\"", "Items waiting in a queue, by queue."},
+            {"blackjack_queue_depth", "queue=\"timers\"", "Items waiting in a queue, by queue."},
+            {"blackjack_queue_depth", "queue=\"account_records\"", "Items waiting in a queue, by queue."}};
+
+    const MetricDescription HISTOGRAMS[Metrics::AMOUNT_OF_HISTOGRAMS] = {
+            {"blackjack_action_latency_seconds", "", "Time from a question of a table to the answer of its player."},
+            {"blackjack_fsync_latency_seconds", "", "Time an fsync of the account store takes."}};
+
+    // The upper bounds of the buckets in seconds. The players think for seconds, while an fsync takes milliseconds
+    const double BUCKET_BOUNDS[Metrics::AMOUNT_OF_HISTOGRAMS][Metrics::BUCKETS_PER_HISTOGRAM] = {
+            {0.001, 0.01, 0.1, 0.25, 0.5, 1, 2, 4, 8, 16},
+            {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1}};
+
+    /**
+     * This function adds the HELP and TYPE lines of the input "description" to "text", unless the metric before it
+     * ("previous", or nullptr for the first one) has the same name.
+     */
+    void writeHeader(std::ostringstream &text, const MetricDescription &description, const char *type,
+                     const MetricDescription *previous) {
+        if (previous != nullptr && string(previous->name) == description.name) {
+            return;
+        }
+        text << "# HELP " << description.name << " " << description.help << "\n";
+        text << "# TYPE " << description.name << " " << type << "\n";
+    }
+
+    /**
+     * This function returns the labels of the input "description" between curly braces, with "extraLabel" added if it
+     * is not empty, or an empty string if there are no labels at all.
+     */
+    string formatLabels(const MetricDescription &description, const string &extraLabel) {
+        string labels = description.labels;
+        if (!extraLabel.empty()) {
+            labels += (labels.empty() ? "" : ",") + extraLabel;
+        }
+        return labels.empty() ? "" : "{" + labels + "}";
+    }
+}
+
+std::mutex Metrics::allThreadsMutex;
+vector<std::unique_ptr<Metrics::ThreadNumbers>> Metrics::allThreads;
+
+/**
+ * This function creates the numbers of the calling thread and keeps them with those of all threads.
+ */
+Metrics::ThreadNumbers *Metrics::registerThread() {
+    std::lock_guard<std::mutex> lock(allThreadsMutex);
+    allThreads.push_back(std::make_unique<ThreadNumbers>());
+    return allThreads.back().get();
+}
+
+/**
+ * This function counts an observation of "seconds" seconds in the input "histogram".
+ */
+void Metrics::observe(Histogram histogram, double seconds) {
+    int bucket = 0;
+    while (bucket < BUCKETS_PER_HISTOGRAM && seconds > BUCKET_BOUNDS[histogram][bucket]) {
+        bucket++;
+    }
+    ThreadNumbers &numbers = forThisThread();
+    add<uint64_t>(numbers.buckets[histogram][bucket], 1);
+    add<uint64_t>(numbers.observedNanoseconds[histogram], (uint64_t) std::llround(std::max(0.0, seconds) * 1e9));
+}
+
+/**
+ * This function returns all metrics, added up over all threads, in the text format of Prometheus.
+ */
+string Metrics::scrape() {
+    uint64_t counters[AMOUNT_OF_COUNTERS] = {};
+    int64_t gauges[AMOUNT_OF_GAUGES] = {};
+    uint64_t buckets[AMOUNT_OF_HISTOGRAMS][BUCKETS_PER_HISTOGRAM + 1] = {};
+    uint64_t observedNanoseconds[AMOUNT_OF_HISTOGRAMS] = {};
+    {
+        std::lock_guard<std::mutex> lock(allThreadsMutex);
+        for (const std::unique_ptr<ThreadNumbers> &numbers : allThreads) {
+            for (int counter = 0; counter < AMOUNT_OF_COUNTERS; ++counter) {
+                counters[counter] += numbers->counters[counter].load(std::memory_order_relaxed);
+            }
+            for (int gauge = 0; gauge < AMOUNT_OF_GAUGES; ++gauge) {
+                gauges[gauge] += numbers->gaugeChanges[gauge].load(std::memory_order_relaxed);
+            }
+            for (int histogram = 0; histogram < AMOUNT_OF_HISTOGRAMS; ++histogram) {
+                for (int bucket = 0; bucket <= BUCKETS_PER_HISTOGRAM; ++bucket) {
+                    buckets[histogram][bucket] += numbers->buckets[histogram][bucket].load(std::memory_order_relaxed);
+                }
+                observedNanoseconds[histogram] +=
+                        numbers->observedNanoseconds[histogram].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::ostringstream text;
+    text.precision(12);
+    for (int counter = 0; counter < AMOUNT_OF_COUNTERS; ++counter) {
+        writeHeader(text, COUNTERS[counter], "counter", counter > 0 ? &COUNTERS[counter - 1] : nullptr);
+        text << COUNTERS[counter].name << formatLabels(COUNTERS[counter], "") << " " << counters[counter] << "\n";
+    }
+    for (int gauge = 0; gauge < AMOUNT_OF_GAUGES; ++gauge) {
+        writeHeader(text, GAUGES[gauge], "gauge", gauge > 0 ? &GAUGES[gauge - 1] : nullptr);
+        text << GAUGES[gauge].name << formatLabels(GAUGES[gauge], "") << " " << gauges[gauge] << "\n";
+    }
+    // The buckets of a Prometheus histogram are cumulative: every bucket also counts the observations below it
+    for (int histogram = 0; histogram < AMOUNT_OF_HISTOGRAMS; ++histogram) {
+        const MetricDescription &description = HISTOGRAMS[histogram];
+        writeHeader(text, description, "histogram", histogram > 0 ? &HISTOGRAMS[histogram - 1] : nullptr);
+        uint64_t observations = 0;
+        for (int bucket = 0; bucket <= BUCKETS_PER_HISTOGRAM; ++bucket) {
+            observations += buckets[histogram][bucket];
+            std::ostringstream bound;
+            if (bucket < BUCKETS_PER_HISTOGRAM) {
+                bound << BUCKET_BOUNDS[histogram][bucket];
+            } else {
+                bound << "+Inf";
+            }
+            text << description.name << "_bucket" << formatLabels(description, "le=\"" + bound.str() + "\"") << " "
+                 << observations << "\n";
+        }
+        text << description.name << "_sum" << formatLabels(description, "") << " "
+             << observedNanoseconds[histogram] / 1e9 << "\n";
+        text << description.name << "_count" << formatLabels(description, "") << " " << observations << "\n";
+    }
+    return text.str();
+}
+
+/**
+ * Constructor for an endpoint that serves the metrics at "http://127.0.0.1:<port>/metrics", where <port> is the
+ * input "port". It only listens on the local computer, so the metrics are not visible from the network.
+ */
+MetricsEndpoint::MetricsEndpoint(int port) : PORT(port) {
+#ifdef _WIN32
+    WSADATA winsockData;
+    if (WSAStartup(MAKEWORD(2, 2), &winsockData) != 0) {
+        cerr << "Error: the sockets for the metrics endpoint could not be started" << endl;
+        exit(-1);
+    }
+#endif
+    SocketHandle listener = socket(AF_INET, SOCK_STREAM, 0);
+    // Allowing the port to be used again straight away when the program is restarted
+    int reuseAddress = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char *) &reuseAddress, sizeof(reuseAddress));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t) PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (listener == INVALID_SOCKET || bind(listener, (sockaddr *) &address, sizeof(address)) != 0 ||
+        listen(listener, 16) != 0) {
+        cerr << "Error: the metrics endpoint could not listen on port " << PORT << endl;
+        exit(-1);
+    }
+    listeningSocket = (std::uintptr_t) listener;
+
+    serveThread = std::thread([this]() {
+        SocketHandle listener = (SocketHandle) listeningSocket;
+        while (!isStopping) {
+            // Waiting for a scraper at most 100 ms at a time, so the thread notices when it has to stop
+            fd_set readable;
+            FD_ZERO(&readable);
+            FD_SET(listener, &readable);
+            timeval timeout = {0, 100000};
+            if (select((int) listener + 1, &readable, nullptr, nullptr, &timeout) <= 0) {
+                continue;
+            }
+            SocketHandle connection = accept(listener, nullptr, nullptr);
+            if (connection != INVALID_SOCKET) {
+                answerRequest((std::uintptr_t) connection);
+                closeSocket(connection);
+            }
+        }
+    });
+}
+
+/**
+ * Destructor: stops serving the metrics.
+ */
+MetricsEndpoint::~MetricsEndpoint() {
+    isStopping = true;
+    serveThread.join();
+    closeSocket((SocketHandle) listeningSocket);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+/**
+ * This function answers the HTTP request on the input "connection" (accepted on the listening socket): the metrics
+ * for "GET /metrics", and an error otherwise.
+ */
+void MetricsEndpoint::answerRequest(std::uintptr_t connection) {
+    SocketHandle client = (SocketHandle) connection;
+    // A scraper that does not send its request within a second is not waited for any longer
+#ifdef _WIN32
+    DWORD receiveTimeout = 1000;
+#else
+    timeval receiveTimeout = {1, 0};
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char *) &receiveTimeout, sizeof(receiveTimeout));
+
+    // Only the request line is used, but the headers are read up to the empty line that ends them
+    string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == string::npos && request.size() < 16384) {
+        int amountReceived = (int) recv(client, buffer, sizeof(buffer), 0);
+        if (amountReceived <= 0) {
+            return;
+        }
+        request.append(buffer, amountReceived);
+    }
+
+    string status = "200 OK";
+    string body;
+    if (request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET /metrics?", 0) == 0) {
+        body = Metrics::scrape();
+    } else if (request.rfind("GET ", 0) != 0) {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    } else {
+        status = "404 Not Found";
+        body = "The metrics are at /metrics\n";
+    }
+    string response = "HTTP/1.1 " + status + "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                      "Content-Length: " + to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        int amountSent = (int) send(client, response.data() + sent, (int) (response.size() - sent), SEND_FLAGS);
+        if (amountSent <= 0) {
+            break;
+        }
+        sent += amountSent;
+    }
+}
@@ -0,0 +1,156 @@
+/**
+ * The Metrics class keeps the numbers an operator watches while the tables are running, and the MetricsEndpoint
+ * serves them over HTTP on the local computer in the text format of Prometheus, so a Prometheus server (or curl) can
+ * collect them from "http://127.0.0.1:<port>/metrics". There are three kinds of metrics:
+ *  - counters, which only go up: rounds, actions of the players, events published to spectators and bytes written to
+ *    the screen, the event log and the account log. A rate like rounds per second is calculated from two scrapes;
+ *  - gauges, which go up and down: the tables that are open, and the depths of the queues (coroutines that can go on,
+ *    running timers of the CoroutineScheduler and account records waiting for the next fsync);
+ *  - histograms, which count observations in buckets: how long the players take to act, and how long an fsync of the
+ *    AccountStore takes. Every bucket counts the observations up to its bound.
+ *
+ * Unlike the Instrumentation (see Instrumentation.h), the metrics are always on, so they must be cheap. Every thread
+ * adds to its own numbers, without locks or atomic read-modify-writes, and a gauge is kept as the sum of the changes
+ * made by all threads. The numbers of all threads are only added up when the metrics are scraped. The numbers of
+ * finished threads are kept, so the counters never go down.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_METRICS_H
+#define PIE_CPP_BLACKJACK_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::vector;
+
+class Metrics {
+public:
+    enum Counter {
+        ROUNDS,
+        ACTIONS,
+        EVENTS_PUBLISHED,
+        BYTES_TO_SCREEN,
+        BYTES_TO_EVENT_LOG,
+        BYTES_TO_ACCOUNT_LOG,
+        AMOUNT_OF_COUNTERS
+    };
+
+    enum Gauge {
+        OPEN_TABLES,
+        READY_COROUTINES,
+        RUNNING_TIMERS,
+        PENDING_ACCOUNT_RECORDS,
+        AMOUNT_OF_GAUGES
+    };
+
+    enum Histogram {
+        ACTION_LATENCY,
+        FSYNC_LATENCY,
+        AMOUNT_OF_HISTOGRAMS
+    };
+
+    static const int BUCKETS_PER_HISTOGRAM = 10; // plus one for the observations above the highest bound
+
+private:
+    // The numbers of one thread. Only that thread writes them, so a relaxed load and store is enough to add to them,
+    // while the endpoint can still read them
+    struct alignas(64) ThreadNumbers {
+        std::atomic<uint64_t> counters[AMOUNT_OF_COUNTERS] = {};
+        std::atomic<int64_t> gaugeChanges[AMOUNT_OF_GAUGES] = {};
+        std::atomic<uint64_t> buckets[AMOUNT_OF_HISTOGRAMS][BUCKETS_PER_HISTOGRAM + 1] = {};
+        std::atomic<uint64_t> observedNanoseconds[AMOUNT_OF_HISTOGRAMS] = {};
+    };
+
+    static inline thread_local ThreadNumbers *threadNumbers = nullptr;
+
+    // The numbers of all threads that have changed a metric. They are never freed, so the numbers of finished threads
+    // are still counted
+    static std::mutex allThreadsMutex;
+    static vector<std::unique_ptr<ThreadNumbers>> allThreads;
+
+    /**
+     * This function creates the numbers of the calling thread and keeps them with those of all threads.
+     */
+    static ThreadNumbers *registerThread();
+
+    /**
+     * This function returns the numbers of the calling thread, which are created the first time.
+     */
+    static ThreadNumbers &forThisThread() {
+        if (threadNumbers == nullptr) {
+            threadNumbers = registerThread();
+        }
+        return *threadNumbers;
+    }
+
+    /**
+     * This function adds the input "amount" to the input "number", which only the calling thread writes.
+     */
+    template<typename T>
+    static void add(std::atomic<T> &number, T amount) {
+        number.store(number.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+public:
+    /**
+     * This function adds the input "amount" to the input "counter".
+     */
+    static void count(Counter counter, uint64_t amount) {
+        add(forThisThread().counters[counter], amount);
+    }
+
+    /**
+     * This function changes the input "gauge" by "change" (which can be negative).
+     */
+    static void changeGauge(Gauge gauge, int64_t change) {
+        add(forThisThread().gaugeChanges[gauge], change);
+    }
+
+    /**
+     * This function counts an observation of "seconds" seconds in the input "histogram".
+     */
+    static void observe(Histogram histogram, double seconds);
+
+    /**
+     * This function returns all metrics, added up over all threads, in the text format of Prometheus.
+     */
+    static string scrape();
+};
+
+// Serves the Metrics over HTTP on a background thread
+class MetricsEndpoint {
+private:
+    const int PORT;
+    std::uintptr_t listeningSocket; // a SOCKET on Windows and a file descriptor elsewhere
+    std::atomic<bool> isStopping{false};
+    std::thread serveThread;
+
+    /**
+     * This function answers the HTTP request on the input "connection" (accepted on the listening socket): the
+     * metrics for "GET /metrics", and an error otherwise.
+     */
+    static void answerRequest(std::uintptr_t connection);
+
+public:
+    /**
+     * Constructor for an endpoint that serves the metrics at "http://127.0.0.1:<port>/metrics", where <port> is the
+     * input "port". It only listens on the local computer, so the metrics are not visible from the network.
+     */
+    explicit MetricsEndpoint(int port);
+
+    /**
+     * Destructor: stops serving the metrics.
+     */
+    ~MetricsEndpoint();
+
+    MetricsEndpoint(const MetricsEndpoint &) = delete;
+    MetricsEndpoint &operator=(const MetricsEndpoint &) = delete;
+};
+
+
+#endif //PIE_CPP_BLACKJACK_METRICS_H
@@ -0,0 +1,121 @@
+/**
+ * The Money class is an exact amount of money, stored as a whole number of cents. Amounts of money used to be doubles,
+ * which cannot store most amounts with cents exactly (0.1 is not a double), so rounding errors slowly built up over
+ * many rounds, and totals depended on the order in which they were added up. Adding up Money is exact and does not
+ * depend on the order, so the totals of simulations are the same no matter how many threads played them.
+ *
+ * Payouts are calculated with a ratio of whole numbers (3:2 or 6:5 for a blackjack, see PayoutRatio). When a payout
+ * does not come out at a whole amount of cents, like 3:2 on a bet of 0.05, it is rounded down to the cent below, as a
+ * casino pays with the chips it has and keeps the fraction.
+ */
+
+#include "Money.h"
+
+#include <cctype>
+#include <cmath>
+#include <iostream>
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cerr, std::endl, std::to_string;
+
+/**
+ * This function returns the amount of "cents" cents.
+ */
+Money Money::fromCents(int64_t cents) {
+    Money amount;
+    amount.cents = cents;
+    return amount;
+}
+
+/**
+ * This function returns the whole amount "amount" (without cents), like a bet placed in the game.
+ */
+Money Money::fromWholeAmount(int64_t amount) {
+    return fromCents(amount * 100);
+}
+
+/**
+ * This function returns the amount "amount" rounded to the nearest cent, for amounts given as a decimal number,
+ * such as command line options.
+ */
+Money Money::fromDecimal(double amount) {
+    return fromCents(std::llround(amount * 100));
+}
+
+/**
+ * This function returns the amount in cents.
+ */
+int64_t Money::getCents() const {
+    return cents;
+}
+
+/**
+ * This function returns the amount as a decimal number, for calculations that do not need to be exact (like a
+ * percentile or a Kelly bet).
+ */
+double Money::toDecimal() const {
+    return cents / 100.0;
+}
+
+/**
+ * This function returns what a bet of this amount pays at the input "ratio", rounded down to a whole cent.
+ */
+Money Money::payout(PayoutRatio ratio) const {
+    // Dividing whole numbers rounds towards zero, which is down for the (positive) bets
+    return fromCents(cents * ratio.numerator / ratio.denominator);
+}
+
+/**
+ * This function returns the amount as text: whole amounts without cents ("12"), others with two decimals
+ * ("12.50"), and a minus sign in front of negative amounts.
+ */
+string Money::toString() const {
+    int64_t absoluteCents = cents < 0 ? -cents : cents;
+    string text = (cents < 0 ? "-" : "") + to_string(absoluteCents / 100);
+    if (absoluteCents % 100 != 0) {
+        text += (absoluteCents % 100 < 10 ? ".0" : ".") + to_string(absoluteCents % 100);
+    }
+    return text;
+}
+
+/**
+ * This function reads a whole amount, like a bet typed by the user, from the input "text" into "amount". It returns
+ * true if the text is a whole number of at most MAXIMUM_WHOLE_AMOUNT_DIGITS digits, and false otherwise (without
+ * changing "amount"), so a number that is too long is rejected instead of overflowing.
+ */
+bool Money::parseWholeAmount(const string &text, Money &amount) {
+    // The length is checked before any digit is added up, so the number always fits
+    if (text.empty() || (int) text.size() > MAXIMUM_WHOLE_AMOUNT_DIGITS) {
+        return false;
+    }
+    int64_t wholeAmount = 0;
+    for (char character : text) {
+        if (!isdigit((unsigned char) character)) {
+            return false;
+        }
+        wholeAmount = wholeAmount * 10 + (character - '0');
+    }
+    amount = fromWholeAmount(wholeAmount);
+    return true;
+}
+
+/**
+ * This function reads a payout ratio from the input "text", written as "3:2" or "6:5". Otherwise an error will be
+ * displayed indicating the problem and the program will be exited.
+ */
+PayoutRatio Money::parsePayoutRatio(const string &text) {
+    if (text == "3:2") {
+        return {3, 2};
+    } else if (text == "6:5") {
+        return {6, 5};
+    }
+    cerr << "Error: the blackjack payout \"" << text << "\" is not \"3:2\" or \"6:5\"" << endl;
+    exit(-1);
+}
+
+/**
+ * This function writes the input "amount" to the input "stream" as text, see Money::toString().
+ */
+std::ostream &operator<<(std::ostream &stream, Money amount) {
+    return stream << amount.toString();
+}
@@ -0,0 +1,109 @@
+/**
+ * The Money class is an exact amount of money, stored as a whole number of cents. Amounts of money used to be doubles,
+ * which cannot store most amounts with cents exactly (0.1 is not a double), so rounding errors slowly built up over
+ * many rounds, and totals depended on the order in which they were added up. Adding up Money is exact and does not
+ * depend on the order, so the totals of simulations are the same no matter how many threads played them.
+ *
+ * Payouts are calculated with a ratio of whole numbers (3:2 or 6:5 for a blackjack, see PayoutRatio). When a payout
+ * does not come out at a whole amount of cents, like 3:2 on a bet of 0.05, it is rounded down to the cent below, as a
+ * casino pays with the chips it has and keeps the fraction.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_MONEY_H
+#define PIE_CPP_BLACKJACK_MONEY_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string;
+
+// The amount a winning bet pays per unit of bet, as a ratio of whole numbers ("numerator" to "denominator")
+struct PayoutRatio {
+    int numerator = 1;
+    int denominator = 1;
+};
+
+class Money {
+private:
+    int64_t cents = 0;
+
+public:
+    static const int MAXIMUM_WHOLE_AMOUNT_DIGITS = 9; // the most digits parseWholeAmount() accepts, fits in an int
+
+    /**
+     * Default constructor: defines an amount of 0.
+     */
+    Money() = default;
+
+    /**
+     * This function returns the amount of "cents" cents.
+     */
+    static Money fromCents(int64_t cents);
+
+    /**
+     * This function returns the whole amount "amount" (without cents), like a bet placed in the game.
+     */
+    static Money fromWholeAmount(int64_t amount);
+
+    /**
+     * This function returns the amount "amount" rounded to the nearest cent, for amounts given as a decimal number,
+     * such as command line options.
+     */
+    static Money fromDecimal(double amount);
+
+    /**
+     * This function returns the amount in cents.
+     */
+    int64_t getCents() const;
+
+    /**
+     * This function returns the amount as a decimal number, for calculations that do not need to be exact (like a
+     * percentile or a Kelly bet).
+     */
+    double toDecimal() const;
+
+    /**
+     * This function returns what a bet of this amount pays at the input "ratio", rounded down to a whole cent.
+     */
+    Money payout(PayoutRatio ratio) const;
+
+    /**
+     * This function returns the amount as text: whole amounts without cents ("12"), others with two decimals
+     * ("12.50"), and a minus sign in front of negative amounts.
+     */
+    string toString() const;
+
+    /**
+     * This function reads a whole amount, like a bet typed by the user, from the input "text" into "amount". It returns
+     * true if the text is a whole number of at most MAXIMUM_WHOLE_AMOUNT_DIGITS digits, and false otherwise (without
+     * changing "amount"), so a number that is too long is rejected instead of overflowing.
+     */
+    static bool parseWholeAmount(const string &text, Money &amount);
+
+    /**
+     * This function reads a payout ratio from the input "text", written as "3:2" or "6:5". Otherwise an error will be
+     * displayed indicating the problem and the program will be exited.
+     */
+    static PayoutRatio parsePayoutRatio(const string &text);
+
+    Money operator+(Money other) const { return fromCents(cents + other.cents); }
+    Money operator-(Money other) const { return fromCents(cents - other.cents); }
+    Money operator-() const { return fromCents(-cents); }
+    Money &operator+=(Money other) { cents += other.cents; return *this; }
+    Money &operator-=(Money other) { cents -= other.cents; return *this; }
+    bool operator==(Money other) const { return cents == other.cents; }
+    bool operator!=(Money other) const { return cents != other.cents; }
+    bool operator<(Money other) const { return cents < other.cents; }
+    bool operator<=(Money other) const { return cents <= other.cents; }
+    bool operator>(Money other) const { return cents > other.cents; }
+    bool operator>=(Money other) const { return cents >= other.cents; }
+};
+
+/**
+ * This function writes the input "amount" to the input "stream" as text, see Money::toString().
+ */
+std::ostream &operator<<(std::ostream &stream, Money amount);
+
+
+#endif //PIE_CPP_BLACKJACK_MONEY_H
@@ -0,0 +1,31 @@
+/**
+ * The Pacer classes define how the game paces itself between card draws. The Blackjack class does not pause the
+ * program itself anymore, but asks the pacer it was given to pause. This way the same round logic can be used with
+ * different kinds of pacing:
+ *  - SleepingPacer: blocks the thread for the requested time, giving the user dramatic pauses in interactive play.
+ *  - ZeroDelayPacer: does not pause at all, for automated play and tests.
+ *
+ * A game with a remote player does not use its pacer: it waits for a timer of the CoroutineScheduler instead, so one
+ * thread can host many tables (see Blackjack::waitSeconds() and AsyncTable.h).
+ */
+
+#include "Pacer.h"
+
+// Including <chrono> and <thread> in order to be able to add timed pauses to the code according to:
+// https://cplusplus.com/reference/thread/this_thread/sleep_for/
+#include <chrono>
+#include <thread>
+
+/**
+ * This function uses thread and chrono to sleep the program for as many seconds as specified by the parameter
+ * "secondsToWait". This method of pausing a program was learned from
+ * https://cplusplus.com/reference/thread/this_thread/sleep_for/.
+ */
+void SleepingPacer::pause(int secondsToWait) {
+    std::this_thread::sleep_for(std::chrono::seconds(secondsToWait));
+}
+
+/**
+ * This function returns immediately, so the game runs without any pauses.
+ */
+void ZeroDelayPacer::pause(int /*secondsToWait*/) {}
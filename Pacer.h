@@ -0,0 +1,45 @@
+/**
+ * The Pacer classes define how the game paces itself between card draws. The Blackjack class does not pause the
+ * program itself anymore, but asks the pacer it was given to pause. This way the same round logic can be used with
+ * different kinds of pacing:
+ *  - SleepingPacer: blocks the thread for the requested time, giving the user dramatic pauses in interactive play.
+ *  - ZeroDelayPacer: does not pause at all, for automated play and tests.
+ *
+ * A game with a remote player does not use its pacer: it waits for a timer of the CoroutineScheduler instead, so one
+ * thread can host many tables (see Blackjack::waitSeconds() and AsyncTable.h).
+ */
+
+#ifndef PIE_CPP_BLACKJACK_PACER_H
+#define PIE_CPP_BLACKJACK_PACER_H
+
+class Pacer {
+public:
+    virtual ~Pacer() = default;
+
+    /**
+     * This function pauses the game for as many seconds as specified by the parameter "secondsToWait". How the pause
+     * is implemented (blocking or not at all) depends on the type of pacer.
+     */
+    virtual void pause(int secondsToWait) = 0;
+};
+
+class SleepingPacer : public Pacer {
+public:
+    /**
+     * This function uses thread and chrono to sleep the program for as many seconds as specified by the parameter
+     * "secondsToWait". This method of pausing a program was learned from
+     * https://cplusplus.com/reference/thread/this_thread/sleep_for/.
+     */
+    void pause(int secondsToWait) override;
+};
+
+class ZeroDelayPacer : public Pacer {
+public:
+    /**
+     * This function returns immediately, so the game runs without any pauses.
+     */
+    void pause(int secondsToWait) override;
+};
+
+
+#endif //PIE_CPP_BLACKJACK_PACER_H
@@ -0,0 +1,61 @@
+/**
+ * The PlayerPolicy class defines how a simulated player decides between hitting (receiving another card) and standing
+ * (stop receiving cards). In the console game the user makes this decision, but simulations need a policy that can
+ * make it millions of times without a user.
+ *
+ * The BasicStrategyPolicy class follows basic strategy for a game where only hitting and standing are allowed: always
+ * hit a total of 11 or less, stand on a hard 17 or more, stand on 12-16 when the dealer shows a weak card (2-6, except
+ * 12 against 2, 3 and 4), and hit a soft total of 17 or less (and a soft 18 against 9, 10 and Ace). The decisions are
+ * not copied by hand from a strategy card, but calculated for the rules of the game by the StrategyChartGenerator and
+ * stored in BasicStrategyChart.h. The well known chart stands on 12 against a 4, but the game concludes the round as
+ * soon as the player reaches 21, before the dealer draws, which makes hitting there slightly better.
+ *
+ * Two simpler policies are there to compare basic strategy with (see PolicyComparison.h): the MimicDealerPolicy plays
+ * like the dealer (hit below 17), and the NeverBustPolicy only hits when the next card cannot bust the hand.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_PLAYERPOLICY_H
+#define PIE_CPP_BLACKJACK_PLAYERPOLICY_H
+
+class PlayerPolicy {
+public:
+    virtual ~PlayerPolicy() = default;
+
+    /**
+     * This function returns true if the player should hit and false if the player should stand. The decision is based
+     * on the optimal sum of the player's hand ("playerSum"), whether that sum counts an Ace as 11 ("isSoft"), the game
+     * value of the dealer's open card ("dealerCardValue", where an Ace is 11) and the current true count of the cards
+     * ("trueCount", 0 if the cards are not counted).
+     */
+    virtual bool shouldHit(int playerSum, bool isSoft, int dealerCardValue, double trueCount) = 0;
+};
+
+class BasicStrategyPolicy : public PlayerPolicy {
+public:
+    /**
+     * This function returns true if basic strategy says to hit the hand and false if it says to stand. The true count
+     * is ignored, as basic strategy does not depend on it.
+     */
+    bool shouldHit(int playerSum, bool isSoft, int dealerCardValue, double trueCount) override;
+};
+
+class MimicDealerPolicy : public PlayerPolicy {
+public:
+    /**
+     * This function returns true if the dealer would hit the hand: if the sum is below 17. The dealer's card and the
+     * true count are ignored.
+     */
+    bool shouldHit(int playerSum, bool isSoft, int dealerCardValue, double trueCount) override;
+};
+
+class NeverBustPolicy : public PlayerPolicy {
+public:
+    /**
+     * This function returns true if the next card cannot bust the hand: a hard total of 11 or less, or a soft total
+     * of 17 or less. The dealer's card and the true count are ignored.
+     */
+    bool shouldHit(int playerSum, bool isSoft, int dealerCardValue, double trueCount) override;
+};
+
+
+#endif //PIE_CPP_BLACKJACK_PLAYERPOLICY_H
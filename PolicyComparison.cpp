@@ -0,0 +1,398 @@
+/**
+ * The PolicyComparison class compares two variants of the game: two player policies (see PlayerPolicy.h), two sets of
+ * rules (the hole card rule and the blackjack payout), or both. Two separate simulations would each have the whole
+ * variance of Blackjack in their result, while the difference between two variants is usually small, so they would
+ * need an enormous amount of rounds to tell which variant is better. Instead, the comparison uses variance reduction:
+ *  - common random numbers: both variants play every round on exactly the same cards (see CommonCards). A round in
+ *    which the player is dealt a 20 is then a good round for both, and only the decisions that differ make a
+ *    difference. The shoe (or infinite deck) goes on after the round by the cards of the variant that used the most;
+ *  - antithetic shoes (optional): every round is played a second time on the mirrored cards, in which every rank r is
+ *    replaced by 14 - r (an Ace by a King, a 2 by a Queen, ... a 7 stays a 7). The mirrored cards have the same
+ *    chances, but a round full of high cards is paired with one full of low cards, so the pair varies less;
+ *  - control variates (optional): how often every starting hand (the game values of the player's two cards against
+ *    the dealer's open card) is dealt is known exactly from the cards in the shoe. The difference between the
+ *    variants depends mostly on the starting hand, so the average difference is calculated per starting hand, and
+ *    these averages are weighed with the known chances instead of with how often the hands happened to be dealt
+ *    (post-stratification, which is the same as a control variate for every starting hand).
+ * The result is the difference per round with a 95% confidence interval, and how many times as many rounds two
+ * independent simulations would need for the same precision.
+ *
+ * The rounds are played in blocks that are spread over all cores, and every block has its own shoe seeded with its
+ * block number. All results are counted in tenths of a bet, which are whole numbers for the payouts 3:2 and 6:5, so the
+ * sums are exact and do not depend on the amount of threads.
+ */
+
+#include "PolicyComparison.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "Card.h"
+#include "RoundSimulator.h"
+#include "Shoe.h"
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cout, std::cerr, std::endl;
+
+/**
+ * Constructor for common cards that come from the input "cardSource_". The card source is not copied, so it must
+ * outlive the common cards.
+ */
+CommonCards::CommonCards(CardSource &cardSource_) : cardSource(cardSource_), trueCount(cardSource_.getTrueCount()) {}
+
+/**
+ * This function starts dealing the cards of the current round again from the first card, mirrored (every rank r
+ * is dealt as 14 - r) if "mirror" is true.
+ */
+void CommonCards::replay(bool mirror) {
+    nextCard = 0;
+    mirrored = mirror;
+}
+
+/**
+ * This function returns the game value (an Ace is 11) of card number "index" of the current round, as it was dealt
+ * the last time (mirrored or not). The card must have been dealt.
+ */
+int CommonCards::getGameValue(int index) const {
+    return Card::gameValueOfRank(mirrored ? 14 - ranks[index] : ranks[index]);
+}
+
+/**
+ * This function deals the next card of the current round and returns its rank (1-13).
+ */
+int CommonCards::drawRank() {
+    if (nextCard == ranks.size()) {
+        ranks.push_back(cardSource.drawRank());
+    }
+    int rank = ranks[nextCard++];
+    return mirrored ? 14 - rank : rank;
+}
+
+/**
+ * This function returns the true count of the underlying card source at the start of the current round.
+ */
+double CommonCards::getTrueCount() {
+    return trueCount;
+}
+
+/**
+ * This function does nothing, as all variants play the same round: nextRound() ends it.
+ */
+void CommonCards::finishRound() {}
+
+/**
+ * This function ends the current round: the cards are thrown away and the underlying card source finishes its
+ * round (a shoe may be reshuffled).
+ */
+void CommonCards::nextRound() {
+    ranks.clear();
+    nextCard = 0;
+    cardSource.finishRound();
+    trueCount = cardSource.getTrueCount();
+}
+
+/**
+ * This function adds the sums of "other" to these sums.
+ */
+void ComparisonSums::merge(const ComparisonSums &other) {
+    rounds += other.rounds;
+    samples += other.samples;
+    differences += other.differences;
+    squaredDifferences += other.squaredDifferences;
+    for (int variant = 0; variant < 2; ++variant) {
+        results[variant] += other.results[variant];
+        squaredResults[variant] += other.squaredResults[variant];
+    }
+    startingHandSamples.resize(other.startingHandSamples.size());
+    startingHandDifferences.resize(other.startingHandDifferences.size());
+    startingHandSquaredDifferences.resize(other.startingHandSquaredDifferences.size());
+    for (size_t hand = 0; hand < other.startingHandSamples.size(); ++hand) {
+        startingHandSamples[hand] += other.startingHandSamples[hand];
+        startingHandDifferences[hand] += other.startingHandDifferences[hand];
+        startingHandSquaredDifferences[hand] += other.startingHandSquaredDifferences[hand];
+    }
+}
+
+/**
+ * This function returns the index of the starting hand with the game values "playerCardValues" of the player's
+ * two cards added up (an Ace is 11) against the dealer's open card "dealerCardValue".
+ */
+int PolicyComparison::startingHandIndex(int playerCardValues, int dealerCardValue) {
+    return (playerCardValues - 4) * 10 + (dealerCardValue - 2);
+}
+
+/**
+ * This function returns the result of the input "outcome" in tenths of a bet, when a blackjack pays "payout".
+ */
+int64_t PolicyComparison::tenthsOfBet(RoundOutcome outcome, PayoutRatio payout) {
+    if (outcome == RoundOutcome::PLAYER_BLACKJACK) {
+        return 10 * payout.numerator / payout.denominator;
+    } else if (outcome == RoundOutcome::PLAYER_WIN) {
+        return 10;
+    } else if (outcome == RoundOutcome::PUSH) {
+        return 0;
+    }
+    return -10;
+}
+
+/**
+ * This function returns a new player policy with the input "name". For an unknown name an error is displayed and
+ * the program is exited.
+ */
+std::unique_ptr<PlayerPolicy> PolicyComparison::createPolicy(const string &name) {
+    if (name == "basic") {
+        return std::make_unique<BasicStrategyPolicy>();
+    } else if (name == "mimic") {
+        return std::make_unique<MimicDealerPolicy>();
+    } else if (name == "never-bust") {
+        return std::make_unique<NeverBustPolicy>();
+    }
+    cerr << "Error: player policy \"" << name << "\" is not \"basic\", \"mimic\" or \"never-bust\"" << endl;
+    exit(-1);
+}
+
+/**
+ * This function returns the input "variant" as text, in the form that parseVariant() reads.
+ */
+string PolicyComparison::describeVariant(const ComparisonVariant &variant) {
+    string text = variant.policyName;
+    if (variant.holeCardRule == HoleCardRule::NO_HOLE_CARD) {
+        text += "+enhc";
+    }
+    if (variant.blackjackPayout.numerator != 3 || variant.blackjackPayout.denominator != 2) {
+        text += "+" + std::to_string(variant.blackjackPayout.numerator) + ":" +
+                std::to_string(variant.blackjackPayout.denominator);
+    }
+    return text;
+}
+
+/**
+ * This function returns the variant described by the input "text": a policy name, optionally followed by rules,
+ * separated by "+", like "basic", "mimic+enhc" or "basic+6:5". For an unknown part an error is displayed and the
+ * program is exited.
+ */
+ComparisonVariant PolicyComparison::parseVariant(const string &text) {
+    ComparisonVariant variant;
+    variant.policyName = text.substr(0, text.find('+'));
+    createPolicy(variant.policyName); // exits for an unknown policy
+
+    size_t start = text.find('+');
+    while (start != string::npos) {
+        size_t end = text.find('+', start + 1);
+        string rule = text.substr(start + 1, end == string::npos ? string::npos : end - start - 1);
+        start = end;
+        if (rule == "enhc") {
+            variant.holeCardRule = HoleCardRule::NO_HOLE_CARD;
+        } else if (rule == "peek") {
+            variant.holeCardRule = HoleCardRule::PEEK;
+        } else {
+            variant.blackjackPayout = Money::parsePayoutRatio(rule); // exits for anything but 3:2 and 6:5
+        }
+    }
+    return variant;
+}
+
+/**
+ * Constructor for a PolicyComparison with the input "settings_".
+ */
+PolicyComparison::PolicyComparison(const ComparisonSettings &settings_) : settings(settings_) {
+    sums.startingHandSamples.resize(AMOUNT_OF_STARTING_HANDS);
+    sums.startingHandDifferences.resize(AMOUNT_OF_STARTING_HANDS);
+    sums.startingHandSquaredDifferences.resize(AMOUNT_OF_STARTING_HANDS);
+}
+
+/**
+ * This function returns the chance of every starting hand (see startingHandIndex()) when the player's two cards
+ * and the dealer's open card are dealt from a full shoe (or an infinite deck).
+ */
+vector<double> PolicyComparison::calculateStartingHandChances() const {
+    // The amount of cards per game value (2-11) in the shoe. An infinite deck has the chances of a single deck, which
+    // do not change when a card is dealt
+    bool isInfinite = settings.amountOfDecks <= 0;
+    int amountOfDecks = std::max(1, settings.amountOfDecks);
+    int counts[12] = {};
+    for (int value = 2; value <= 11; ++value) {
+        counts[value] = (value == 10 ? 16 : 4) * amountOfDecks;
+    }
+    int cardsLeft = 52 * amountOfDecks;
+
+    // The cards are dealt in the order of the table: the player, the dealer's open card, the player
+    vector<double> chances(AMOUNT_OF_STARTING_HANDS, 0.0);
+    int taken = isInfinite ? 0 : 1;
+    for (int first = 2; first <= 11; ++first) {
+        double firstChance = (double) counts[first] / cardsLeft;
+        counts[first] -= taken;
+        for (int dealer = 2; dealer <= 11; ++dealer) {
+            double dealerChance = (double) counts[dealer] / (cardsLeft - taken);
+            counts[dealer] -= taken;
+            for (int second = 2; second <= 11; ++second) {
+                double secondChance = (double) counts[second] / (cardsLeft - 2 * taken);
+                chances[startingHandIndex(first + second, dealer)] += firstChance * dealerChance * secondChance;
+            }
+            counts[dealer] += taken;
+        }
+        counts[first] += taken;
+    }
+    return chances;
+}
+
+/**
+ * This function plays the rounds of block number "block" with a card source seeded with the block number, and adds
+ * them to the input "blockSums".
+ */
+void PolicyComparison::compareBlock(long long block, ComparisonSums &blockSums) {
+    std::unique_ptr<CardSource> cardSource;
+    if (settings.amountOfDecks > 0) {
+        cardSource = std::make_unique<Shoe>(settings.amountOfDecks, settings.penetration, settings.seed + block);
+    } else {
+        cardSource = std::make_unique<InfiniteDeck>(settings.seed + block);
+    }
+    CommonCards cards(*cardSource);
+
+    std::unique_ptr<PlayerPolicy> policies[2];
+    vector<RoundSimulator> simulators;
+    simulators.reserve(2);
+    for (int variant = 0; variant < 2; ++variant) {
+        policies[variant] = createPolicy(settings.variants[variant].policyName);
+        simulators.emplace_back(cards, *policies[variant]);
+        simulators[variant].setHoleCardRule(settings.variants[variant].holeCardRule);
+    }
+
+    int roundsPerSample = settings.antitheticShoes ? 2 : 1;
+    long long roundsInBlock = std::min((long long) ROUNDS_PER_BLOCK, settings.rounds - block * ROUNDS_PER_BLOCK);
+    for (long long round = 0; round < roundsInBlock; round += roundsPerSample) {
+        int64_t difference = 0;
+        int startingHand = 0;
+        for (int mirror = 0; mirror < roundsPerSample; ++mirror) {
+            int64_t results[2];
+            for (int variant = 0; variant < 2; ++variant) {
+                cards.replay(mirror == 1);
+                results[variant] = tenthsOfBet(simulators[variant].playRound(),
+                                               settings.variants[variant].blackjackPayout);
+                blockSums.results[variant] += results[variant];
+                blockSums.squaredResults[variant] += results[variant] * results[variant];
+            }
+            blockSums.rounds++;
+            difference += results[1] - results[0];
+            // The first three cards are always dealt: the player's first card, the dealer's open card and the
+            // player's second card. A pair of antithetic rounds belongs to the starting hand of the first round
+            if (mirror == 0) {
+                startingHand = startingHandIndex(cards.getGameValue(0) + cards.getGameValue(2), cards.getGameValue(1));
+            }
+        }
+        cards.nextRound();
+
+        blockSums.samples++;
+        blockSums.differences += difference;
+        blockSums.squaredDifferences += difference * difference;
+        blockSums.startingHandSamples[startingHand]++;
+        blockSums.startingHandDifferences[startingHand] += difference;
+        blockSums.startingHandSquaredDifferences[startingHand] += difference * difference;
+    }
+}
+
+/**
+ * This function plays all rounds, spread over the threads, and merges their sums.
+ */
+void PolicyComparison::run() {
+    auto startTime = std::chrono::steady_clock::now();
+
+    int amountOfThreads = settings.threads;
+    if (amountOfThreads <= 0) {
+        amountOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    long long amountOfBlocks = (settings.rounds + ROUNDS_PER_BLOCK - 1) / ROUNDS_PER_BLOCK;
+
+    // The threads take the next block that has not been played yet, and every thread has its own sums
+    std::atomic<long long> nextBlock(0);
+    vector<ComparisonSums> threadSums(amountOfThreads, sums);
+    vector<std::thread> threads;
+    for (int t = 0; t < amountOfThreads; ++t) {
+        threads.emplace_back([this, t, amountOfBlocks, &nextBlock, &threadSums]() {
+            for (long long block = nextBlock++; block < amountOfBlocks; block = nextBlock++) {
+                compareBlock(block, threadSums[t]);
+            }
+        });
+    }
+
+    for (int t = 0; t < amountOfThreads; ++t) {
+        threads[t].join();
+        sums.merge(threadSums[t]);
+    }
+
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * This function prints the result of both variants and their difference, with 95% confidence intervals, to the
+ * console.
+ */
+void PolicyComparison::printReport() {
+    const double Z_95 = 1.959964; // a 95% confidence interval is this many standard errors wide on both sides
+
+    double rounds = (double) std::max<int64_t>(1, sums.rounds);
+    double samples = (double) std::max<int64_t>(1, sums.samples);
+    double roundsPerSample = settings.antitheticShoes ? 2 : 1;
+
+    cout << "Comparing " << describeVariant(settings.variants[0]) << " with " << describeVariant(settings.variants[1])
+         << " over " << sums.rounds << " rounds each ("
+         << (settings.amountOfDecks > 0 ? std::to_string(settings.amountOfDecks) + " decks" : string("infinite deck"))
+         << ", common cards" << (settings.antitheticShoes ? ", antithetic shoes" : "")
+         << (settings.controlVariates ? ", control variates" : "") << ") in " << elapsedSeconds << " s" << endl;
+
+    // Every variant on its own, as an independent simulation would measure it (in tenths of a bet)
+    double independentVariance = 0;
+    for (int variant = 0; variant < 2; ++variant) {
+        double mean = sums.results[variant] / rounds;
+        double variance = sums.squaredResults[variant] / rounds - mean * mean;
+        independentVariance += variance;
+        cout << describeVariant(settings.variants[variant]) << ": " << mean * 10 << "% per round (+/- "
+             << Z_95 * std::sqrt(variance / rounds) * 10 << "%)" << endl;
+    }
+
+    // The difference per sample, and its variance
+    double meanDifference = sums.differences / samples;
+    double differenceVariance = sums.squaredDifferences / samples - meanDifference * meanDifference;
+
+    if (settings.controlVariates) {
+        // The averages per starting hand, weighed with the known chances of the starting hands. The rare starting
+        // hands that were never dealt are left out, and the chances of the others are scaled up to make up for them
+        vector<double> chances = calculateStartingHandChances();
+        double chanceOfDealtHands = 0;
+        double weighedDifference = 0;
+        double weighedVariance = 0;
+        for (int hand = 0; hand < AMOUNT_OF_STARTING_HANDS; ++hand) {
+            double handSamples = (double) sums.startingHandSamples[hand];
+            if (handSamples == 0) {
+                continue;
+            }
+            double handMean = sums.startingHandDifferences[hand] / handSamples;
+            double handVariance = sums.startingHandSquaredDifferences[hand] / handSamples - handMean * handMean;
+            chanceOfDealtHands += chances[hand];
+            weighedDifference += chances[hand] * handMean;
+            weighedVariance += chances[hand] * chances[hand] * handVariance / handSamples;
+        }
+        meanDifference = weighedDifference / chanceOfDealtHands;
+        // Stored as the variance of a single sample, like without control variates
+        differenceVariance = weighedVariance / (chanceOfDealtHands * chanceOfDealtHands) * samples;
+    }
+
+    // Per round instead of per sample; a sample of two antithetic rounds holds the sum of both differences
+    double difference = meanDifference / roundsPerSample;
+    double standardError = std::sqrt(std::max(0.0, differenceVariance) / samples) / roundsPerSample;
+    double independentStandardError = std::sqrt(independentVariance / rounds);
+    cout << "Difference (" << describeVariant(settings.variants[1]) << " - " << describeVariant(settings.variants[0])
+         << "): " << difference * 10 << "% per round (+/- " << Z_95 * standardError * 10 << "%)" << endl;
+    if (standardError > 0) {
+        cout << "Two independent simulations would need "
+             << (independentStandardError * independentStandardError) / (standardError * standardError)
+             << " times as many rounds for this precision" << endl;
+    } else {
+        cout << "The variants played every round the same" << endl;
+    }
+}
@@ -0,0 +1,204 @@
+/**
+ * The PolicyComparison class compares two variants of the game: two player policies (see PlayerPolicy.h), two sets of
+ * rules (the hole card rule and the blackjack payout), or both. Two separate simulations would each have the whole
+ * variance of Blackjack in their result, while the difference between two variants is usually small, so they would
+ * need an enormous amount of rounds to tell which variant is better. Instead, the comparison uses variance reduction:
+ *  - common random numbers: both variants play every round on exactly the same cards (see CommonCards). A round in
+ *    which the player is dealt a 20 is then a good round for both, and only the decisions that differ make a
+ *    difference. The shoe (or infinite deck) goes on after the round by the cards of the variant that used the most;
+ *  - antithetic shoes (optional): every round is played a second time on the mirrored cards, in which every rank r is
+ *    replaced by 14 - r (an Ace by a King, a 2 by a Queen, ... a 7 stays a 7). The mirrored cards have the same
+ *    chances, but a round full of high cards is paired with one full of low cards, so the pair varies less;
+ *  - control variates (optional): how often every starting hand (the game values of the player's two cards against
+ *    the dealer's open card) is dealt is known exactly from the cards in the shoe. The difference between the
+ *    variants depends mostly on the starting hand, so the average difference is calculated per starting hand, and
+ *    these averages are weighed with the known chances instead of with how often the hands happened to be dealt
+ *    (post-stratification, which is the same as a control variate for every starting hand).
+ * The result is the difference per round with a 95% confidence interval, and how many times as many rounds two
+ * independent simulations would need for the same precision.
+ *
+ * The rounds are played in blocks that are spread over all cores, and every block has its own shoe seeded with its
+ * block number. All results are counted in tenths of a bet, which are whole numbers for the payouts 3:2 and 6:5, so the
+ * sums are exact and do not depend on the amount of threads.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_POLICYCOMPARISON_H
+#define PIE_CPP_BLACKJACK_POLICYCOMPARISON_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::vector;
+
+#include "Blackjack.h"
+#include "CardSource.h"
+#include "Money.h"
+#include "PlayerPolicy.h"
+
+// A variant of the game: a player policy ("basic", "mimic" or "never-bust") with a set of rules
+struct ComparisonVariant {
+    string policyName = "basic";
+    HoleCardRule holeCardRule = HoleCardRule::PEEK;
+    PayoutRatio blackjackPayout = {3, 2};
+};
+
+struct ComparisonSettings {
+    ComparisonVariant variants[2];
+    int amountOfDecks = 6; // 0 uses an infinite deck
+    double penetration = 0.75;
+    long long rounds = 10000000;
+    int threads = 0; // 0 uses all cores of the computer
+    uint64_t seed = 1;
+    bool antitheticShoes = false;
+    bool controlVariates = false;
+};
+
+/**
+ * The CommonCards class is a card source that deals the same cards to every variant of a round. The cards of a round are
+ * drawn from the underlying card source the first time a variant needs them and kept, so a variant that needs more
+ * cards than the ones before it draws new ones, which the later variants get as well.
+ */
+class CommonCards : public CardSource {
+private:
+    CardSource &cardSource;
+    vector<int> ranks; // the cards of the current round
+    size_t nextCard = 0;
+    bool mirrored = false;
+    double trueCount = 0;
+
+public:
+    /**
+     * Constructor for common cards that come from the input "cardSource_". The card source is not copied, so it must
+     * outlive the common cards.
+     */
+    explicit CommonCards(CardSource &cardSource_);
+
+    /**
+     * This function starts dealing the cards of the current round again from the first card, mirrored (every rank r
+     * is dealt as 14 - r) if "mirror" is true.
+     */
+    void replay(bool mirror);
+
+    /**
+     * This function returns the game value (an Ace is 11) of card number "index" of the current round, as it was dealt
+     * the last time (mirrored or not). The card must have been dealt.
+     */
+    int getGameValue(int index) const;
+
+    /**
+     * This function deals the next card of the current round and returns its rank (1-13).
+     */
+    int drawRank() override;
+
+    /**
+     * This function returns the true count of the underlying card source at the start of the current round.
+     */
+    double getTrueCount() override;
+
+    /**
+     * This function does nothing, as all variants play the same round: nextRound() ends it.
+     */
+    void finishRound() override;
+
+    /**
+     * This function ends the current round: the cards are thrown away and the underlying card source finishes its
+     * round (a shoe may be reshuffled).
+     */
+    void nextRound();
+};
+
+// The sums of a number of rounds, in tenths of a bet. A sample is a round, or a pair of rounds with antithetic shoes
+struct ComparisonSums {
+    int64_t rounds = 0;
+    int64_t results[2] = {};        // of every variant, per round
+    int64_t squaredResults[2] = {};
+    int64_t samples = 0;
+    int64_t differences = 0;        // of the second variant minus the first
+    int64_t squaredDifferences = 0;
+
+    // The same for the samples of every starting hand (see PolicyComparison::startingHandIndex())
+    vector<int64_t> startingHandSamples;
+    vector<int64_t> startingHandDifferences;
+    vector<int64_t> startingHandSquaredDifferences;
+
+    /**
+     * This function adds the sums of "other" to these sums.
+     */
+    void merge(const ComparisonSums &other);
+};
+
+class PolicyComparison {
+public:
+    // The player's two cards add up to 4-22 (two Aces) and the dealer's open card is 2-11
+    static const int AMOUNT_OF_STARTING_HANDS = 19 * 10;
+
+    /**
+     * This function returns the index of the starting hand with the game values "playerCardValues" of the player's
+     * two cards added up (an Ace is 11) against the dealer's open card "dealerCardValue".
+     */
+    static int startingHandIndex(int playerCardValues, int dealerCardValue);
+
+private:
+    const int ROUNDS_PER_BLOCK = 100000;
+
+    ComparisonSettings settings;
+    ComparisonSums sums;
+    double elapsedSeconds = 0;
+
+    /**
+     * This function returns the result of the input "outcome" in tenths of a bet, when a blackjack pays "payout".
+     */
+    static int64_t tenthsOfBet(RoundOutcome outcome, PayoutRatio payout);
+
+    /**
+     * This function returns a new player policy with the input "name". For an unknown name an error is displayed and
+     * the program is exited.
+     */
+    static std::unique_ptr<PlayerPolicy> createPolicy(const string &name);
+
+    /**
+     * This function returns the input "variant" as text, in the form that parseVariant() reads.
+     */
+    static string describeVariant(const ComparisonVariant &variant);
+
+    /**
+     * This function returns the chance of every starting hand (see startingHandIndex()) when the player's two cards
+     * and the dealer's open card are dealt from a full shoe (or an infinite deck).
+     */
+    vector<double> calculateStartingHandChances() const;
+
+    /**
+     * This function plays the rounds of block number "block" with a card source seeded with the block number, and adds
+     * them to the input "blockSums".
+     */
+    void compareBlock(long long block, ComparisonSums &blockSums);
+
+public:
+    /**
+     * This function returns the variant described by the input "text": a policy name, optionally followed by rules,
+     * separated by "+", like "basic", "mimic+enhc" or "basic+6:5". For an unknown part an error is displayed and the
+     * program is exited.
+     */
+    static ComparisonVariant parseVariant(const string &text);
+
+    /**
+     * Constructor for a PolicyComparison with the input "settings_".
+     */
+    explicit PolicyComparison(const ComparisonSettings &settings_);
+
+    /**
+     * This function plays all rounds, spread over the threads, and merges their sums.
+     */
+    void run();
+
+    /**
+     * This function prints the result of both variants and their difference, with 95% confidence intervals, to the
+     * console.
+     */
+    void printReport();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_POLICYCOMPARISON_H
@@ -0,0 +1,85 @@
+/**
+ * The QuantileSketch class estimates quantiles (such as the median or the 95th percentile) of a stream of values
+ * without storing the values themselves. The range between a minimum and a maximum is divided into a fixed amount of
+ * equally wide bins and every added value only increases the counter of its bin. Values outside the range are counted
+ * in the first or last bin. A quantile is then estimated by walking through the bins until the requested fraction of
+ * values has been passed, interpolating within the bin where this happens. The error of a quantile is therefore at
+ * most the width of one bin.
+ *
+ * Because two sketches with the same range and bins can simply be added together bin by bin, every thread of a
+ * simulation can fill its own sketch without locking, after which the sketches are merged.
+ */
+
+#include "QuantileSketch.h"
+
+#include <iostream>
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::endl, std::cerr;
+
+/**
+ * Constructor for a sketch of values between "minimum_" and "maximum_", divided into "amountOfBins" bins.
+ */
+QuantileSketch::QuantileSketch(double minimum_, double maximum_, int amountOfBins)
+        : minimum(minimum_), maximum(maximum_), binWidth((maximum_ - minimum_) / amountOfBins),
+          binCounts(amountOfBins, 0) {}
+
+/**
+ * This function adds the input "value" to the sketch.
+ */
+void QuantileSketch::add(double value) {
+    int bin = (int) ((value - minimum) / binWidth);
+    // Values outside the range are counted in the first or last bin
+    if (bin < 0) {
+        bin = 0;
+    } else if (bin >= (int) binCounts.size()) {
+        bin = (int) binCounts.size() - 1;
+    }
+    binCounts[bin]++;
+    totalCount++;
+}
+
+/**
+ * This function adds all values of the input sketch "otherSketch" to this sketch. Both sketches must have the same
+ * range and amount of bins.
+ */
+void QuantileSketch::merge(const QuantileSketch &otherSketch) {
+    if (otherSketch.binCounts.size() != binCounts.size() || otherSketch.minimum != minimum ||
+        otherSketch.maximum != maximum) {
+        cerr << "Error: quantile sketches with different ranges or bins cannot be merged" << endl;
+        return;
+    }
+    for (size_t i = 0; i < binCounts.size(); ++i) {
+        binCounts[i] += otherSketch.binCounts[i];
+    }
+    totalCount += otherSketch.totalCount;
+}
+
+/**
+ * This function returns an estimate of the quantile "fraction" (between 0 and 1) of all added values. For example,
+ * getQuantile(0.5) returns the median. If no values have been added, the minimum is returned.
+ */
+double QuantileSketch::getQuantile(double fraction) const {
+    if (totalCount == 0) {
+        return minimum;
+    }
+
+    double targetCount = fraction * totalCount;
+    double countSoFar = 0;
+    for (size_t i = 0; i < binCounts.size(); ++i) {
+        if (binCounts[i] > 0 && countSoFar + binCounts[i] >= targetCount) {
+            // Interpolating linearly within the bin in which the target count is reached
+            double fractionOfBin = (targetCount - countSoFar) / binCounts[i];
+            return minimum + (i + fractionOfBin) * binWidth;
+        }
+        countSoFar += binCounts[i];
+    }
+    return maximum;
+}
+
+/**
+ * This function returns the amount of values added to the sketch.
+ */
+uint64_t QuantileSketch::getCount() const {
+    return totalCount;
+}
@@ -0,0 +1,59 @@
+/**
+ * The QuantileSketch class estimates quantiles (such as the median or the 95th percentile) of a stream of values
+ * without storing the values themselves. The range between a minimum and a maximum is divided into a fixed amount of
+ * equally wide bins and every added value only increases the counter of its bin. Values outside the range are counted
+ * in the first or last bin. A quantile is then estimated by walking through the bins until the requested fraction of
+ * values has been passed, interpolating within the bin where this happens. The error of a quantile is therefore at
+ * most the width of one bin.
+ *
+ * Because two sketches with the same range and bins can simply be added together bin by bin, every thread of a
+ * simulation can fill its own sketch without locking, after which the sketches are merged.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_QUANTILESKETCH_H
+#define PIE_CPP_BLACKJACK_QUANTILESKETCH_H
+
+#include <cstdint>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::vector;
+
+class QuantileSketch {
+private:
+    double minimum;
+    double maximum;
+    double binWidth;
+    vector<uint64_t> binCounts;
+    uint64_t totalCount = 0;
+
+public:
+    /**
+     * Constructor for a sketch of values between "minimum_" and "maximum_", divided into "amountOfBins" bins.
+     */
+    QuantileSketch(double minimum_, double maximum_, int amountOfBins);
+
+    /**
+     * This function adds the input "value" to the sketch.
+     */
+    void add(double value);
+
+    /**
+     * This function adds all values of the input sketch "otherSketch" to this sketch. Both sketches must have the same
+     * range and amount of bins.
+     */
+    void merge(const QuantileSketch &otherSketch);
+
+    /**
+     * This function returns an estimate of the quantile "fraction" (between 0 and 1) of all added values. For example,
+     * getQuantile(0.5) returns the median. If no values have been added, the minimum is returned.
+     */
+    double getQuantile(double fraction) const;
+
+    /**
+     * This function returns the amount of values added to the sketch.
+     */
+    uint64_t getCount() const;
+};
+
+
+#endif //PIE_CPP_BLACKJACK_QUANTILESKETCH_H
@@ -0,0 +1,192 @@
+/**
+ * The RoundSimulator class plays rounds of Blackjack without a user and without a console, so that millions of rounds
+ * can be simulated quickly. It follows exactly the same course of a round as Blackjack::playRound(): the cards are
+ * dealt in the order of a real table (player, dealer, player, and the dealer's hole card), a dealer that peeks and has
+ * blackjack ends the round, a player with 21 does not get to play, the player hits as long as the policy says so (and
+ * the sum is below 21), and the dealer draws cards as long as their sum is below 17. Without a hole card (see
+ * HoleCardRule), the dealer only gets a second card after the player stands. The outcome is determined with
+ * Blackjack::determineOutcome(), the same function the console game uses.
+ *
+ * Instead of Hand and Card objects, which store strings, the simulator keeps track of a hand with a SimulatedHand: the
+ * sum of the game values, the amount of Aces and the amount of cards. This is all Blackjack::sumOptimal() needs.
+ *
+ * On an infinite deck, the dealer's draws can be skipped altogether: with useDealerTable(), the dealer's final total is
+ * picked from the DealerTable with a single random number. After a peek without a blackjack, a picked blackjack is
+ * picked again, as the final total then only has the chances of the hands without a blackjack.
+ */
+
+#include "RoundSimulator.h"
+
+#include "Card.h"
+#include "DealerTable.h"
+#include "Instrumentation.h"
+
+/**
+ * This function adds a card with the input "rank" (1-13) to the hand.
+ */
+void SimulatedHand::addRank(int rank) {
+    if (cardCount == 0) {
+        firstCardValue = Card::gameValueOfRank(rank);
+    }
+    sumOfGameValues += Card::gameValueOfRank(rank);
+    if (rank == 1) {
+        numberOfAces++;
+    }
+    cardCount++;
+}
+
+/**
+ * This function returns the optimal sum of the hand, see Blackjack::sumOptimal().
+ */
+int SimulatedHand::getSum() const {
+    return Blackjack::sumOptimal(sumOfGameValues, numberOfAces);
+}
+
+/**
+ * This function returns true if the optimal sum of the hand counts an Ace as 11 (a "soft" hand).
+ */
+bool SimulatedHand::isSoft() const {
+    // Every Ace that was reduced from 11 to 1 lowered the sum by 10. If not all Aces were reduced, the hand is soft
+    int sum = getSum();
+    int reducedAces = (sumOfGameValues - sum) / 10;
+    return sum <= 21 && reducedAces < numberOfAces;
+}
+
+/**
+ * This function returns true if the hand is a blackjack, see Blackjack::isBlackjack(). This is how the dealer peeks,
+ * with a single comparison on the packed hand.
+ */
+bool SimulatedHand::isBlackjack() const {
+    return Blackjack::isBlackjack(sumOfGameValues, cardCount);
+}
+
+/**
+ * Constructor for a RoundSimulator that draws its cards from the input "cardSource_" and makes the player's
+ * decisions with the input "policy_". Both are not copied, so they must outlive the RoundSimulator.
+ */
+RoundSimulator::RoundSimulator(CardSource &cardSource_, PlayerPolicy &policy_)
+        : cardSource(cardSource_), policy(policy_) {}
+
+/**
+ * This function makes the simulator pick the dealer's final total from the DealerTable with one random number from
+ * the input "deck", instead of drawing the dealer's cards one by one. The deck has to be the card source of the
+ * simulator, as the table is only valid for an infinite deck.
+ */
+void RoundSimulator::useDealerTable(InfiniteDeck &deck) {
+    dealerTableDeck = &deck;
+}
+
+/**
+ * This function sets whether the dealer gets a hole card and peeks for blackjack ("rule" is PEEK, the default) or only
+ * gets a second card after the player stands (NO_HOLE_CARD), see HoleCardRule.
+ */
+void RoundSimulator::setHoleCardRule(HoleCardRule rule) {
+    holeCardRule = rule;
+}
+
+/**
+ * This function returns the dealer's hand of the current round, as far as it has been dealt. While the player decides,
+ * it holds the open card and (with a hole card) the hole card.
+ */
+const SimulatedHand &RoundSimulator::getDealerHand() const {
+    return dealerHand;
+}
+
+/**
+ * This function plays a full round of Blackjack and returns its outcome. Betting is left to the caller, who can
+ * settle the bet based on the outcome.
+ */
+RoundOutcome RoundSimulator::playRound() {
+    SimulatedHand playerHand;
+    dealerHand = SimulatedHand();
+    INSTRUMENT_COUNT(ROUNDS, 1);
+    INSTRUMENT_COUNT(HANDS, 2);
+
+    // The cards are dealt in the order of a real table: the player, the dealer's open card, the player again and the
+    // dealer's hole card
+    {
+        INSTRUMENT_PHASE(DEAL);
+        playerHand.addRank(cardSource.drawRank());
+        dealerHand.addRank(cardSource.drawRank());
+        playerHand.addRank(cardSource.drawRank());
+        if (holeCardRule == HoleCardRule::PEEK) {
+            dealerHand.addRank(cardSource.drawRank());
+        }
+        INSTRUMENT_COUNT(CARDS_DEALT, dealerHand.cardCount + 2);
+    }
+
+    // A dealer that peeks and has blackjack ends the round before the player's turn
+    RoundOutcome outcome = dealerHand.isBlackjack()
+                           ? Blackjack::determineOutcome(playerHand.getSum(), playerHand.cardCount, dealerHand.getSum(),
+                                                         dealerHand.cardCount)
+                           : finishRound(playerHand, dealerHand, cardSource, policy, dealerTableDeck);
+    cardSource.finishRound();
+    return outcome;
+}
+
+/**
+ * This function finishes a round that has already been dealt, starting at the player's decision with the input
+ * "playerHand" and "dealerHand" (the open card, and the hole card if there is one). The player hits as long as the
+ * input "policy" says so and the cards are drawn from the input "cardSource". If the input "dealerTableDeck" is given,
+ * the dealer's final total is picked from the DealerTable with that deck (see settleWithDealerTable()). It returns the
+ * outcome of the round.
+ */
+RoundOutcome RoundSimulator::finishRound(SimulatedHand playerHand, SimulatedHand dealerHand, CardSource &cardSource,
+                                         PlayerPolicy &policy, InfiniteDeck *dealerTableDeck) {
+    INSTRUMENT_PHASE(PLAYER_DECISION);
+    int dealerCardValue = dealerHand.firstCardValue;
+
+    // Like in the console game, a player with 21 or a player that hits to 21 or more concludes the round straight away,
+    // so the dealer only draws cards after the player stands below 21. Without a hole card, a player with 21 still
+    // waits for the dealer's second card, which can make a blackjack
+    while (playerHand.getSum() < 21) {
+        if (!policy.shouldHit(playerHand.getSum(), playerHand.isSoft(), dealerCardValue, cardSource.getTrueCount())) {
+            if (dealerTableDeck != nullptr) {
+                return settleWithDealerTable(playerHand, dealerHand, *dealerTableDeck);
+            }
+            return standAndSettle(playerHand, dealerHand, cardSource);
+        }
+        playerHand.addRank(cardSource.drawRank());
+        INSTRUMENT_COUNT(CARDS_DEALT, 1);
+    }
+    if (playerHand.getSum() == 21 && dealerHand.cardCount == 1) {
+        dealerHand.addRank(cardSource.drawRank());
+        INSTRUMENT_COUNT(CARDS_DEALT, 1);
+    }
+
+    return Blackjack::determineOutcome(playerHand.getSum(), playerHand.cardCount, dealerHand.getSum(),
+                                       dealerHand.cardCount);
+}
+
+/**
+ * This function finishes a round in which the player stands with the input "playerHand": the dealer draws cards from
+ * the input "cardSource" as long as the sum of the "dealerHand" is below 17. It returns the outcome of the round.
+ */
+RoundOutcome RoundSimulator::standAndSettle(SimulatedHand playerHand, SimulatedHand dealerHand,
+                                            CardSource &cardSource) {
+    INSTRUMENT_PHASE(DEALER_PLAY);
+    while (dealerHand.getSum() < 17) {
+        dealerHand.addRank(cardSource.drawRank());
+        INSTRUMENT_COUNT(CARDS_DEALT, 1);
+    }
+
+    return Blackjack::determineOutcome(playerHand.getSum(), playerHand.cardCount, dealerHand.getSum(),
+                                       dealerHand.cardCount);
+}
+
+/**
+ * This function finishes a round in which the player stands with the input "playerHand" like standAndSettle(), but
+ * picks the dealer's final total from the DealerTable with one random number from the input "deck" instead of
+ * drawing the dealer's cards. The "dealerHand" must only hold the dealer's open card, or the open card and a hole card
+ * that is known not to make a blackjack (then a blackjack is picked again).
+ */
+RoundOutcome RoundSimulator::settleWithDealerTable(SimulatedHand playerHand, SimulatedHand dealerHand,
+                                                   InfiniteDeck &deck) {
+    INSTRUMENT_PHASE(DEALER_PLAY);
+    int final;
+    do {
+        final = DealerTable::sampleFinalTotal(dealerHand.firstCardValue, deck.drawRandomBits());
+    } while (final == DealerTable::FINAL_BLACKJACK && dealerHand.cardCount == 2);
+    return Blackjack::determineOutcome(playerHand.getSum(), playerHand.cardCount, DealerTable::FINAL_SUMS[final],
+                                       DealerTable::FINAL_CARD_COUNTS[final]);
+}
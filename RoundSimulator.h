@@ -0,0 +1,120 @@
+/**
+ * The RoundSimulator class plays rounds of Blackjack without a user and without a console, so that millions of rounds
+ * can be simulated quickly. It follows exactly the same course of a round as Blackjack::playRound(): the cards are
+ * dealt in the order of a real table (player, dealer, player, and the dealer's hole card), a dealer that peeks and has
+ * blackjack ends the round, a player with 21 does not get to play, the player hits as long as the policy says so (and
+ * the sum is below 21), and the dealer draws cards as long as their sum is below 17. Without a hole card (see
+ * HoleCardRule), the dealer only gets a second card after the player stands. The outcome is determined with
+ * Blackjack::determineOutcome(), the same function the console game uses.
+ *
+ * Instead of Hand and Card objects, which store strings, the simulator keeps track of a hand with a SimulatedHand: the
+ * sum of the game values, the amount of Aces and the amount of cards. This is all Blackjack::sumOptimal() needs.
+ *
+ * On an infinite deck, the dealer's draws can be skipped altogether: with useDealerTable(), the dealer's final total is
+ * picked from the DealerTable with a single random number. After a peek without a blackjack, a picked blackjack is
+ * picked again, as the final total then only has the chances of the hands without a blackjack.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_ROUNDSIMULATOR_H
+#define PIE_CPP_BLACKJACK_ROUNDSIMULATOR_H
+
+#include "Blackjack.h"
+#include "CardSource.h"
+#include "PlayerPolicy.h"
+
+struct SimulatedHand {
+    int sumOfGameValues = 0; // every Ace is counted as 11 in this sum
+    int numberOfAces = 0;
+    int cardCount = 0;
+    int firstCardValue = 0; // the game value of the first card, which is the open card of the dealer
+
+    /**
+     * This function adds a card with the input "rank" (1-13) to the hand.
+     */
+    void addRank(int rank);
+
+    /**
+     * This function returns the optimal sum of the hand, see Blackjack::sumOptimal().
+     */
+    int getSum() const;
+
+    /**
+     * This function returns true if the optimal sum of the hand counts an Ace as 11 (a "soft" hand).
+     */
+    bool isSoft() const;
+
+    /**
+     * This function returns true if the hand is a blackjack, see Blackjack::isBlackjack(). This is how the dealer
+     * peeks, with a single comparison on the packed hand.
+     */
+    bool isBlackjack() const;
+};
+
+class RoundSimulator {
+private:
+    CardSource &cardSource;
+    PlayerPolicy &policy;
+    InfiniteDeck *dealerTableDeck = nullptr; // only set if the dealer's final total is picked from the DealerTable
+    HoleCardRule holeCardRule = HoleCardRule::PEEK;
+    SimulatedHand dealerHand; // the dealer's hand of the current round
+
+public:
+    /**
+     * Constructor for a RoundSimulator that draws its cards from the input "cardSource_" and makes the player's
+     * decisions with the input "policy_". Both are not copied, so they must outlive the RoundSimulator.
+     */
+    RoundSimulator(CardSource &cardSource_, PlayerPolicy &policy_);
+
+    /**
+     * This function makes the simulator pick the dealer's final total from the DealerTable with one random number from
+     * the input "deck", instead of drawing the dealer's cards one by one. The deck has to be the card source of the
+     * simulator, as the table is only valid for an infinite deck.
+     */
+    void useDealerTable(InfiniteDeck &deck);
+
+    /**
+     * This function sets whether the dealer gets a hole card and peeks for blackjack ("rule" is PEEK, the default) or
+     * only gets a second card after the player stands (NO_HOLE_CARD), see HoleCardRule.
+     */
+    void setHoleCardRule(HoleCardRule rule);
+
+    /**
+     * This function returns the dealer's hand of the current round, as far as it has been dealt. While the player
+     * decides, it holds the open card and (with a hole card) the hole card.
+     */
+    const SimulatedHand &getDealerHand() const;
+
+    /**
+     * This function plays a full round of Blackjack and returns its outcome. Betting is left to the caller, who can
+     * settle the bet based on the outcome.
+     */
+    RoundOutcome playRound();
+
+    /**
+     * This function finishes a round that has already been dealt, starting at the player's decision with the input
+     * "playerHand" and "dealerHand" (the open card, and the hole card if there is one). The player hits as long as
+     * the input "policy" says so and the cards are drawn from the input "cardSource". If the input "dealerTableDeck" is
+     * given, the dealer's final total is picked from the DealerTable with that deck (see settleWithDealerTable()). It
+     * returns the outcome of the round.
+     */
+    static RoundOutcome finishRound(SimulatedHand playerHand, SimulatedHand dealerHand, CardSource &cardSource,
+                                    PlayerPolicy &policy, InfiniteDeck *dealerTableDeck = nullptr);
+
+    /**
+     * This function finishes a round in which the player stands with the input "playerHand": the dealer draws cards
+     * from the input "cardSource" as long as the sum of the "dealerHand" is below 17. It returns the outcome of the
+     * round.
+     */
+    static RoundOutcome standAndSettle(SimulatedHand playerHand, SimulatedHand dealerHand, CardSource &cardSource);
+
+    /**
+     * This function finishes a round in which the player stands with the input "playerHand" like standAndSettle(), but
+     * picks the dealer's final total from the DealerTable with one random number from the input "deck" instead of
+     * drawing the dealer's cards. The "dealerHand" must only hold the dealer's open card, or the open card and a hole
+     * card that is known not to make a blackjack (then a blackjack is picked again).
+     */
+    static RoundOutcome settleWithDealerTable(SimulatedHand playerHand, SimulatedHand dealerHand, InfiniteDeck &deck);
+};
+
+
+#endif //PIE_CPP_BLACKJACK_ROUNDSIMULATOR_H
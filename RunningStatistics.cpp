@@ -0,0 +1,122 @@
+/**
+ * The RunningStatistics class keeps the average and the variance of a stream of values without storing the values,
+ * with the method of Welford: every added value updates the count, the mean and the sum of squared deviations from
+ * the mean (M2). Unlike adding up the values and their squares, this does not lose precision when the mean is large
+ * compared to the spread. Two statistics are merged with the formula of Chan et al., so every thread of a simulation
+ * can keep its own statistics, and a batch of values of which only the sum and the sum of squares are known (like a
+ * batch of the BatchRoundSimulator) can be added at once.
+ *
+ * The StatisticsSlot class lets a thread publish its statistics while it runs, so that another thread can merge the
+ * statistics of all threads every now and then (for example to stop a simulation once it is precise enough) without
+ * locks. The slot has a sequence number that is odd while the statistics are being written (a sequence lock, like the
+ * slots of the TableBroadcast), so a reader retries when it has read half-written statistics. The writer never waits.
+ */
+
+#include "RunningStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * This function adds the input "value" to the statistics.
+ */
+void RunningStatistics::add(double value) {
+    count++;
+    double deviation = value - mean;
+    mean += deviation / count;
+    squaredDeviations += deviation * (value - mean);
+}
+
+/**
+ * This function adds a batch of "batchCount" values to the statistics, of which the sum is "sum" and the sum of
+ * the squares is "sumOfSquares".
+ */
+void RunningStatistics::addBatch(uint64_t batchCount, double sum, double sumOfSquares) {
+    if (batchCount == 0) {
+        return;
+    }
+    RunningStatistics batch;
+    batch.count = batchCount;
+    batch.mean = sum / batchCount;
+    batch.squaredDeviations = std::max(0.0, sumOfSquares - sum * batch.mean);
+    merge(batch);
+}
+
+/**
+ * This function adds all values of the input statistics "other" to these statistics.
+ */
+void RunningStatistics::merge(const RunningStatistics &other) {
+    if (other.count == 0) {
+        return;
+    }
+    uint64_t totalCount = count + other.count;
+    double difference = other.mean - mean;
+    mean += difference * other.count / totalCount;
+    squaredDeviations += other.squaredDeviations
+                         + difference * difference * ((double) count * other.count / totalCount);
+    count = totalCount;
+}
+
+/**
+ * This function returns the amount of values added.
+ */
+uint64_t RunningStatistics::getCount() const {
+    return count;
+}
+
+/**
+ * This function returns the average of the values added, or 0 if there are none.
+ */
+double RunningStatistics::getMean() const {
+    return mean;
+}
+
+/**
+ * This function returns the (sample) variance of the values added, or 0 if there are fewer than 2.
+ */
+double RunningStatistics::getVariance() const {
+    return count < 2 ? 0 : squaredDeviations / (count - 1);
+}
+
+/**
+ * This function returns half the width of the 95% confidence interval of the mean: the mean lies within this
+ * distance of getMean() with a chance of 95%.
+ */
+double RunningStatistics::getConfidenceHalfWidth() const {
+    const double Z_95 = 1.959964;
+    return count == 0 ? 0 : Z_95 * std::sqrt(getVariance() / count);
+}
+
+/**
+ * This function publishes the input "statistics" in the slot. It must only be called by the thread that owns the
+ * slot.
+ */
+void StatisticsSlot::publish(const RunningStatistics &statistics) {
+    uint64_t oldSequence = sequence.load(std::memory_order_relaxed);
+    sequence.store(oldSequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    count.store(statistics.count, std::memory_order_relaxed);
+    mean.store(statistics.mean, std::memory_order_relaxed);
+    squaredDeviations.store(statistics.squaredDeviations, std::memory_order_relaxed);
+    sequence.store(oldSequence + 2, std::memory_order_release);
+}
+
+/**
+ * This function returns the statistics that were published last (empty statistics if nothing was published yet).
+ */
+RunningStatistics StatisticsSlot::read() const {
+    RunningStatistics statistics;
+    while (true) {
+        uint64_t sequenceBefore = sequence.load(std::memory_order_acquire);
+        if (sequenceBefore % 2 == 1) {
+            continue; // the owner is writing, which only takes a moment
+        }
+        statistics.count = count.load(std::memory_order_relaxed);
+        statistics.mean = mean.load(std::memory_order_relaxed);
+        statistics.squaredDeviations = squaredDeviations.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == sequenceBefore) {
+            return statistics;
+        }
+    }
+}
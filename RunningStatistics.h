@@ -0,0 +1,90 @@
+/**
+ * The RunningStatistics class keeps the average and the variance of a stream of values without storing the values,
+ * with the method of Welford: every added value updates the count, the mean and the sum of squared deviations from
+ * the mean (M2). Unlike adding up the values and their squares, this does not lose precision when the mean is large
+ * compared to the spread. Two statistics are merged with the formula of Chan et al., so every thread of a simulation
+ * can keep its own statistics, and a batch of values of which only the sum and the sum of squares are known (like a
+ * batch of the BatchRoundSimulator) can be added at once.
+ *
+ * The StatisticsSlot class lets a thread publish its statistics while it runs, so that another thread can merge the
+ * statistics of all threads every now and then (for example to stop a simulation once it is precise enough) without
+ * locks. The slot has a sequence number that is odd while the statistics are being written (a sequence lock, like the
+ * slots of the TableBroadcast), so a reader retries when it has read half-written statistics. The writer never waits.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_RUNNINGSTATISTICS_H
+#define PIE_CPP_BLACKJACK_RUNNINGSTATISTICS_H
+
+#include <atomic>
+#include <cstdint>
+
+class RunningStatistics {
+private:
+    uint64_t count = 0;
+    double mean = 0;
+    double squaredDeviations = 0; // M2, the sum of the squared differences between the values and the mean
+
+public:
+    /**
+     * This function adds the input "value" to the statistics.
+     */
+    void add(double value);
+
+    /**
+     * This function adds a batch of "batchCount" values to the statistics, of which the sum is "sum" and the sum of
+     * the squares is "sumOfSquares".
+     */
+    void addBatch(uint64_t batchCount, double sum, double sumOfSquares);
+
+    /**
+     * This function adds all values of the input statistics "other" to these statistics.
+     */
+    void merge(const RunningStatistics &other);
+
+    /**
+     * This function returns the amount of values added.
+     */
+    uint64_t getCount() const;
+
+    /**
+     * This function returns the average of the values added, or 0 if there are none.
+     */
+    double getMean() const;
+
+    /**
+     * This function returns the (sample) variance of the values added, or 0 if there are fewer than 2.
+     */
+    double getVariance() const;
+
+    /**
+     * This function returns half the width of the 95% confidence interval of the mean: the mean lies within this
+     * distance of getMean() with a chance of 95%.
+     */
+    double getConfidenceHalfWidth() const;
+
+    friend class StatisticsSlot;
+};
+
+class StatisticsSlot {
+private:
+    // 2 * the amount of publications once the statistics have been written, and odd while they are being written
+    alignas(64) std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> count{0};
+    std::atomic<double> mean{0};
+    std::atomic<double> squaredDeviations{0};
+
+public:
+    /**
+     * This function publishes the input "statistics" in the slot. It must only be called by the thread that owns the
+     * slot.
+     */
+    void publish(const RunningStatistics &statistics);
+
+    /**
+     * This function returns the statistics that were published last (empty statistics if nothing was published yet).
+     */
+    RunningStatistics read() const;
+};
+
+
+#endif //PIE_CPP_BLACKJACK_RUNNINGSTATISTICS_H
@@ -0,0 +1,88 @@
+/**
+ * The ScriptedInput class reads a whole script of commands for the console game from a file or a pipe, so the game
+ * can be driven in batch mode without a user typing at the keyboard. The commands are the same ones a user would
+ * enter during the game, separated by whitespace:
+ *  - "s" or "S": start a (new) round
+ *  - "q" or "Q": quit the game
+ *  - "h" or "H": hit, "s" or "S" is also used to stand
+ *  - a whole number of at most 9 digits: the bet for the coming round
+ *
+ * All commands are validated up front when the script is read, so a broken script is rejected before any game is
+ * played. A validated script can then be replayed as many times as needed, once per scripted session.
+ */
+
+#include "ScriptedInput.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "Money.h"
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::endl, std::cerr, std::cin;
+
+/**
+ * This function checks whether a command, provided as input string "command", is reasonable. To be reasonable,
+ * the command needs to be one of the letters s, q or h (in lower or upper case) or a whole number of at most 9
+ * digits. Otherwise an error will be displayed indicating the problem and the program will be exited.
+ */
+void ScriptedInput::errorCheckCommand(const string &command) {
+    if (command == "s" || command == "S" || command == "q" || command == "Q" || command == "h" || command == "H") {
+        return;
+    }
+
+    // A bet is read the same way as the bet prompt of the game reads it (see Money::parseWholeAmount())
+    Money bet;
+    if (!Money::parseWholeAmount(command, bet)) {
+        cerr << "Error: script command " << commandCount + 1 << " (\"" << command
+             << "\") is not 's', 'q', 'h' or a whole number of at most " << Money::MAXIMUM_WHOLE_AMOUNT_DIGITS
+             << " digits" << endl;
+        exit(-1);
+    }
+}
+
+/**
+ * Constructor for a ScriptedInput object that reads and validates all commands from the input stream
+ * "scriptStream" until the stream ends.
+ */
+ScriptedInput::ScriptedInput(std::istream &scriptStream) {
+    string command;
+    while (scriptStream >> command) {
+        errorCheckCommand(command);
+        validatedCommands += command;
+        validatedCommands += ' ';
+        commandCount++;
+    }
+}
+
+/**
+ * This function reads and validates a script from the file with the name "scriptFileName". A file name of "-"
+ * reads the script from the standard input instead, so that a script can be piped into the program.
+ */
+ScriptedInput ScriptedInput::fromFile(const string &scriptFileName) {
+    if (scriptFileName == "-") {
+        return ScriptedInput(cin);
+    }
+
+    std::ifstream scriptFile(scriptFileName);
+    if (!scriptFile) {
+        cerr << "Error: the script file \"" << scriptFileName << "\" could not be opened" << endl;
+        exit(-1);
+    }
+    return ScriptedInput(scriptFile);
+}
+
+/**
+ * This function returns a new input stream that replays the validated commands from the start. Every scripted
+ * session should get its own stream.
+ */
+std::istringstream ScriptedInput::createSessionStream() {
+    return std::istringstream(validatedCommands);
+}
+
+/**
+ * This function returns the amount of commands in the script.
+ */
+int ScriptedInput::getCommandCount() {
+    return commandCount;
+}
@@ -0,0 +1,61 @@
+/**
+ * The ScriptedInput class reads a whole script of commands for the console game from a file or a pipe, so the game
+ * can be driven in batch mode without a user typing at the keyboard. The commands are the same ones a user would
+ * enter during the game, separated by whitespace:
+ *  - "s" or "S": start a (new) round
+ *  - "q" or "Q": quit the game
+ *  - "h" or "H": hit, "s" or "S" is also used to stand
+ *  - a whole number of at most 9 digits: the bet for the coming round
+ *
+ * All commands are validated up front when the script is read, so a broken script is rejected before any game is
+ * played. A validated script can then be replayed as many times as needed, once per scripted session.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_SCRIPTEDINPUT_H
+#define PIE_CPP_BLACKJACK_SCRIPTEDINPUT_H
+
+#include <istream>
+#include <sstream>
+#include <string>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string;
+
+class ScriptedInput {
+private:
+    string validatedCommands; // all commands of the script, separated by single spaces
+    int commandCount = 0;
+
+    /**
+     * This function checks whether a command, provided as input string "command", is reasonable. To be reasonable,
+     * the command needs to be one of the letters s, q or h (in lower or upper case) or a whole number of at most 9
+     * digits. Otherwise an error will be displayed indicating the problem and the program will be exited.
+     */
+    void errorCheckCommand(const string &command);
+
+public:
+    /**
+     * Constructor for a ScriptedInput object that reads and validates all commands from the input stream
+     * "scriptStream" until the stream ends.
+     */
+    explicit ScriptedInput(std::istream &scriptStream);
+
+    /**
+     * This function reads and validates a script from the file with the name "scriptFileName". A file name of "-"
+     * reads the script from the standard input instead, so that a script can be piped into the program.
+     */
+    static ScriptedInput fromFile(const string &scriptFileName);
+
+    /**
+     * This function returns a new input stream that replays the validated commands from the start. Every scripted
+     * session should get its own stream.
+     */
+    std::istringstream createSessionStream();
+
+    /**
+     * This function returns the amount of commands in the script.
+     */
+    int getCommandCount();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_SCRIPTEDINPUT_H
@@ -0,0 +1,143 @@
+/**
+ * The Shoe class models the shoe of a real Blackjack table: a number of standard 52-card decks shuffled together, from
+ * which the cards are dealt one by one. Unlike the infinite deck of the Card class, every dealt card changes the
+ * chances of the cards that remain. When the dealt part of the shoe passes the cut card (the penetration, for example
+ * 75% of the cards), the shoe is reshuffled after the current round, like a dealer would do. It is shuffled perfectly
+ * at random, unless a ShuffleProcedure is set that models how a dealer shuffles by hand. Such a procedure shuffles the
+ * cards in the order of the previous shoe, so traces of that order are left in the next shoe.
+ *
+ * While dealing, the shoe keeps the running counts of several card counting systems (see CardCounter), so that
+ * simulated players can base their bets and decisions on the true count at any moment.
+ */
+
+#include "Shoe.h"
+
+
+/**
+ * Constructor for a shoe of "amountOfDecks_" decks, which is reshuffled after the round in which a fraction of
+ * "penetration" of its cards has been dealt. The shoe shuffles with its own random number generator, seeded with
+ * the input "seed".
+ */
+Shoe::Shoe(int amountOfDecks_, double penetration, uint64_t seed)
+        : amountOfDecks(amountOfDecks_), randomGenerator(seed) {
+    // Every deck has 4 cards of every rank
+    for (int deck = 0; deck < amountOfDecks; ++deck) {
+        for (int rank = 1; rank <= 13; ++rank) {
+            for (int suit = 0; suit < 4; ++suit) {
+                cards.push_back(rank);
+            }
+        }
+    }
+    cutCardPosition = (int) (penetration * cards.size());
+    shuffle();
+}
+
+/**
+ * This function puts all cards back into the shoe, shuffles them and resets the running counts.
+ */
+void Shoe::shuffle() {
+    shuffleProcedure.apply(cards, shuffleBuffer, randomGenerator);
+    nextCardIndex = 0;
+    counter.reset(amountOfDecks);
+}
+
+/**
+ * This function makes the shoe shuffle with the input "procedure" from the next shuffle on, instead of perfectly at
+ * random. The first shoe is always shuffled at random, as the cards come in new from the box.
+ */
+void Shoe::setShuffleProcedure(const ShuffleProcedure &procedure) {
+    shuffleProcedure = procedure;
+}
+
+/**
+ * This function deals the next card of the shoe, adds it to the running counts and returns its rank (1-13). If
+ * the shoe is empty, it is shuffled first.
+ */
+int Shoe::drawRank() {
+    if (nextCardIndex == (int) cards.size()) {
+        shuffle();
+    }
+    int rank = cards[nextCardIndex++];
+    counter.observe(rank);
+    return rank;
+}
+
+/**
+ * This function reshuffles the shoe if the cut card has been reached during the round that has just finished.
+ */
+void Shoe::finishRound() {
+    if (nextCardIndex >= cutCardPosition) {
+        shuffle();
+    }
+}
+
+/**
+ * This function returns the true count of the counting system that is selected with setCountingSystem() (Hi-Lo by
+ * default).
+ */
+double Shoe::getTrueCount() {
+    return getTrueCount(countingSystem);
+}
+
+/**
+ * This function returns the true count of the input counting "system".
+ */
+double Shoe::getTrueCount(CountingSystem system) {
+    return counter.getTrueCount(system, getCardsRemaining() / 52.0);
+}
+
+/**
+ * This function returns the running count of the input counting "system".
+ */
+int Shoe::getRunningCount(CountingSystem system) {
+    return counter.getRunningCount(system);
+}
+
+/**
+ * This function selects the counting system whose true count is returned by getTrueCount().
+ */
+void Shoe::setCountingSystem(CountingSystem system) {
+    countingSystem = system;
+}
+
+/**
+ * This function returns the amount of cards that have not been dealt yet.
+ */
+int Shoe::getCardsRemaining() {
+    return (int) cards.size() - nextCardIndex;
+}
+
+/**
+ * This function returns the amount of decks the shoe consists of.
+ */
+int Shoe::getAmountOfDecks() {
+    return amountOfDecks;
+}
+
+/**
+ * This function returns the rank of the card "offset" positions after the next card to be dealt, without dealing
+ * it (an offset of 0 returns the next card). Past the end of the shoe, the ranks continue from the start.
+ */
+int Shoe::peekRank(int offset) {
+    return cards[(nextCardIndex + offset) % cards.size()];
+}
+
+/**
+ * Constructor for a lookahead that starts at the next card of the input "shoe_". The true count is fixed at the
+ * moment the lookahead was created.
+ */
+ShoeLookahead::ShoeLookahead(Shoe &shoe_) : shoe(shoe_), trueCount(shoe_.getTrueCount()) {}
+
+/**
+ * This function returns the rank of the next upcoming card of the shoe and moves the lookahead one card further.
+ */
+int ShoeLookahead::drawRank() {
+    return shoe.peekRank(offset++);
+}
+
+/**
+ * This function returns the true count of the shoe at the moment the lookahead was created.
+ */
+double ShoeLookahead::getTrueCount() {
+    return trueCount;
+}
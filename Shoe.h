@@ -0,0 +1,136 @@
+/**
+ * The Shoe class models the shoe of a real Blackjack table: a number of standard 52-card decks shuffled together, from
+ * which the cards are dealt one by one. Unlike the infinite deck of the Card class, every dealt card changes the
+ * chances of the cards that remain. When the dealt part of the shoe passes the cut card (the penetration, for example
+ * 75% of the cards), the shoe is reshuffled after the current round, like a dealer would do. It is shuffled perfectly
+ * at random, unless a ShuffleProcedure is set that models how a dealer shuffles by hand. Such a procedure shuffles the
+ * cards in the order of the previous shoe, so traces of that order are left in the next shoe.
+ *
+ * While dealing, the shoe keeps the running counts of several card counting systems (see CardCounter), so that
+ * simulated players can base their bets and decisions on the true count at any moment.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_SHOE_H
+#define PIE_CPP_BLACKJACK_SHOE_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::vector;
+
+#include "CardCounter.h"
+#include "CardSource.h"
+#include "ShuffleProcedure.h"
+
+class Shoe : public CardSource {
+private:
+    int amountOfDecks;
+    int cutCardPosition;
+    vector<int> cards;
+    int nextCardIndex = 0;
+    std::mt19937_64 randomGenerator;
+    ShuffleProcedure shuffleProcedure;
+    vector<int> shuffleBuffer;
+
+    CardCounter counter;
+    CountingSystem countingSystem = CountingSystem::HI_LO;
+
+public:
+    /**
+     * Constructor for a shoe of "amountOfDecks_" decks, which is reshuffled after the round in which a fraction of
+     * "penetration" of its cards has been dealt. The shoe shuffles with its own random number generator, seeded with
+     * the input "seed".
+     */
+    Shoe(int amountOfDecks_, double penetration, uint64_t seed);
+
+    /**
+     * This function puts all cards back into the shoe, shuffles them and resets the running counts.
+     */
+    void shuffle();
+
+    /**
+     * This function makes the shoe shuffle with the input "procedure" from the next shuffle on, instead of perfectly at
+     * random. The first shoe is always shuffled at random, as the cards come in new from the box.
+     */
+    void setShuffleProcedure(const ShuffleProcedure &procedure);
+
+    /**
+     * This function deals the next card of the shoe, adds it to the running counts and returns its rank (1-13). If
+     * the shoe is empty, it is shuffled first.
+     */
+    int drawRank() override;
+
+    /**
+     * This function reshuffles the shoe if the cut card has been reached during the round that has just finished.
+     */
+    void finishRound() override;
+
+    /**
+     * This function returns the true count of the counting system that is selected with setCountingSystem() (Hi-Lo by
+     * default).
+     */
+    double getTrueCount() override;
+
+    /**
+     * This function returns the true count of the input counting "system".
+     */
+    double getTrueCount(CountingSystem system);
+
+    /**
+     * This function returns the running count of the input counting "system".
+     */
+    int getRunningCount(CountingSystem system);
+
+    /**
+     * This function selects the counting system whose true count is returned by getTrueCount().
+     */
+    void setCountingSystem(CountingSystem system);
+
+    /**
+     * This function returns the amount of cards that have not been dealt yet.
+     */
+    int getCardsRemaining();
+
+    /**
+     * This function returns the amount of decks the shoe consists of.
+     */
+    int getAmountOfDecks();
+
+    /**
+     * This function returns the rank of the card "offset" positions after the next card to be dealt, without dealing
+     * it (an offset of 0 returns the next card). Past the end of the shoe, the ranks continue from the start.
+     */
+    int peekRank(int offset);
+};
+
+/**
+ * The ShoeLookahead class is a card source that reads the upcoming cards of a Shoe without dealing them. It is used to
+ * play out different decisions on exactly the same upcoming cards, for example to compare hitting with standing.
+ */
+class ShoeLookahead : public CardSource {
+private:
+    Shoe &shoe;
+    int offset = 0;
+    double trueCount;
+
+public:
+    /**
+     * Constructor for a lookahead that starts at the next card of the input "shoe_". The true count is fixed at the
+     * moment the lookahead was created.
+     */
+    explicit ShoeLookahead(Shoe &shoe_);
+
+    /**
+     * This function returns the rank of the next upcoming card of the shoe and moves the lookahead one card further.
+     */
+    int drawRank() override;
+
+    /**
+     * This function returns the true count of the shoe at the moment the lookahead was created.
+     */
+    double getTrueCount() override;
+};
+
+
+#endif //PIE_CPP_BLACKJACK_SHOE_H
@@ -0,0 +1,187 @@
+/**
+ * The ShuffleAnalyzer class measures how predictable the positions of the cards are after a shuffle procedure (see
+ * ShuffleProcedure.h), for game protection: a procedure that leaves the cards close to where they were lets a shuffle
+ * tracker follow groups of cards from one shoe into the next. The analyzer shuffles a shoe many times, every time
+ * starting from the cards in the order of the previous shoe (position 0 was dealt first), and compares the position of
+ * every card before and after the shuffle:
+ *  - the rank correlation (Spearman) between the old and new positions, which is 0 for a perfect shuffle;
+ *  - the rising sequences: the runs of cards that are still in their old order, interleaved with each other. A riffle
+ *    at most doubles them, and a perfect shuffle of n cards has (n + 1) / 2 of them on average;
+ *  - the neighbours that are still next to each other in the same order (1 in n for a perfect shuffle);
+ *  - the cards that were behind the cut card (never dealt, so unseen by the players) and are dealt before the cut card
+ *    of the next shoe, which is the penetration for a perfect shuffle;
+ *  - where the cards of every tenth of the shoe end up, per tenth, and how often a tracker who guesses the most likely
+ *    tenth for a card is right (10% for a perfect shuffle).
+ *
+ * The shuffles are done in blocks that are spread over all cores, and every block has its own random number generator
+ * seeded with its block number. Every thread adds up its statistics as whole numbers, which are merged when all
+ * threads have finished, so the results do not depend on the amount of threads.
+ */
+
+#include "ShuffleAnalyzer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cout, std::endl, std::setw, std::fixed, std::setprecision;
+
+/**
+ * This function adds the statistics of "other" to these statistics.
+ */
+void ShuffleStatistics::merge(const ShuffleStatistics &other) {
+    shuffles += other.shuffles;
+    sumOfSquaredDisplacements += other.sumOfSquaredDisplacements;
+    risingSequences += other.risingSequences;
+    neighboursKept += other.neighboursKept;
+    unseenCardsDealt += other.unseenCardsDealt;
+    zoneMoves.resize(std::max(zoneMoves.size(), other.zoneMoves.size()));
+    for (size_t i = 0; i < other.zoneMoves.size(); ++i) {
+        zoneMoves[i] += other.zoneMoves[i];
+    }
+}
+
+/**
+ * Constructor for a ShuffleAnalyzer with the input "settings_".
+ */
+ShuffleAnalyzer::ShuffleAnalyzer(const ShuffleSettings &settings_)
+        : settings(settings_), amountOfCards(52 * settings_.amountOfDecks),
+          cutCardPosition((int) (settings_.penetration * 52 * settings_.amountOfDecks)) {
+    statistics.zoneMoves.resize(AMOUNT_OF_ZONES * AMOUNT_OF_ZONES);
+}
+
+/**
+ * This function returns the tenth of the shoe that the input "position" is in (0 is the top of the shoe).
+ */
+int ShuffleAnalyzer::zoneOf(int position) const {
+    return position * AMOUNT_OF_ZONES / amountOfCards;
+}
+
+/**
+ * This function does the shuffles of block number "block" with a random number generator seeded with the block
+ * number, and adds their statistics to the input "blockStatistics".
+ */
+void ShuffleAnalyzer::shuffleBlock(long long block, ShuffleStatistics &blockStatistics) {
+    std::mt19937_64 randomGenerator(settings.seed + block);
+    vector<int> cards(amountOfCards);   // the old position of the card at every new position
+    vector<int> buffer(amountOfCards);
+    vector<int> newPositions(amountOfCards); // the new position of the card at every old position
+    vector<int> zones(amountOfCards);
+    for (int position = 0; position < amountOfCards; ++position) {
+        zones[position] = zoneOf(position);
+    }
+
+    long long shufflesInBlock = std::min((long long) SHUFFLES_PER_BLOCK,
+                                         settings.shuffles - block * SHUFFLES_PER_BLOCK);
+    for (long long shuffle = 0; shuffle < shufflesInBlock; ++shuffle) {
+        std::iota(cards.begin(), cards.end(), 0);
+        settings.procedure.apply(cards, buffer, randomGenerator);
+
+        for (int position = 0; position < amountOfCards; ++position) {
+            int oldPosition = cards[position];
+            newPositions[oldPosition] = position;
+            int64_t displacement = position - oldPosition;
+            blockStatistics.sumOfSquaredDisplacements += displacement * displacement;
+            blockStatistics.zoneMoves[zones[oldPosition] * AMOUNT_OF_ZONES + zones[position]]++;
+            if (oldPosition >= cutCardPosition && position < cutCardPosition) {
+                blockStatistics.unseenCardsDealt++;
+            }
+        }
+
+        // A rising sequence ends at every card whose old successor now lies before it
+        blockStatistics.risingSequences++;
+        for (int oldPosition = 0; oldPosition + 1 < amountOfCards; ++oldPosition) {
+            int position = newPositions[oldPosition];
+            int successorPosition = newPositions[oldPosition + 1];
+            blockStatistics.risingSequences += successorPosition < position;
+            blockStatistics.neighboursKept += successorPosition == position + 1;
+        }
+    }
+    blockStatistics.shuffles += shufflesInBlock;
+}
+
+/**
+ * This function does all shuffles, spread over the threads, and merges their statistics.
+ */
+void ShuffleAnalyzer::run() {
+    auto startTime = std::chrono::steady_clock::now();
+
+    int amountOfThreads = settings.threads;
+    if (amountOfThreads <= 0) {
+        amountOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    long long amountOfBlocks = (settings.shuffles + SHUFFLES_PER_BLOCK - 1) / SHUFFLES_PER_BLOCK;
+
+    // The threads take the next block that has not been shuffled yet, and every thread has its own statistics
+    std::atomic<long long> nextBlock(0);
+    vector<ShuffleStatistics> threadStatistics(amountOfThreads, statistics);
+    vector<std::thread> threads;
+    for (int t = 0; t < amountOfThreads; ++t) {
+        threads.emplace_back([this, t, amountOfBlocks, &nextBlock, &threadStatistics]() {
+            for (long long block = nextBlock++; block < amountOfBlocks; block = nextBlock++) {
+                shuffleBlock(block, threadStatistics[t]);
+            }
+        });
+    }
+
+    for (int t = 0; t < amountOfThreads; ++t) {
+        threads[t].join();
+        statistics.merge(threadStatistics[t]);
+    }
+
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * This function prints the statistics to the console, next to what a perfect shuffle would give.
+ */
+void ShuffleAnalyzer::printReport() {
+    double shuffles = (double) std::max<uint64_t>(1, statistics.shuffles);
+    double n = amountOfCards;
+
+    cout << "Shuffle procedure: " << settings.procedure.toString() << " on " << settings.amountOfDecks << " decks ("
+         << amountOfCards << " cards), " << statistics.shuffles << " shuffles in " << elapsedSeconds << " s" << endl;
+    cout << fixed << setprecision(4);
+    cout << "Rank correlation of the old and new positions: "
+         << 1 - 6 * (statistics.sumOfSquaredDisplacements / shuffles) / (n * (n * n - 1)) << " (perfect shuffle: 0)"
+         << endl;
+    cout << setprecision(2);
+    cout << "Rising sequences: " << statistics.risingSequences / shuffles << " (perfect shuffle: " << (n + 1) / 2
+         << ")" << endl;
+    cout << "Neighbours still next to each other: " << 100 * statistics.neighboursKept / shuffles / (n - 1)
+         << "% (perfect shuffle: " << 100 / n << "%)" << endl;
+    cout << "Unseen cards from behind the cut card dealt in the next shoe: "
+         << 100 * statistics.unseenCardsDealt / shuffles / (amountOfCards - cutCardPosition)
+         << "% (perfect shuffle: " << 100.0 * cutCardPosition / n << "%)" << endl << endl;
+
+    cout << "Where the cards of every tenth of the shoe end up (% of its cards, perfect shuffle: 10%)" << endl;
+    cout << setw(8) << "From/To";
+    for (int zone = 0; zone < AMOUNT_OF_ZONES; ++zone) {
+        cout << setw(7) << zone + 1;
+    }
+    cout << endl;
+    double correctGuesses = 0;
+    for (int from = 0; from < AMOUNT_OF_ZONES; ++from) {
+        uint64_t cardsInZone = 0;
+        uint64_t mostLikely = 0;
+        for (int to = 0; to < AMOUNT_OF_ZONES; ++to) {
+            uint64_t moves = statistics.zoneMoves[from * AMOUNT_OF_ZONES + to];
+            cardsInZone += moves;
+            mostLikely = std::max(mostLikely, moves);
+        }
+        cout << setw(8) << from + 1;
+        for (int to = 0; to < AMOUNT_OF_ZONES; ++to) {
+            cout << setw(7) << setprecision(1)
+                 << 100.0 * statistics.zoneMoves[from * AMOUNT_OF_ZONES + to] / std::max<uint64_t>(1, cardsInZone);
+        }
+        cout << endl;
+        correctGuesses += mostLikely;
+    }
+    cout << "A tracker guessing the most likely tenth of a card is right " << setprecision(2)
+         << 100 * correctGuesses / (shuffles * n) << "% of the time (perfect shuffle: 10%)" << endl;
+}
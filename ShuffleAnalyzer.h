@@ -0,0 +1,98 @@
+/**
+ * The ShuffleAnalyzer class measures how predictable the positions of the cards are after a shuffle procedure (see
+ * ShuffleProcedure.h), for game protection: a procedure that leaves the cards close to where they were lets a shuffle
+ * tracker follow groups of cards from one shoe into the next. The analyzer shuffles a shoe many times, every time
+ * starting from the cards in the order of the previous shoe (position 0 was dealt first), and compares the position of
+ * every card before and after the shuffle:
+ *  - the rank correlation (Spearman) between the old and new positions, which is 0 for a perfect shuffle;
+ *  - the rising sequences: the runs of cards that are still in their old order, interleaved with each other. A riffle
+ *    at most doubles them, and a perfect shuffle of n cards has (n + 1) / 2 of them on average;
+ *  - the neighbours that are still next to each other in the same order (1 in n for a perfect shuffle);
+ *  - the cards that were behind the cut card (never dealt, so unseen by the players) and are dealt before the cut card
+ *    of the next shoe, which is the penetration for a perfect shuffle;
+ *  - where the cards of every tenth of the shoe end up, per tenth, and how often a tracker who guesses the most likely
+ *    tenth for a card is right (10% for a perfect shuffle).
+ *
+ * The shuffles are done in blocks that are spread over all cores, and every block has its own random number generator
+ * seeded with its block number. Every thread adds up its statistics as whole numbers, which are merged when all
+ * threads have finished, so the results do not depend on the amount of threads.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_SHUFFLEANALYZER_H
+#define PIE_CPP_BLACKJACK_SHUFFLEANALYZER_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::vector;
+
+#include "ShuffleProcedure.h"
+
+struct ShuffleSettings {
+    ShuffleProcedure procedure = ShuffleProcedure::parse("riffle,riffle,strip,riffle,cut");
+    int amountOfDecks = 6;
+    double penetration = 0.75;
+    long long shuffles = 1000000;
+    int threads = 0; // 0 uses all cores of the computer
+    uint64_t seed = 1;
+};
+
+// The statistics of a number of shuffles, added up as whole numbers
+struct ShuffleStatistics {
+    uint64_t shuffles = 0;
+    uint64_t sumOfSquaredDisplacements = 0; // over all cards, for the rank correlation
+    uint64_t risingSequences = 0;
+    uint64_t neighboursKept = 0;
+    uint64_t unseenCardsDealt = 0;
+    vector<uint64_t> zoneMoves; // the cards that moved from one tenth of the shoe (row) to another (column)
+
+    /**
+     * This function adds the statistics of "other" to these statistics.
+     */
+    void merge(const ShuffleStatistics &other);
+};
+
+class ShuffleAnalyzer {
+public:
+    static const int AMOUNT_OF_ZONES = 10;
+
+private:
+    const int SHUFFLES_PER_BLOCK = 10000;
+
+    ShuffleSettings settings;
+    int amountOfCards;
+    int cutCardPosition;
+    ShuffleStatistics statistics;
+    double elapsedSeconds = 0;
+
+    /**
+     * This function returns the tenth of the shoe that the input "position" is in (0 is the top of the shoe).
+     */
+    int zoneOf(int position) const;
+
+    /**
+     * This function does the shuffles of block number "block" with a random number generator seeded with the block
+     * number, and adds their statistics to the input "blockStatistics".
+     */
+    void shuffleBlock(long long block, ShuffleStatistics &blockStatistics);
+
+public:
+    /**
+     * Constructor for a ShuffleAnalyzer with the input "settings_".
+     */
+    explicit ShuffleAnalyzer(const ShuffleSettings &settings_);
+
+    /**
+     * This function does all shuffles, spread over the threads, and merges their statistics.
+     */
+    void run();
+
+    /**
+     * This function prints the statistics to the console, next to what a perfect shuffle would give.
+     */
+    void printReport();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_SHUFFLEANALYZER_H
@@ -0,0 +1,202 @@
+/**
+ * The ShuffleProcedure class models the way a dealer shuffles a shoe by hand, as a list of mechanical steps, instead of
+ * a perfect random shuffle. Real shuffles leave traces of the order the cards had before: cards that were close
+ * together often stay close together, which is what shuffle trackers look for. The steps are:
+ *  - "riffle": the stack is cut in two halves (the cut is binomial, like a dealer aiming for the middle), and the
+ *    halves are riffled into each other. A card drops from a half with a chance proportional to the amount of cards
+ *    still in that half (the Gilbert-Shannon-Reeds model). "riffle:<n>" riffles in grabs, like dealers do with a big
+ *    shoe: a grab of n cards from each half is riffled, and every riffled grab is put on top of the new stack.
+ *  - "strip:<n>": packets of about n cards (10 by default) are taken off the top one by one and put on a new stack,
+ *    which reverses the order of the packets but not of the cards in them.
+ *  - "cut": the stack is cut somewhere in its middle half, and the bottom part is put on top.
+ * A procedure is written as the steps separated by commas, like "riffle,riffle,strip,riffle,cut". The procedure
+ * "random" has no steps and shuffles perfectly (with std::shuffle), like a shuffling machine.
+ *
+ * A procedure works on an array of numbers, which can be the ranks of a Shoe, or the positions of the cards before the
+ * shuffle (see ShuffleAnalyzer.h). It does not allocate memory while shuffling, as it is used for millions of shuffles.
+ */
+
+#include "ShuffleProcedure.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <iostream>
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cerr, std::endl;
+
+/**
+ * This function returns a random whole number from 0 up to (but not including) "limit", with the input
+ * "randomGenerator". It takes a single number from the generator, without a distribution object.
+ */
+int ShuffleProcedure::randomBelow(std::mt19937_64 &randomGenerator, int limit) {
+    // Scaling the upper 32 bits to the limit, which is fast and unbiased enough for limits of a few hundred cards
+    return (int) (((randomGenerator() >> 32) * (uint64_t) limit) >> 32);
+}
+
+/**
+ * This function riffles the "topSize" cards starting at "top" into the "bottomSize" cards starting at "bottom", and
+ * writes the result to "output".
+ */
+void ShuffleProcedure::riffleTogether(const int *top, int topSize, const int *bottom, int bottomSize, int *output,
+                                      std::mt19937_64 &randomGenerator) {
+    while (topSize > 0 && bottomSize > 0) {
+        // The next card comes from a half with a chance proportional to the cards left in it
+        if (randomBelow(randomGenerator, topSize + bottomSize) < topSize) {
+            *output++ = *top++;
+            --topSize;
+        } else {
+            *output++ = *bottom++;
+            --bottomSize;
+        }
+    }
+    output = std::copy(top, top + topSize, output);
+    std::copy(bottom, bottom + bottomSize, output);
+}
+
+/**
+ * This function performs a "riffle" step with grabs of "grabSize" cards (0 for the whole halves) on the input
+ * "cards", using "buffer" (of the same size) for the new stack.
+ */
+void ShuffleProcedure::riffle(vector<int> &cards, vector<int> &buffer, int grabSize,
+                              std::mt19937_64 &randomGenerator) {
+    int amountOfCards = (int) cards.size();
+    // A binomial cut: the amount of set bits in one random bit per card
+    int middle = 0;
+    for (int bits = 0; bits < amountOfCards; bits += 64) {
+        uint64_t randomBits = randomGenerator();
+        if (amountOfCards - bits < 64) {
+            randomBits &= (uint64_t(1) << (amountOfCards - bits)) - 1;
+        }
+        middle += std::popcount(randomBits);
+    }
+    if (grabSize <= 0) {
+        riffleTogether(cards.data(), middle, cards.data() + middle, amountOfCards - middle, buffer.data(),
+                       randomGenerator);
+        cards.swap(buffer);
+        return;
+    }
+
+    // Every riffled grab goes on top of the new stack, so the first grab ends up at the bottom of it
+    int top = 0;
+    int bottom = middle;
+    int stackTop = amountOfCards;
+    while (top < middle || bottom < amountOfCards) {
+        int topGrab = std::min(grabSize, middle - top);
+        int bottomGrab = std::min(grabSize, amountOfCards - bottom);
+        stackTop -= topGrab + bottomGrab;
+        riffleTogether(cards.data() + top, topGrab, cards.data() + bottom, bottomGrab, buffer.data() + stackTop,
+                       randomGenerator);
+        top += topGrab;
+        bottom += bottomGrab;
+    }
+    cards.swap(buffer);
+}
+
+/**
+ * This function performs a "strip" step with packets of about "packetSize" cards on the input "cards", using
+ * "buffer" (of the same size) for the new stack.
+ */
+void ShuffleProcedure::strip(vector<int> &cards, vector<int> &buffer, int packetSize,
+                             std::mt19937_64 &randomGenerator) {
+    int amountOfCards = (int) cards.size();
+    int stackTop = amountOfCards;
+    for (int taken = 0; taken < amountOfCards;) {
+        // A packet has between half and one and a half times the average amount of cards
+        int packet = std::max(1, packetSize / 2 + randomBelow(randomGenerator, packetSize + 1));
+        packet = std::min(packet, amountOfCards - taken);
+        stackTop -= packet;
+        std::copy(cards.begin() + taken, cards.begin() + taken + packet, buffer.begin() + stackTop);
+        taken += packet;
+    }
+    cards.swap(buffer);
+}
+
+/**
+ * This function performs a "cut" step on the input "cards".
+ */
+void ShuffleProcedure::cut(vector<int> &cards, std::mt19937_64 &randomGenerator) {
+    int amountOfCards = (int) cards.size();
+    int position = amountOfCards / 4 + randomBelow(randomGenerator, amountOfCards / 2 + 1);
+    std::rotate(cards.begin(), cards.begin() + position, cards.end());
+}
+
+/**
+ * This function returns the procedure described by the input "text", like "riffle,riffle,strip,riffle,cut" (see
+ * the description at the top of this file). For an unknown step an error is displayed and the program is exited.
+ */
+ShuffleProcedure ShuffleProcedure::parse(const string &text) {
+    ShuffleProcedure procedure;
+    if (text == "random") {
+        return procedure;
+    }
+
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = std::min(text.find(',', start), text.size());
+        string step = text.substr(start, end - start);
+        start = end + 1;
+
+        // A step is a name, optionally followed by a colon and a size
+        string name = step.substr(0, step.find(':'));
+        int size = step.find(':') == string::npos ? 0 : atoi(step.c_str() + step.find(':') + 1);
+        if (name == "riffle" && size >= 0) {
+            procedure.steps.push_back({ShuffleStep::RIFFLE, size});
+        } else if (name == "strip" && size >= 0) {
+            procedure.steps.push_back({ShuffleStep::STRIP, size > 0 ? size : DEFAULT_STRIP_PACKET});
+        } else if (name == "cut" && size == 0) {
+            procedure.steps.push_back({ShuffleStep::CUT, 0});
+        } else {
+            cerr << "Error: shuffle step \"" << step << "\" is not \"riffle[:grab]\", \"strip[:packet]\" or \"cut\""
+                 << endl;
+            exit(-1);
+        }
+    }
+    return procedure;
+}
+
+/**
+ * This function returns the procedure as text, in the form that parse() reads.
+ */
+string ShuffleProcedure::toString() const {
+    if (steps.empty()) {
+        return "random";
+    }
+    string text;
+    for (const ShuffleStep &step : steps) {
+        if (!text.empty()) {
+            text += ",";
+        }
+        if (step.type == ShuffleStep::RIFFLE) {
+            text += step.size > 0 ? "riffle:" + std::to_string(step.size) : "riffle";
+        } else if (step.type == ShuffleStep::STRIP) {
+            text += "strip:" + std::to_string(step.size);
+        } else {
+            text += "cut";
+        }
+    }
+    return text;
+}
+
+/**
+ * This function shuffles the input "cards" with the steps of the procedure and the random numbers of
+ * "randomGenerator". The input "buffer" is used for the new stacks, and is resized to the amount of cards if
+ * needed.
+ */
+void ShuffleProcedure::apply(vector<int> &cards, vector<int> &buffer, std::mt19937_64 &randomGenerator) const {
+    if (steps.empty()) {
+        std::shuffle(cards.begin(), cards.end(), randomGenerator);
+        return;
+    }
+    buffer.resize(cards.size());
+    for (const ShuffleStep &step : steps) {
+        if (step.type == ShuffleStep::RIFFLE) {
+            riffle(cards, buffer, step.size, randomGenerator);
+        } else if (step.type == ShuffleStep::STRIP) {
+            strip(cards, buffer, step.size, randomGenerator);
+        } else {
+            cut(cards, randomGenerator);
+        }
+    }
+}
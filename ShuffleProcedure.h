@@ -0,0 +1,102 @@
+/**
+ * The ShuffleProcedure class models the way a dealer shuffles a shoe by hand, as a list of mechanical steps, instead of
+ * a perfect random shuffle. Real shuffles leave traces of the order the cards had before: cards that were close
+ * together often stay close together, which is what shuffle trackers look for. The steps are:
+ *  - "riffle": the stack is cut in two halves (the cut is binomial, like a dealer aiming for the middle), and the
+ *    halves are riffled into each other. A card drops from a half with a chance proportional to the amount of cards
+ *    still in that half (the Gilbert-Shannon-Reeds model). "riffle:<n>" riffles in grabs, like dealers do with a big
+ *    shoe: a grab of n cards from each half is riffled, and every riffled grab is put on top of the new stack.
+ *  - "strip:<n>": packets of about n cards (10 by default) are taken off the top one by one and put on a new stack,
+ *    which reverses the order of the packets but not of the cards in them.
+ *  - "cut": the stack is cut somewhere in its middle half, and the bottom part is put on top.
+ * A procedure is written as the steps separated by commas, like "riffle,riffle,strip,riffle,cut". The procedure
+ * "random" has no steps and shuffles perfectly (with std::shuffle), like a shuffling machine.
+ *
+ * A procedure works on an array of numbers, which can be the ranks of a Shoe, or the positions of the cards before the
+ * shuffle (see ShuffleAnalyzer.h). It does not allocate memory while shuffling, as it is used for millions of shuffles.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_SHUFFLEPROCEDURE_H
+#define PIE_CPP_BLACKJACK_SHUFFLEPROCEDURE_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::vector;
+
+struct ShuffleStep {
+    enum Type {
+        RIFFLE, // "size" is the amount of cards per grab from each half, 0 to riffle the whole halves
+        STRIP,  // "size" is the average amount of cards per packet
+        CUT
+    };
+
+    Type type = RIFFLE;
+    int size = 0;
+};
+
+class ShuffleProcedure {
+private:
+    static const int DEFAULT_STRIP_PACKET = 10;
+
+    vector<ShuffleStep> steps;
+
+    /**
+     * This function returns a random whole number from 0 up to (but not including) "limit", with the input
+     * "randomGenerator". It takes a single number from the generator, without a distribution object.
+     */
+    static int randomBelow(std::mt19937_64 &randomGenerator, int limit);
+
+    /**
+     * This function riffles the "topSize" cards starting at "top" into the "bottomSize" cards starting at "bottom", and
+     * writes the result to "output".
+     */
+    static void riffleTogether(const int *top, int topSize, const int *bottom, int bottomSize, int *output,
+                               std::mt19937_64 &randomGenerator);
+
+    /**
+     * This function performs a "riffle" step with grabs of "grabSize" cards (0 for the whole halves) on the input
+     * "cards", using "buffer" (of the same size) for the new stack.
+     */
+    static void riffle(vector<int> &cards, vector<int> &buffer, int grabSize, std::mt19937_64 &randomGenerator);
+
+    /**
+     * This function performs a "strip" step with packets of about "packetSize" cards on the input "cards", using
+     * "buffer" (of the same size) for the new stack.
+     */
+    static void strip(vector<int> &cards, vector<int> &buffer, int packetSize, std::mt19937_64 &randomGenerator);
+
+    /**
+     * This function performs a "cut" step on the input "cards".
+     */
+    static void cut(vector<int> &cards, std::mt19937_64 &randomGenerator);
+
+public:
+    /**
+     * Default constructor: creates the procedure "random", a perfect shuffle.
+     */
+    ShuffleProcedure() = default;
+
+    /**
+     * This function returns the procedure described by the input "text", like "riffle,riffle,strip,riffle,cut" (see
+     * the description at the top of this file). For an unknown step an error is displayed and the program is exited.
+     */
+    static ShuffleProcedure parse(const string &text);
+
+    /**
+     * This function returns the procedure as text, in the form that parse() reads.
+     */
+    string toString() const;
+
+    /**
+     * This function shuffles the input "cards" with the steps of the procedure and the random numbers of
+     * "randomGenerator". The input "buffer" is used for the new stacks, and is resized to the amount of cards if
+     * needed.
+     */
+    void apply(vector<int> &cards, vector<int> &buffer, std::mt19937_64 &randomGenerator) const;
+};
+
+
+#endif //PIE_CPP_BLACKJACK_SHUFFLEPROCEDURE_H
@@ -0,0 +1,42 @@
+/**
+ * The StrategyChart struct is a basic strategy chart: for every player total and open card of the dealer, whether to
+ * hit ('H') or stand ('S'). A row holds the decisions against the dealer card values 2-11 (an Ace is 11) as a string,
+ * so a chart can be written down as a constexpr table that reads like a printed strategy card. Such tables are
+ * generated by the StrategyChartGenerator (see StrategyChartGenerator.h) for a set of rules. The chart that the
+ * BasicStrategyPolicy plays (see PlayerPolicy.h) is generated in BasicStrategyChart.h.
+ *
+ * The hard totals go from 4 (two 2s) to 20 and the soft totals from 12 (two Aces) to 20. A lower total is always hit,
+ * and a 21 is never asked about, as the game concludes the round as soon as the player reaches it.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_STRATEGYCHART_H
+#define PIE_CPP_BLACKJACK_STRATEGYCHART_H
+
+struct StrategyChart {
+    static const int LOWEST_HARD_TOTAL = 4;
+    static const int LOWEST_SOFT_TOTAL = 12;
+    static const int HIGHEST_TOTAL = 20;
+    static const int AMOUNT_OF_HARD_TOTALS = HIGHEST_TOTAL - LOWEST_HARD_TOTAL + 1;
+    static const int AMOUNT_OF_SOFT_TOTALS = HIGHEST_TOTAL - LOWEST_SOFT_TOTAL + 1;
+
+    // hard[total - LOWEST_HARD_TOTAL][dealer card value - 2], and the same for the soft totals
+    char hard[AMOUNT_OF_HARD_TOTALS][11] = {};
+    char soft[AMOUNT_OF_SOFT_TOTALS][11] = {};
+
+    /**
+     * This function returns true if the chart says to hit the optimal sum "playerSum" of the player's hand (soft if
+     * "isSoft" is true) against the game value of the dealer's open card "dealerCardValue" (2-11).
+     */
+    constexpr bool shouldHit(int playerSum, bool isSoft, int dealerCardValue) const {
+        if (playerSum > HIGHEST_TOTAL) {
+            return false;
+        }
+        if (isSoft) {
+            return playerSum < LOWEST_SOFT_TOTAL || soft[playerSum - LOWEST_SOFT_TOTAL][dealerCardValue - 2] == 'H';
+        }
+        return playerSum < LOWEST_HARD_TOTAL || hard[playerSum - LOWEST_HARD_TOTAL][dealerCardValue - 2] == 'H';
+    }
+};
+
+
+#endif //PIE_CPP_BLACKJACK_STRATEGYCHART_H
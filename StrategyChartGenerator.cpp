@@ -0,0 +1,363 @@
+/**
+ * The StrategyChartGenerator class calculates the basic strategy chart (see StrategyChart.h) for a set of rules,
+ * instead of copying it by hand from a printed strategy card. For every cell of the chart (a player total against an
+ * open card of the dealer), it calculates the expected result of standing and of hitting exactly, by going over every
+ * card that can be drawn with its chance, instead of playing random rounds:
+ *  - standing: the chance of every final total of the dealer is calculated from the cards that are left (like
+ *    DealerTable does for an infinite deck), and every final total is settled with Blackjack::determineOutcome(). With
+ *    a hole card, the dealer has already peeked, so the hole card is known not to make a blackjack;
+ *  - hitting: for every card that can be drawn, the player either busts, reaches 21 (which concludes the round right
+ *    away, like Blackjack::playRound() does, and wins unless a dealer without a hole card makes a blackjack with the
+ *    second card) or goes on with the best of standing and hitting again. The result of a hand only depends on the
+ *    cards drawn, not on their order, so it is remembered per set of drawn cards.
+ * Only hitting and standing are calculated, as those are the only decisions of the game.
+ *
+ * With a shoe of a few decks, every drawn card changes the chances of the next. The chart depends on the total only,
+ * so every cell is calculated for one two-card hand with that total (with a 10 in it if possible, as a 10 is the most
+ * common card), with those two cards and the dealer's open card taken out of the shoe. With an infinite deck (0
+ * decks) the chances never change. The cells do not depend on each other, so they are spread over all cores.
+ *
+ * The chart can be printed, and exported as CSV or as a C++ header with a constexpr StrategyChart, like
+ * BasicStrategyChart.h, which the BasicStrategyPolicy (see PlayerPolicy.h) plays.
+ */
+
+#include "StrategyChartGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cout, std::cerr, std::endl, std::setw;
+
+/**
+ * This function takes a card with the game value "value" out of the cards that are left.
+ */
+void StrategyChartGenerator::Calculation::take(int value) {
+    if (!isInfinite) {
+        counts[value]--;
+        cardsLeft--;
+    }
+}
+
+/**
+ * This function puts a card with the game value "value" back into the cards that are left.
+ */
+void StrategyChartGenerator::Calculation::putBack(int value) {
+    if (!isInfinite) {
+        counts[value]++;
+        cardsLeft++;
+    }
+}
+
+/**
+ * Constructor for a StrategyChartGenerator with the input "settings_".
+ */
+StrategyChartGenerator::StrategyChartGenerator(const ChartSettings &settings_) : settings(settings_) {
+    for (int total = StrategyChart::LOWEST_HARD_TOTAL; total <= StrategyChart::HIGHEST_TOTAL; ++total) {
+        for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+            cells.push_back({total, false, dealerCardValue});
+        }
+    }
+    for (int total = StrategyChart::LOWEST_SOFT_TOTAL; total <= StrategyChart::HIGHEST_TOTAL; ++total) {
+        for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+            cells.push_back({total, true, dealerCardValue});
+        }
+    }
+}
+
+/**
+ * This function returns the result of the input "outcome" for the player, in bets.
+ */
+double StrategyChartGenerator::payoff(RoundOutcome outcome) const {
+    if (outcome == RoundOutcome::PLAYER_BLACKJACK) {
+        return (double) settings.blackjackPayout.numerator / settings.blackjackPayout.denominator;
+    } else if (outcome == RoundOutcome::PLAYER_WIN) {
+        return 1;
+    } else if (outcome == RoundOutcome::PUSH) {
+        return 0;
+    }
+    return -1;
+}
+
+/**
+ * This function adds the chances of the final totals of the dealer (see DealerTable) to "finals", for a dealer's
+ * hand with the sum "hardSum" (every Ace counted as 1) and "cardCount" cards, which has the chance "chance", with
+ * the cards that are left in the input "calculation".
+ */
+void StrategyChartGenerator::addDealerFinals(Calculation &calculation, int hardSum, bool hasAce, int cardCount,
+                                             double chance,
+                                             double (&finals)[DealerTable::AMOUNT_OF_FINAL_TOTALS]) const {
+    int sum = hasAce && hardSum + 10 <= 21 ? hardSum + 10 : hardSum;
+    if (sum > 21) {
+        finals[DealerTable::FINAL_BUST] += chance;
+        return;
+    } else if (sum == 21 && cardCount == 2) {
+        finals[DealerTable::FINAL_BLACKJACK] += chance;
+        return;
+    } else if (sum >= 17) {
+        finals[sum - 17] += chance;
+        return;
+    }
+
+    // A dealer that has peeked at the hole card has no blackjack, so the card that would make one is left out
+    int excludedValue = 0;
+    if (cardCount == 1 && settings.holeCardRule == HoleCardRule::PEEK) {
+        excludedValue = hardSum == 1 ? 10 : hardSum == 10 ? 1 : 0;
+    }
+    int possibleCards = calculation.cardsLeft - (excludedValue > 0 ? calculation.counts[excludedValue] : 0);
+
+    for (int value = 1; value <= 10; ++value) {
+        if (value == excludedValue || calculation.counts[value] == 0) {
+            continue;
+        }
+        double cardChance = (double) calculation.counts[value] / possibleCards;
+        calculation.take(value);
+        addDealerFinals(calculation, hardSum + value, hasAce || value == 1, cardCount + 1, chance * cardChance,
+                        finals);
+        calculation.putBack(value);
+    }
+}
+
+/**
+ * This function returns the expected result of standing with "playerSum" in "playerCardCount" cards.
+ */
+double StrategyChartGenerator::calculateStandValue(Calculation &calculation, int playerSum,
+                                                   int playerCardCount) const {
+    double finals[DealerTable::AMOUNT_OF_FINAL_TOTALS] = {};
+    int openCardValue = calculation.dealerCardValue == 11 ? 1 : calculation.dealerCardValue;
+    addDealerFinals(calculation, openCardValue, openCardValue == 1, 1, 1, finals);
+
+    double value = 0;
+    for (int final = 0; final < DealerTable::AMOUNT_OF_FINAL_TOTALS; ++final) {
+        RoundOutcome outcome = Blackjack::determineOutcome(playerSum, playerCardCount, DealerTable::FINAL_SUMS[final],
+                                                           DealerTable::FINAL_CARD_COUNTS[final]);
+        value += finals[final] * payoff(outcome);
+    }
+    return value;
+}
+
+/**
+ * This function returns the expected result of hitting a hand with the sum "hardSum" (every Ace counted as 1) in
+ * "cardCount" cards, and playing the best decisions after that.
+ */
+double StrategyChartGenerator::calculateHitValue(Calculation &calculation, int hardSum, bool hasAce,
+                                                 int cardCount) const {
+    double value = 0;
+    int cardsLeft = calculation.cardsLeft;
+    for (int card = 1; card <= 10; ++card) {
+        if (calculation.counts[card] == 0) {
+            continue;
+        }
+        double cardChance = (double) calculation.counts[card] / cardsLeft;
+        int newHardSum = hardSum + card;
+        bool newHasAce = hasAce || card == 1;
+        int sum = newHasAce && newHardSum + 10 <= 21 ? newHardSum + 10 : newHardSum;
+
+        if (sum > 21 || (sum == 21 && settings.holeCardRule == HoleCardRule::PEEK)) {
+            // A bust or a 21 concludes the round straight away, before the dealer draws (see Blackjack::playRound()).
+            // A dealer that has peeked has no 21 in two cards, so it is the same as comparing with the open card
+            RoundOutcome outcome = Blackjack::determineOutcome(sum, cardCount + 1, calculation.dealerCardValue, 1);
+            value += cardChance * payoff(outcome);
+            continue;
+        }
+        if (sum == 21) {
+            // Without a hole card, the dealer gets the second card first, and a blackjack beats this 21 of more cards
+            calculation.take(card);
+            int blackjackCard = calculation.dealerCardValue == 11 ? 10 : calculation.dealerCardValue == 10 ? 1 : 0;
+            double blackjackChance = blackjackCard > 0
+                                     ? (double) calculation.counts[blackjackCard] / calculation.cardsLeft : 0;
+            calculation.putBack(card);
+            RoundOutcome outcome = Blackjack::determineOutcome(sum, cardCount + 1, calculation.dealerCardValue, 1);
+            RoundOutcome blackjackOutcome = Blackjack::determineOutcome(sum, cardCount + 1, 21, 2);
+            value += cardChance * ((1 - blackjackChance) * payoff(outcome)
+                                   + blackjackChance * payoff(blackjackOutcome));
+            continue;
+        }
+        calculation.take(card);
+        calculation.drawnCards += uint64_t(1) << (5 * (card - 1));
+        value += cardChance * calculateBestValue(calculation, newHardSum, newHasAce, cardCount + 1);
+        calculation.drawnCards -= uint64_t(1) << (5 * (card - 1));
+        calculation.putBack(card);
+    }
+    return value;
+}
+
+/**
+ * This function returns the expected result of the best decision for a hand with the sum "hardSum" (every Ace
+ * counted as 1) in "cardCount" cards, which is remembered for the cards drawn so far.
+ */
+double StrategyChartGenerator::calculateBestValue(Calculation &calculation, int hardSum, bool hasAce,
+                                                  int cardCount) const {
+    auto remembered = calculation.bestValues.find(calculation.drawnCards);
+    if (remembered != calculation.bestValues.end()) {
+        return remembered->second;
+    }
+    int sum = hasAce && hardSum + 10 <= 21 ? hardSum + 10 : hardSum;
+    double bestValue = std::max(calculateStandValue(calculation, sum, cardCount),
+                                calculateHitValue(calculation, hardSum, hasAce, cardCount));
+    calculation.bestValues[calculation.drawnCards] = bestValue;
+    return bestValue;
+}
+
+/**
+ * This function calculates the expected results of standing and hitting for the input "cell".
+ */
+void StrategyChartGenerator::calculateCell(Cell &cell) const {
+    Calculation calculation;
+    calculation.dealerCardValue = cell.dealerCardValue;
+    calculation.isInfinite = settings.amountOfDecks <= 0;
+    // An infinite deck is calculated with the chances of a single deck, which never change
+    int amountOfDecks = std::max(1, settings.amountOfDecks);
+    for (int value = 1; value <= 10; ++value) {
+        calculation.counts[value] = (value == 10 ? 16 : 4) * amountOfDecks;
+    }
+    calculation.cardsLeft = 52 * amountOfDecks;
+
+    // The two cards of the player: an Ace and the rest for a soft total, and a 10 and the rest if possible for a hard
+    // total
+    int firstCard = cell.isSoft ? 1 : std::min(10, cell.total - 2);
+    int secondCard = cell.isSoft ? cell.total - 11 : cell.total - firstCard;
+    calculation.take(firstCard);
+    calculation.take(secondCard);
+    calculation.take(cell.dealerCardValue == 11 ? 1 : cell.dealerCardValue);
+
+    cell.standValue = calculateStandValue(calculation, cell.total, 2);
+    cell.hitValue = calculateHitValue(calculation, firstCard + secondCard, cell.isSoft, 2);
+}
+
+/**
+ * This function calculates all cells, spread over the threads, and fills the chart.
+ */
+void StrategyChartGenerator::run() {
+    auto startTime = std::chrono::steady_clock::now();
+
+    int amountOfThreads = settings.threads;
+    if (amountOfThreads <= 0) {
+        amountOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The threads take the next cell that has not been calculated yet. Every cell is written by one thread only
+    std::atomic<int> nextCell(0);
+    vector<std::thread> threads;
+    for (int t = 0; t < amountOfThreads; ++t) {
+        threads.emplace_back([this, &nextCell]() {
+            for (int cell = nextCell++; cell < (int) cells.size(); cell = nextCell++) {
+                calculateCell(cells[cell]);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (const Cell &cell : cells) {
+        char decision = cell.hitValue > cell.standValue ? 'H' : 'S';
+        if (cell.isSoft) {
+            chart.soft[cell.total - StrategyChart::LOWEST_SOFT_TOTAL][cell.dealerCardValue - 2] = decision;
+        } else {
+            chart.hard[cell.total - StrategyChart::LOWEST_HARD_TOTAL][cell.dealerCardValue - 2] = decision;
+        }
+    }
+
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * This function returns the calculated chart.
+ */
+const StrategyChart &StrategyChartGenerator::getChart() const {
+    return chart;
+}
+
+/**
+ * This function returns the name of the row of the chart of the input "cell", like "hard 16" or "soft 18".
+ */
+string StrategyChartGenerator::rowName(const Cell &cell) {
+    return (cell.isSoft ? "soft " : "hard ") + std::to_string(cell.total);
+}
+
+/**
+ * This function prints the chart to the console, with a row per player total and a column per dealer card.
+ */
+void StrategyChartGenerator::printChart() {
+    cout << "Basic strategy chart (" << (settings.amountOfDecks > 0 ? std::to_string(settings.amountOfDecks) + " decks"
+                                                                    : string("infinite deck"))
+         << (settings.holeCardRule == HoleCardRule::PEEK ? ", dealer peeks" : ", no hole card") << ", "
+         << cells.size() << " cells calculated in " << elapsedSeconds << " s)" << endl;
+    cout << "H = hit, S = stand" << endl << endl;
+
+    cout << "         ";
+    for (int dealerCardValue = 2; dealerCardValue <= 11; ++dealerCardValue) {
+        cout << setw(3) << (dealerCardValue == 11 ? string("A") : std::to_string(dealerCardValue));
+    }
+    cout << endl;
+    // The cells are in the order of the rows, with a cell per dealer card
+    for (size_t i = 0; i < cells.size(); i += 10) {
+        cout << setw(9) << std::left << rowName(cells[i]) << std::right;
+        for (size_t column = 0; column < 10; ++column) {
+            cout << setw(3) << (cells[i + column].hitValue > cells[i + column].standValue ? 'H' : 'S');
+        }
+        cout << endl;
+    }
+}
+
+/**
+ * This function writes the chart as CSV to the file "fileName", with a row per player total and a column per
+ * dealer card. If the file cannot be written, an error is displayed and the program is exited.
+ */
+void StrategyChartGenerator::writeCsv(const string &fileName) {
+    std::ofstream file(fileName);
+    if (!file) {
+        cerr << "Error: the chart file \"" << fileName << "\" could not be written" << endl;
+        exit(-1);
+    }
+    file << "hand,2,3,4,5,6,7,8,9,10,A" << endl;
+    for (size_t i = 0; i < cells.size(); i += 10) {
+        file << rowName(cells[i]);
+        for (size_t column = 0; column < 10; ++column) {
+            file << "," << (cells[i + column].hitValue > cells[i + column].standValue ? 'H' : 'S');
+        }
+        file << endl;
+    }
+}
+
+/**
+ * This function writes the chart as a C++ header to the file "fileName", in which it is a constexpr StrategyChart
+ * called "chartName". If the file cannot be written, an error is displayed and the program is exited.
+ */
+void StrategyChartGenerator::writeHeader(const string &fileName, const string &chartName) {
+    std::ofstream file(fileName);
+    if (!file) {
+        cerr << "Error: the chart file \"" << fileName << "\" could not be written" << endl;
+        exit(-1);
+    }
+    string guard = "PIE_CPP_BLACKJACK_" + chartName + "_H";
+    file << "// Generated with --strategy-chart for " << (settings.amountOfDecks > 0
+                                                              ? std::to_string(settings.amountOfDecks) + " decks"
+                                                              : string("an infinite deck"))
+         << (settings.holeCardRule == HoleCardRule::PEEK ? " with a dealer that peeks" : " without a hole card")
+         << ". Generate it again instead of editing it" << endl << endl;
+    file << "#ifndef " << guard << endl << "#define " << guard << endl << endl;
+    file << "#include \"StrategyChart.h\"" << endl << endl;
+    file << "// The columns are the dealer card values 2-11 (an Ace is 11)" << endl;
+    file << "inline constexpr StrategyChart " << chartName << " = {" << endl;
+    file << "        {" << endl;
+    for (size_t i = 0; i < cells.size(); i += 10) {
+        if (i > 0 && cells[i].isSoft && !cells[i - 10].isSoft) {
+            file << "        }," << endl << "        {" << endl;
+        }
+        file << "                \"";
+        for (size_t column = 0; column < 10; ++column) {
+            file << (cells[i + column].hitValue > cells[i + column].standValue ? 'H' : 'S');
+        }
+        file << "\", // " << rowName(cells[i]) << endl;
+    }
+    file << "        }};" << endl << endl;
+    file << "#endif //" << guard << endl;
+}
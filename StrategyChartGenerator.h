@@ -0,0 +1,158 @@
+/**
+ * The StrategyChartGenerator class calculates the basic strategy chart (see StrategyChart.h) for a set of rules,
+ * instead of copying it by hand from a printed strategy card. For every cell of the chart (a player total against an
+ * open card of the dealer), it calculates the expected result of standing and of hitting exactly, by going over every
+ * card that can be drawn with its chance, instead of playing random rounds:
+ *  - standing: the chance of every final total of the dealer is calculated from the cards that are left (like
+ *    DealerTable does for an infinite deck), and every final total is settled with Blackjack::determineOutcome(). With
+ *    a hole card, the dealer has already peeked, so the hole card is known not to make a blackjack;
+ *  - hitting: for every card that can be drawn, the player either busts, reaches 21 (which concludes the round right
+ *    away, like Blackjack::playRound() does, and wins unless a dealer without a hole card makes a blackjack with the
+ *    second card) or goes on with the best of standing and hitting again. The result of a hand only depends on the
+ *    cards drawn, not on their order, so it is remembered per set of drawn cards.
+ * Only hitting and standing are calculated, as those are the only decisions of the game.
+ *
+ * With a shoe of a few decks, every drawn card changes the chances of the next. The chart depends on the total only,
+ * so every cell is calculated for one two-card hand with that total (with a 10 in it if possible, as a 10 is the most
+ * common card), with those two cards and the dealer's open card taken out of the shoe. With an infinite deck (0
+ * decks) the chances never change. The cells do not depend on each other, so they are spread over all cores.
+ *
+ * The chart can be printed, and exported as CSV or as a C++ header with a constexpr StrategyChart, like
+ * BasicStrategyChart.h, which the BasicStrategyPolicy (see PlayerPolicy.h) plays.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_STRATEGYCHARTGENERATOR_H
+#define PIE_CPP_BLACKJACK_STRATEGYCHARTGENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::vector;
+
+#include "Blackjack.h"
+#include "DealerTable.h"
+#include "Money.h"
+#include "StrategyChart.h"
+
+struct ChartSettings {
+    int amountOfDecks = 6; // 0 calculates with an infinite deck
+    HoleCardRule holeCardRule = HoleCardRule::PEEK;
+    PayoutRatio blackjackPayout = {3, 2};
+    int threads = 0; // 0 uses all cores of the computer
+};
+
+class StrategyChartGenerator {
+private:
+    // A cell of the chart, with the expected results of standing and hitting in bets
+    struct Cell {
+        int total = 0;
+        bool isSoft = false;
+        int dealerCardValue = 0;
+        double standValue = 0;
+        double hitValue = 0;
+    };
+
+    // The cards that are left during the calculation of one cell, as amounts per game value (1 for an Ace to 10), and
+    // the best results of the hands that have been calculated so far
+    struct Calculation {
+        int counts[11] = {};
+        int cardsLeft = 0;
+        bool isInfinite = false;
+        int dealerCardValue = 0;
+        uint64_t drawnCards = 0; // the cards the player has drawn, 5 bits per game value
+        std::unordered_map<uint64_t, double> bestValues;
+
+        /**
+         * This function takes a card with the game value "value" out of the cards that are left.
+         */
+        void take(int value);
+
+        /**
+         * This function puts a card with the game value "value" back into the cards that are left.
+         */
+        void putBack(int value);
+    };
+
+    ChartSettings settings;
+    vector<Cell> cells;
+    StrategyChart chart;
+    double elapsedSeconds = 0;
+
+    /**
+     * This function returns the result of the input "outcome" for the player, in bets.
+     */
+    double payoff(RoundOutcome outcome) const;
+
+    /**
+     * This function adds the chances of the final totals of the dealer (see DealerTable) to "finals", for a dealer's
+     * hand with the sum "hardSum" (every Ace counted as 1) and "cardCount" cards, which has the chance "chance", with
+     * the cards that are left in the input "calculation".
+     */
+    void addDealerFinals(Calculation &calculation, int hardSum, bool hasAce, int cardCount, double chance,
+                         double (&finals)[DealerTable::AMOUNT_OF_FINAL_TOTALS]) const;
+
+    /**
+     * This function returns the expected result of standing with "playerSum" in "playerCardCount" cards.
+     */
+    double calculateStandValue(Calculation &calculation, int playerSum, int playerCardCount) const;
+
+    /**
+     * This function returns the expected result of hitting a hand with the sum "hardSum" (every Ace counted as 1) in
+     * "cardCount" cards, and playing the best decisions after that.
+     */
+    double calculateHitValue(Calculation &calculation, int hardSum, bool hasAce, int cardCount) const;
+
+    /**
+     * This function returns the expected result of the best decision for a hand with the sum "hardSum" (every Ace
+     * counted as 1) in "cardCount" cards, which is remembered for the cards drawn so far.
+     */
+    double calculateBestValue(Calculation &calculation, int hardSum, bool hasAce, int cardCount) const;
+
+    /**
+     * This function calculates the expected results of standing and hitting for the input "cell".
+     */
+    void calculateCell(Cell &cell) const;
+
+    /**
+     * This function returns the name of the row of the chart of the input "cell", like "hard 16" or "soft 18".
+     */
+    static string rowName(const Cell &cell);
+
+public:
+    /**
+     * Constructor for a StrategyChartGenerator with the input "settings_".
+     */
+    explicit StrategyChartGenerator(const ChartSettings &settings_);
+
+    /**
+     * This function calculates all cells, spread over the threads, and fills the chart.
+     */
+    void run();
+
+    /**
+     * This function returns the calculated chart.
+     */
+    const StrategyChart &getChart() const;
+
+    /**
+     * This function prints the chart to the console, with a row per player total and a column per dealer card.
+     */
+    void printChart();
+
+    /**
+     * This function writes the chart as CSV to the file "fileName", with a row per player total and a column per
+     * dealer card. If the file cannot be written, an error is displayed and the program is exited.
+     */
+    void writeCsv(const string &fileName);
+
+    /**
+     * This function writes the chart as a C++ header to the file "fileName", in which it is a constexpr StrategyChart
+     * called "chartName". If the file cannot be written, an error is displayed and the program is exited.
+     */
+    void writeHeader(const string &fileName, const string &chartName);
+};
+
+
+#endif //PIE_CPP_BLACKJACK_STRATEGYCHARTGENERATOR_H
@@ -0,0 +1,163 @@
+/**
+ * The TableBroadcast class is the stream of events of a table, which any amount of consumers (spectators, loggers,
+ * counters or a network connection) read independently. Every step of a round is a typed TableEvent: the round
+ * starting, the bet being placed, a card being dealt (the dealer's hole card face down), the player taking an action
+ * (hit or stand), the hole card being turned over, the dealer's final hand being revealed and the round being settled.
+ * The game encodes every event once as 16 bytes in a preallocated ring buffer. A consumer only keeps the position of
+ * the next event it reads, so reading costs two 8-byte reads per event, and consumers can read all new events at once
+ * (see readBatch()). The table is never rendered for a consumer; a spectator's own screen can be built from the events
+ * (the cards are glyph indices, see CardGlyphs.h).
+ *
+ * The game (the only writer) never waits for the consumers, so a slow consumer cannot slow down the table. Every
+ * place in the ring buffer has a sequence number that is odd while the game writes it (a sequence lock), so a reader
+ * notices when the game has written over an event it was reading. A spectator that has fallen more than the whole
+ * ring buffer behind has missed events. It then skips ahead and waits for the next round to start, as every round
+ * starts from an empty table. A TableEvent can be written as a line of text with toString(), for example for a log.
+ */
+
+#include "TableBroadcast.h"
+
+#include "Metrics.h"
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::to_string;
+
+/**
+ * This function returns the event as a line of text, like "round 3: card dealt to the player (index 17)".
+ */
+string TableEvent::toString() const {
+    string text = "round " + to_string(round) + ": ";
+    switch (type) {
+        case ROUND_STARTED:
+            return text + "started";
+        case BET_PLACED:
+            return text + "bet placed of " + amount.toString();
+        case CARD_DEALT:
+            return text + "card dealt to the " + (seat == DEALER_SEAT ? "dealer" : "player") + " (index " +
+                   to_string(value) + ")";
+        case ACTION_TAKEN:
+            return text + "player chose to " + (value == HIT ? "hit" : "stand");
+        case HOLE_CARD_REVEALED:
+            return text + "dealer turned over the hole card (index " + to_string(value) + ")";
+        case DEALER_REVEALED:
+            return text + "dealer revealed " + to_string(value);
+        case ROUND_SETTLED:
+            return text + "settled with outcome " + to_string(value) + ", balance " + amount.toString();
+    }
+    return text + "unknown event";
+}
+
+/**
+ * Default constructor: creates an empty broadcast.
+ */
+TableBroadcast::TableBroadcast() : slots(std::make_unique<Slot[]>(CAPACITY)) {}
+
+/**
+ * This function encodes the input "event" into the two words "first" and "second".
+ */
+void TableBroadcast::encode(const TableEvent &event, uint64_t &first, uint64_t &second) {
+    first = (uint64_t) event.type | (uint64_t) event.seat << 8 | (uint64_t) event.value << 16 |
+            (uint64_t) event.round << 32;
+    second = (uint64_t) event.amount.getCents();
+}
+
+/**
+ * This function decodes an event from the two words "first" and "second", see encode().
+ */
+TableEvent TableBroadcast::decode(uint64_t first, uint64_t second) {
+    TableEvent event;
+    event.type = (TableEvent::Type) (first & 0xFF);
+    event.seat = (uint8_t) (first >> 8);
+    event.value = (uint8_t) (first >> 16);
+    event.round = (uint32_t) (first >> 32);
+    event.amount = Money::fromCents((int64_t) second);
+    return event;
+}
+
+/**
+ * This function puts the input "event" in the ring buffer for all spectators. It must only be called by the game.
+ */
+void TableBroadcast::publish(const TableEvent &event) {
+    Metrics::count(Metrics::EVENTS_PUBLISHED, 1);
+    uint64_t first, second;
+    encode(event, first, second);
+
+    uint64_t position = writePosition.load(std::memory_order_relaxed);
+    Slot &slot = slots[position & (CAPACITY - 1)];
+    // Marking the place as being written before the words change, so readers of the old event notice it
+    slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.words[0].store(first, std::memory_order_relaxed);
+    slot.words[1].store(second, std::memory_order_relaxed);
+    slot.sequence.store(2 * position + 2, std::memory_order_release);
+    writePosition.store(position + 1, std::memory_order_release);
+}
+
+/**
+ * This function returns a new spectator, which starts watching at the start of the next round.
+ */
+TableBroadcast::Subscriber TableBroadcast::subscribe() {
+    Subscriber subscriber;
+    subscriber.nextPosition = writePosition.load(std::memory_order_acquire);
+    return subscriber;
+}
+
+/**
+ * This function reads the next event of the input "subscriber" into "event" and returns true, or returns false if
+ * the subscriber has read all events so far.
+ */
+bool TableBroadcast::read(Subscriber &subscriber, TableEvent &event) {
+    while (true) {
+        uint64_t written = writePosition.load(std::memory_order_acquire);
+        if (subscriber.nextPosition >= written) {
+            return false;
+        }
+        // The events more than the whole ring buffer back have been written over
+        if (written - subscriber.nextPosition > CAPACITY) {
+            subscriber.eventsMissed += written - CAPACITY - subscriber.nextPosition;
+            subscriber.nextPosition = written - CAPACITY;
+            subscriber.waitsForRoundStart = true;
+        }
+
+        const Slot &slot = slots[subscriber.nextPosition & (CAPACITY - 1)];
+        uint64_t expectedSequence = 2 * subscriber.nextPosition + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expectedSequence) {
+            continue; // the game is writing over this event, so the subscriber has fallen behind
+        }
+        uint64_t first = slot.words[0].load(std::memory_order_relaxed);
+        uint64_t second = slot.words[1].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != expectedSequence) {
+            continue;
+        }
+        subscriber.nextPosition++;
+
+        event = decode(first, second);
+        // After missing events, the table is only known again from the start of a round
+        if (subscriber.waitsForRoundStart && event.type != TableEvent::ROUND_STARTED) {
+            continue;
+        }
+        subscriber.waitsForRoundStart = false;
+        subscriber.eventsRead++;
+        return true;
+    }
+}
+
+/**
+ * This function reads the next events of the input "subscriber" into "events", at most "maximumEvents" of them,
+ * and returns how many it has read (0 if the subscriber has read all events so far).
+ */
+int TableBroadcast::readBatch(Subscriber &subscriber, TableEvent *events, int maximumEvents) {
+    int amountRead = 0;
+    while (amountRead < maximumEvents && read(subscriber, events[amountRead])) {
+        amountRead++;
+    }
+    return amountRead;
+}
+
+/**
+ * This function returns the amount of events that have been published.
+ */
+uint64_t TableBroadcast::getEventsPublished() {
+    return writePosition.load(std::memory_order_acquire);
+}
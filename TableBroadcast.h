@@ -0,0 +1,127 @@
+/**
+ * The TableBroadcast class is the stream of events of a table, which any amount of consumers (spectators, loggers,
+ * counters or a network connection) read independently. Every step of a round is a typed TableEvent: the round
+ * starting, the bet being placed, a card being dealt (the dealer's hole card face down), the player taking an action
+ * (hit or stand), the hole card being turned over, the dealer's final hand being revealed and the round being settled.
+ * The game encodes every event once as 16 bytes in a preallocated ring buffer. A consumer only keeps the position of
+ * the next event it reads, so reading costs two 8-byte reads per event, and consumers can read all new events at once
+ * (see readBatch()). The table is never rendered for a consumer; a spectator's own screen can be built from the events
+ * (the cards are glyph indices, see CardGlyphs.h).
+ *
+ * The game (the only writer) never waits for the consumers, so a slow consumer cannot slow down the table. Every
+ * place in the ring buffer has a sequence number that is odd while the game writes it (a sequence lock), so a reader
+ * notices when the game has written over an event it was reading. A spectator that has fallen more than the whole
+ * ring buffer behind has missed events. It then skips ahead and waits for the next round to start, as every round
+ * starts from an empty table. A TableEvent can be written as a line of text with toString(), for example for a log.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_TABLEBROADCAST_H
+#define PIE_CPP_BLACKJACK_TABLEBROADCAST_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Money.h"
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string;
+
+struct TableEvent {
+    enum Type : uint8_t {
+        ROUND_STARTED,
+        BET_PLACED,         // "amount" is the bet
+        CARD_DEALT,         // "seat" got the card with glyph index "value" (FACE_DOWN for the dealer's hole card)
+        ACTION_TAKEN,       // "value" is the action of the player, HIT or STAND
+        HOLE_CARD_REVEALED, // the dealer turned over the hole card, which has glyph index "value"
+        DEALER_REVEALED,    // "value" is the optimal sum of the dealer's final hand
+        ROUND_SETTLED       // "value" is the RoundOutcome and "amount" the balance of the player after the payout
+    };
+
+    static const uint8_t DEALER_SEAT = 0;
+    static const uint8_t PLAYER_SEAT = 1;
+    static const uint8_t HIT = 'h';
+    static const uint8_t STAND = 's';
+
+    Type type = ROUND_STARTED;
+    uint8_t seat = 0;
+    uint8_t value = 0;
+    uint32_t round = 0; // the number of the round the event belongs to
+    Money amount;
+
+    /**
+     * This function returns the event as a line of text, like "round 3: card dealt to the player (index 17)".
+     */
+    string toString() const;
+};
+
+class TableBroadcast {
+public:
+    // The reading position of a spectator, which is only used by the spectator itself
+    struct Subscriber {
+        uint64_t nextPosition = 0;
+        uint64_t eventsRead = 0;
+        uint64_t eventsMissed = 0;
+        bool waitsForRoundStart = true;
+    };
+
+private:
+    static const int CAPACITY = 1 << 14; // a power of 2, so a position is turned into an index with a mask
+
+    struct Slot {
+        // 2 * position + 2 once the event at position has been written, and odd while it is being written
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> words[2] = {};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<uint64_t> writePosition{0};
+
+    /**
+     * This function encodes the input "event" into the two words "first" and "second".
+     */
+    static void encode(const TableEvent &event, uint64_t &first, uint64_t &second);
+
+    /**
+     * This function decodes an event from the two words "first" and "second", see encode().
+     */
+    static TableEvent decode(uint64_t first, uint64_t second);
+
+public:
+    /**
+     * Default constructor: creates an empty broadcast.
+     */
+    TableBroadcast();
+
+    TableBroadcast(const TableBroadcast &) = delete;
+    TableBroadcast &operator=(const TableBroadcast &) = delete;
+
+    /**
+     * This function puts the input "event" in the ring buffer for all spectators. It must only be called by the game.
+     */
+    void publish(const TableEvent &event);
+
+    /**
+     * This function returns a new spectator, which starts watching at the start of the next round.
+     */
+    Subscriber subscribe();
+
+    /**
+     * This function reads the next event of the input "subscriber" into "event" and returns true, or returns false if
+     * the subscriber has read all events so far.
+     */
+    bool read(Subscriber &subscriber, TableEvent &event);
+
+    /**
+     * This function reads the next events of the input "subscriber" into "events", at most "maximumEvents" of them,
+     * and returns how many it has read (0 if the subscriber has read all events so far).
+     */
+    int readBatch(Subscriber &subscriber, TableEvent *events, int maximumEvents);
+
+    /**
+     * This function returns the amount of events that have been published.
+     */
+    uint64_t getEventsPublished();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_TABLEBROADCAST_H
@@ -0,0 +1,148 @@
+/**
+ * The TerminalScreen class redraws the table of the game in place at the top of the terminal, instead of printing it
+ * below the previous one. It keeps the frame (the text of the table) that is on the screen, and for a new frame it
+ * only writes the cells (characters) that have changed, with escape codes that move the cursor to them. After a card
+ * is drawn, that is mostly just the new card and the new sum, a small part of the whole table, so far fewer bytes are
+ * sent to the terminal (which matters when it is on the other side of a network connection, like with SSH) and the
+ * terminal does not fill its scroll-back with copies of the table.
+ *
+ * A frame is split into rows of cells. Tabs are expanded to the next multiple of 8 columns and the colour codes of the
+ * card glyphs (see CardGlyphs.h) become the colour of the cells after them, so a cell is the same whether its colour
+ * was set by a code in front of it or further back. A changed cell close behind the cursor is reached by writing the
+ * unchanged cells in between, which is shorter than moving the cursor. Everything below the frame (like the questions
+ * to the player) is cleared with every frame, and the cursor is left under the frame.
+ */
+
+#include "TerminalScreen.h"
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::to_string;
+
+/**
+ * This function splits the input "frame" into rows of cells, see the description at the top of this file.
+ */
+vector<vector<TerminalScreen::Cell>> TerminalScreen::splitIntoCells(const string &frame) {
+    vector<vector<Cell>> rows;
+    vector<Cell> row;
+    int colour = DEFAULT_COLOUR;
+    for (size_t i = 0; i < frame.size(); ++i) {
+        char character = frame[i];
+        if (character == '\n') {
+            rows.push_back(row);
+            row.clear();
+        } else if (character == '\x1b' && i + 1 < frame.size() && frame[i + 1] == '[') {
+            // A colour code "ESC [ number m" sets the colour of the cells after it, 0 resets it
+            int code = 0;
+            for (i += 2; i < frame.size() && frame[i] != 'm'; ++i) {
+                code = code * 10 + (frame[i] - '0');
+            }
+            colour = code == 0 ? DEFAULT_COLOUR : code;
+        } else if (character == '\t') {
+            do {
+                row.push_back(Cell{' ', colour});
+            } while (row.size() % TAB_WIDTH != 0);
+        } else {
+            row.push_back(Cell{character, colour});
+        }
+    }
+    if (!row.empty()) {
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+/**
+ * This function adds the escape code that moves the cursor to "row" and "column" (both starting at 0) to the end
+ * of the input "text".
+ */
+void TerminalScreen::moveCursor(string &text, int row, int column) {
+    // The terminal counts the rows and columns from 1
+    text += "\x1b[" + to_string(row + 1) + ";" + to_string(column + 1) + "H";
+    cursorRow = row;
+    cursorColumn = column;
+}
+
+/**
+ * This function adds the input "cell" to the end of the input "text", with a colour code in front of it if its
+ * colour is not the current colour.
+ */
+void TerminalScreen::writeCell(string &text, const Cell &cell) {
+    if (cell.colour != currentColour) {
+        text += "\x1b[" + to_string(cell.colour) + "m";
+        currentColour = cell.colour;
+    }
+    text += cell.character;
+    cursorColumn++;
+}
+
+/**
+ * This function returns the text that changes the screen from the frame that is on it to the input "frame": the
+ * changed cells with the escape codes that move the cursor to them. The first frame is written on a cleared
+ * screen.
+ */
+string TerminalScreen::present(const string &frame) {
+    vector<vector<Cell>> rows = splitIntoCells(frame);
+    string text;
+    cursorRow = -1;
+    cursorColumn = -1;
+
+    if (!screenIsKnown) {
+        text += "\x1b[2J"; // clearing the whole screen
+        shownRows.clear();
+        screenIsKnown = true;
+    }
+    // The rows below the shown frame hold other text, which has to go before the frame can grow into them
+    if (rows.size() > shownRows.size()) {
+        moveCursor(text, (int) shownRows.size(), 0);
+        text += "\x1b[J"; // clearing from the cursor to the end of the screen
+    }
+
+    const vector<Cell> noCells;
+    for (int row = 0; row < (int) rows.size(); ++row) {
+        const vector<Cell> &newCells = rows[row];
+        const vector<Cell> &shownCells = row < (int) shownRows.size() ? shownRows[row] : noCells;
+
+        for (int column = 0; column < (int) newCells.size(); ++column) {
+            // A cell behind the end of the shown row is empty on the screen
+            Cell shownCell = column < (int) shownCells.size() ? shownCells[column] : Cell();
+            if (newCells[column] == shownCell) {
+                continue;
+            }
+            if (row == cursorRow && column >= cursorColumn && column - cursorColumn <= MAXIMUM_GAP_TO_WRITE) {
+                // Writing the few unchanged cells in between is shorter than moving the cursor
+                while (cursorColumn < column) {
+                    writeCell(text, newCells[cursorColumn]);
+                }
+            } else {
+                moveCursor(text, row, column);
+            }
+            writeCell(text, newCells[column]);
+        }
+
+        // The rest of a row that has become shorter is cleared
+        if (newCells.size() < shownCells.size()) {
+            moveCursor(text, row, (int) newCells.size());
+            text += "\x1b[K"; // clearing from the cursor to the end of the line
+        }
+    }
+
+    // Clearing everything below the frame (the rest of a longer frame and the text written after it) and leaving the
+    // cursor there, in the default colour
+    moveCursor(text, (int) rows.size(), 0);
+    text += "\x1b[J";
+    if (currentColour != DEFAULT_COLOUR) {
+        text += "\x1b[" + to_string(DEFAULT_COLOUR) + "m";
+        currentColour = DEFAULT_COLOUR;
+    }
+
+    shownRows = rows;
+    return text;
+}
+
+/**
+ * This function forgets the frame that is on the screen, so the next frame is written completely on a cleared
+ * screen. This is needed when something else has written over the top of the screen.
+ */
+void TerminalScreen::invalidate() {
+    screenIsKnown = false;
+}
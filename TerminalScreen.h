@@ -0,0 +1,79 @@
+/**
+ * The TerminalScreen class redraws the table of the game in place at the top of the terminal, instead of printing it
+ * below the previous one. It keeps the frame (the text of the table) that is on the screen, and for a new frame it
+ * only writes the cells (characters) that have changed, with escape codes that move the cursor to them. After a card
+ * is drawn, that is mostly just the new card and the new sum, a small part of the whole table, so far fewer bytes are
+ * sent to the terminal (which matters when it is on the other side of a network connection, like with SSH) and the
+ * terminal does not fill its scroll-back with copies of the table.
+ *
+ * A frame is split into rows of cells. Tabs are expanded to the next multiple of 8 columns and the colour codes of the
+ * card glyphs (see CardGlyphs.h) become the colour of the cells after them, so a cell is the same whether its colour
+ * was set by a code in front of it or further back. A changed cell close behind the cursor is reached by writing the
+ * unchanged cells in between, which is shorter than moving the cursor. Everything below the frame (like the questions
+ * to the player) is cleared with every frame, and the cursor is left under the frame.
+ */
+
+#ifndef PIE_CPP_BLACKJACK_TERMINALSCREEN_H
+#define PIE_CPP_BLACKJACK_TERMINALSCREEN_H
+
+#include <string>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::vector;
+
+class TerminalScreen {
+private:
+    static const int DEFAULT_COLOUR = 37; // white, the colour the card glyphs switch back to
+    static const int TAB_WIDTH = 8;
+    static const int MAXIMUM_GAP_TO_WRITE = 4; // moving the cursor takes at least 6 bytes
+
+    struct Cell {
+        char character = ' ';
+        int colour = DEFAULT_COLOUR;
+
+        bool operator==(const Cell &other) const { return character == other.character && colour == other.colour; }
+        bool operator!=(const Cell &other) const { return !(*this == other); }
+    };
+
+    vector<vector<Cell>> shownRows; // the frame that is on the screen
+    bool screenIsKnown = false;
+
+    // Where the cursor and the colour are while a frame is written
+    int cursorRow = 0;
+    int cursorColumn = 0;
+    int currentColour = DEFAULT_COLOUR;
+
+    /**
+     * This function splits the input "frame" into rows of cells, see the description at the top of this file.
+     */
+    static vector<vector<Cell>> splitIntoCells(const string &frame);
+
+    /**
+     * This function adds the escape code that moves the cursor to "row" and "column" (both starting at 0) to the end
+     * of the input "text".
+     */
+    void moveCursor(string &text, int row, int column);
+
+    /**
+     * This function adds the input "cell" to the end of the input "text", with a colour code in front of it if its
+     * colour is not the current colour.
+     */
+    void writeCell(string &text, const Cell &cell);
+
+public:
+    /**
+     * This function returns the text that changes the screen from the frame that is on it to the input "frame": the
+     * changed cells with the escape codes that move the cursor to them. The first frame is written on a cleared
+     * screen.
+     */
+    string present(const string &frame);
+
+    /**
+     * This function forgets the frame that is on the screen, so the next frame is written completely on a cleared
+     * screen. This is needed when something else has written over the top of the screen.
+     */
+    void invalidate();
+};
+
+
+#endif //PIE_CPP_BLACKJACK_TERMINALSCREEN_H
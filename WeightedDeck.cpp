@@ -0,0 +1,208 @@
+/**
+ * The WeightedDeck class is a card source with an arbitrary amount of cards per rank, such as a Spanish 21 deck
+ * without the 10s, without laying out and shuffling a physical shoe like the Shoe class does. Every draw picks a rank
+ * with a chance proportional to the amount of cards of that rank that are left.
+ *
+ * A rank is picked with Walker's alias method, which takes a single random number and a table lookup, no matter how
+ * the cards are spread over the ranks. The alias table is built (with the method of Vose) from the amounts of cards
+ * at one moment. When a card is removed afterwards, only its amount is lowered: a rank picked from the table is
+ * accepted with the chance (cards left of the rank) / (cards of the rank when the table was built), and otherwise the
+ * pick is repeated. This gives exactly the chances of the remaining cards. As soon as fewer than half of the cards of
+ * the table are left, the table is rebuilt, so on average fewer than 2 picks are needed per draw.
+ *
+ * With a penetration of 0 the drawn cards are not removed at all, which approximates a continuous shuffler: every card
+ * goes straight back into the deck. Otherwise the cards are removed like from a shoe, and all cards are put back after
+ * the round in which the penetration has been reached. The running counts are kept like in the Shoe (see CardCounter).
+ */
+
+#include "WeightedDeck.h"
+
+#include <cctype>
+#include <iostream>
+#include <sstream>
+
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::cerr, std::endl, std::isdigit;
+
+/**
+ * Constructor for a deck of "amountOfDecks_" decks that each hold "deckComposition[rank - 1]" cards of every rank
+ * (13 amounts, from the Ace to the King). The cards are put back after the round in which a fraction of
+ * "penetration" of the cards has been drawn, or drawn without being removed if the penetration is 0. The deck
+ * draws with its own random number generator, seeded with the input "seed".
+ */
+WeightedDeck::WeightedDeck(const vector<int> &deckComposition, int amountOfDecks_, double penetration, uint64_t seed)
+        : amountOfDecks(amountOfDecks_), removesCards(penetration > 0), randomGenerator(seed) {
+    for (int rank = 1; rank <= 13; ++rank) {
+        cardsPerRank[rank] = deckComposition[rank - 1] * amountOfDecks;
+        totalCards += cardsPerRank[rank];
+    }
+    cutCardPosition = (int) (penetration * totalCards);
+    shuffle();
+}
+
+/**
+ * This function builds the alias table from the amounts of cards that are left.
+ */
+void WeightedDeck::buildAliasTable() {
+    // Every column should hold tableTotal / 13 of the cards. Multiplying all amounts by 13 keeps this a whole number,
+    // so the table gives exactly the right chances
+    int64_t scaled[13];
+    int small[13];
+    int large[13];
+    int amountSmall = 0;
+    int amountLarge = 0;
+    tableTotal = totalCardsLeft;
+    for (int column = 0; column < 13; ++column) {
+        tableCards[column + 1] = cardsLeft[column + 1];
+        scaled[column] = (int64_t) cardsLeft[column + 1] * 13;
+        if (scaled[column] < tableTotal) {
+            small[amountSmall++] = column;
+        } else {
+            large[amountLarge++] = column;
+        }
+    }
+
+    while (amountSmall > 0 && amountLarge > 0) {
+        int column = small[--amountSmall];
+        int alias = large[--amountLarge];
+        thresholds[column] = scaled[column];
+        aliases[column] = alias + 1;
+        // The large column gives away what the small column lacks
+        scaled[alias] -= tableTotal - scaled[column];
+        if (scaled[alias] < tableTotal) {
+            small[amountSmall++] = alias;
+        } else {
+            large[amountLarge++] = alias;
+        }
+    }
+    // The columns that are left are exactly full, as the amounts are whole numbers there are no rounding errors
+    while (amountLarge > 0) {
+        int column = large[--amountLarge];
+        thresholds[column] = tableTotal;
+        aliases[column] = column + 1;
+    }
+}
+
+/**
+ * This function draws a card and returns its rank (1-13), with a chance proportional to the amount of cards of
+ * every rank that are left. The card is removed from the deck, unless the deck does not remove cards. If the
+ * deck is empty, all cards are put back first.
+ */
+int WeightedDeck::drawRank() {
+    if (totalCardsLeft == 0) {
+        shuffle();
+    }
+    if (totalCardsLeft * 2 < tableTotal) {
+        buildAliasTable();
+    }
+
+    int rank;
+    while (true) {
+        // The upper 32 bits pick the column, the lower 32 bits give a uniform number below the total of the table
+        uint64_t randomBits = randomGenerator();
+        int column = (int) (((randomBits >> 32) * 13) >> 32);
+        int64_t position = (int64_t) (((randomBits & 0xFFFFFFFFULL) * (uint64_t) tableTotal) >> 32);
+        rank = position < thresholds[column] ? column + 1 : aliases[column];
+
+        // A rank with removed cards is only accepted with the chance of its cards that are left
+        if (cardsLeft[rank] == tableCards[rank]) {
+            break;
+        }
+        uint64_t acceptBits = randomGenerator() >> 32;
+        if ((int) ((acceptBits * (uint64_t) tableCards[rank]) >> 32) < cardsLeft[rank]) {
+            break;
+        }
+    }
+
+    if (removesCards) {
+        removeRank(rank);
+    }
+    return rank;
+}
+
+/**
+ * This function removes a card with the input "rank" (1-13) from the deck without drawing it, for example a card
+ * that was burned or seen elsewhere. It costs the same as lowering a counter.
+ */
+void WeightedDeck::removeRank(int rank) {
+    if (cardsLeft[rank] == 0) {
+        return;
+    }
+    cardsLeft[rank]--;
+    totalCardsLeft--;
+    counter.observe(rank);
+}
+
+/**
+ * This function puts all cards back into the deck and resets the running counts.
+ */
+void WeightedDeck::shuffle() {
+    for (int rank = 1; rank <= 13; ++rank) {
+        cardsLeft[rank] = cardsPerRank[rank];
+    }
+    totalCardsLeft = totalCards;
+    counter.reset(amountOfDecks);
+    buildAliasTable();
+}
+
+/**
+ * This function puts all cards back if the penetration has been reached during the round that has just finished.
+ */
+void WeightedDeck::finishRound() {
+    if (removesCards && totalCards - totalCardsLeft >= cutCardPosition) {
+        shuffle();
+    }
+}
+
+/**
+ * This function returns the Hi-Lo true count of the cards that have been drawn since the last shuffle.
+ */
+double WeightedDeck::getTrueCount() {
+    return counter.getTrueCount(CountingSystem::HI_LO, totalCardsLeft / 52.0);
+}
+
+/**
+ * This function returns the amount of cards that have not been drawn yet.
+ */
+int WeightedDeck::getCardsRemaining() {
+    return totalCardsLeft;
+}
+
+/**
+ * This function reads the composition of a single deck from the input "text": "standard" for 4 cards of every
+ * rank, "spanish" for a Spanish 21 deck without the 10s (the Jacks, Queens and Kings stay), or 13 amounts of
+ * cards separated by commas, from the Ace to the King. Otherwise an error will be displayed and the program will
+ * be exited.
+ */
+vector<int> WeightedDeck::parseDeckComposition(const string &text) {
+    if (text == "standard") {
+        return vector<int>(13, 4);
+    } else if (text == "spanish") {
+        vector<int> composition(13, 4);
+        composition[9] = 0;
+        return composition;
+    }
+
+    vector<int> composition;
+    std::istringstream textStream(text);
+    string amount;
+    int totalAmount = 0;
+    while (std::getline(textStream, amount, ',')) {
+        // Every amount has to be a whole number, with the same digit check as the bet prompt of the game uses
+        bool isNumber = !amount.empty();
+        for (char character : amount) {
+            isNumber = isNumber && isdigit(character);
+        }
+        if (!isNumber) {
+            cerr << "Error: deck composition amount \"" << amount << "\" is not a whole number" << endl;
+            exit(-1);
+        }
+        composition.push_back(std::stoi(amount));
+        totalAmount += composition.back();
+    }
+    if (composition.size() != 13 || totalAmount == 0) {
+        cerr << "Error: a deck composition needs 13 amounts of cards (Ace to King) with at least one card" << endl;
+        exit(-1);
+    }
+    return composition;
+}
@@ -0,0 +1,111 @@
+/**
+ * The WeightedDeck class is a card source with an arbitrary amount of cards per rank, such as a Spanish 21 deck
+ * without the 10s, without laying out and shuffling a physical shoe like the Shoe class does. Every draw picks a rank
+ * with a chance proportional to the amount of cards of that rank that are left.
+ *
+ * A rank is picked with Walker's alias method, which takes a single random number and a table lookup, no matter how
+ * the cards are spread over the ranks. The alias table is built (with the method of Vose) from the amounts of cards
+ * at one moment. When a card is removed afterwards, only its amount is lowered: a rank picked from the table is
+ * accepted with the chance (cards left of the rank) / (cards of the rank when the table was built), and otherwise the
+ * pick is repeated. This gives exactly the chances of the remaining cards. As soon as fewer than half of the cards of
+ * the table are left, the table is rebuilt, so on average fewer than 2 picks are needed per draw.
+ *
+ * With a penetration of 0 the drawn cards are not removed at all, which approximates a continuous shuffler: every card
+ * goes straight back into the deck. Otherwise the cards are removed like from a shoe, and all cards are put back after
+ * the round in which the penetration has been reached. The running counts are kept like in the Shoe (see CardCounter).
+ */
+
+#ifndef PIE_CPP_BLACKJACK_WEIGHTEDDECK_H
+#define PIE_CPP_BLACKJACK_WEIGHTEDDECK_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+// Including used elements from the std namespace to avoid having to write std:: a lot throughout the code
+using std::string, std::vector;
+
+#include "CardCounter.h"
+#include "CardSource.h"
+
+class WeightedDeck : public CardSource {
+private:
+    int amountOfDecks;
+    bool removesCards;
+    int cutCardPosition;
+
+    // cardsPerRank[rank] is the amount of cards of every rank (1-13) when all cards are in the deck, and
+    // cardsLeft[rank] the amount that has not been drawn yet
+    int cardsPerRank[14] = {};
+    int cardsLeft[14] = {};
+    int totalCards = 0;
+    int totalCardsLeft = 0;
+
+    // The alias table, built from the amounts of cards in tableCards. Column i (rank i + 1) gives its own rank if a
+    // uniform number below tableTotal is below thresholds[i], and the rank aliases[i] otherwise
+    int tableCards[14] = {};
+    int64_t tableTotal = 0;
+    int64_t thresholds[13] = {};
+    int aliases[13] = {};
+
+    std::mt19937_64 randomGenerator;
+    CardCounter counter;
+
+    /**
+     * This function builds the alias table from the amounts of cards that are left.
+     */
+    void buildAliasTable();
+
+public:
+    /**
+     * Constructor for a deck of "amountOfDecks_" decks that each hold "deckComposition[rank - 1]" cards of every rank
+     * (13 amounts, from the Ace to the King). The cards are put back after the round in which a fraction of
+     * "penetration" of the cards has been drawn, or drawn without being removed if the penetration is 0. The deck
+     * draws with its own random number generator, seeded with the input "seed".
+     */
+    WeightedDeck(const vector<int> &deckComposition, int amountOfDecks_, double penetration, uint64_t seed);
+
+    /**
+     * This function draws a card and returns its rank (1-13), with a chance proportional to the amount of cards of
+     * every rank that are left. The card is removed from the deck, unless the deck does not remove cards. If the
+     * deck is empty, all cards are put back first.
+     */
+    int drawRank() override;
+
+    /**
+     * This function removes a card with the input "rank" (1-13) from the deck without drawing it, for example a card
+     * that was burned or seen elsewhere. It costs the same as lowering a counter.
+     */
+    void removeRank(int rank);
+
+    /**
+     * This function puts all cards back into the deck and resets the running counts.
+     */
+    void shuffle();
+
+    /**
+     * This function puts all cards back if the penetration has been reached during the round that has just finished.
+     */
+    void finishRound() override;
+
+    /**
+     * This function returns the Hi-Lo true count of the cards that have been drawn since the last shuffle.
+     */
+    double getTrueCount() override;
+
+    /**
+     * This function returns the amount of cards that have not been drawn yet.
+     */
+    int getCardsRemaining();
+
+    /**
+     * This function reads the composition of a single deck from the input "text": "standard" for 4 cards of every
+     * rank, "spanish" for a Spanish 21 deck without the 10s (the Jacks, Queens and Kings stay), or 13 amounts of
+     * cards separated by commas, from the Ace to the King. Otherwise an error will be displayed and the program will
+     * be exited.
+     */
+    static vector<int> parseDeckComposition(const string &text);
+};
+
+
+#endif //PIE_CPP_BLACKJACK_WEIGHTEDDECK_H
@@ -1,15 +1,467 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 // Including the Blackjack class, which includes the Hand class, which included the Card class
 #include "Blackjack.h"
+#include "AsyncTable.h"
+#include "BankrollSimulator.h"
+#include "BatchRoundSimulator.h"
+#include "CardGlyphs.h"
+#include "ContinuousShuffler.h"
+#include "DeviationGenerator.h"
+#include "Instrumentation.h"
+#include "Metrics.h"
+#include "PolicyComparison.h"
+#include "ScriptedInput.h"
+#include "Shoe.h"
+#include "ShuffleAnalyzer.h"
+#include "StrategyChartGenerator.h"
+#include "TableBroadcast.h"
+#include "WeightedDeck.h"
 
-int main() {
+/**
+ * This function reads the events of the input "broadcast" until "stop" is set, for all its consumers on this thread:
+ * "amountOfSpectators" spectators that read every event (like a server would before sending the events to the
+ * spectators' screens), a counter of the outcomes of the rounds, and a log that writes every event to the file
+ * "eventLogFileName" (if it is not empty). Every consumer starts reading at the position of the input "subscriber", and
+ * reads the new events in batches (see TableBroadcast.h). Afterwards, a short summary is printed.
+ */
+void consumeTableEvents(TableBroadcast &broadcast, TableBroadcast::Subscriber subscriber, int amountOfSpectators,
+                        const string &eventLogFileName, const std::atomic<bool> &stop) {
+    const int BATCH_SIZE = 256;
+    vector<TableEvent> batch(BATCH_SIZE);
+
+    vector<TableBroadcast::Subscriber> spectators(amountOfSpectators, subscriber);
+    TableBroadcast::Subscriber outcomeCounter = subscriber;
+    uint64_t outcomes[5] = {}; // counted per RoundOutcome
+    TableBroadcast::Subscriber logger = subscriber;
+    std::ofstream eventLog;
+    if (!eventLogFileName.empty()) {
+        eventLog.open(eventLogFileName);
+    }
+
+    bool isStopping = false;
+    while (!isStopping) {
+        // Reading the events published before the stop one last time
+        isStopping = stop;
+        bool hasRead = false;
+        for (TableBroadcast::Subscriber &spectator : spectators) {
+            while (broadcast.readBatch(spectator, batch.data(), BATCH_SIZE) > 0) {
+                hasRead = true;
+            }
+        }
+        int amountRead;
+        while ((amountRead = broadcast.readBatch(outcomeCounter, batch.data(), BATCH_SIZE)) > 0) {
+            for (int i = 0; i < amountRead; ++i) {
+                if (batch[i].type == TableEvent::ROUND_SETTLED) {
+                    outcomes[batch[i].value]++;
+                }
+            }
+            hasRead = true;
+        }
+        if (eventLog.is_open()) {
+            INSTRUMENT_PHASE(LOG);
+            string lines;
+            while ((amountRead = broadcast.readBatch(logger, batch.data(), BATCH_SIZE)) > 0) {
+                for (int i = 0; i < amountRead; ++i) {
+                    lines += batch[i].toString() + "\n";
+                }
+            }
+            eventLog << lines;
+            Metrics::count(Metrics::BYTES_TO_EVENT_LOG, lines.size());
+        }
+        if (!hasRead) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    uint64_t eventsRead = 0;
+    uint64_t eventsMissed = 0;
+    for (const TableBroadcast::Subscriber &spectator : spectators) {
+        eventsRead += spectator.eventsRead;
+        eventsMissed += spectator.eventsMissed;
+    }
+    std::cout << "Events published: " << broadcast.getEventsPublished() << std::endl;
+    if (amountOfSpectators > 0) {
+        std::cout << "Spectators: " << amountOfSpectators << ", events read by all spectators: " << eventsRead << " ("
+                  << eventsMissed << " missed)" << std::endl;
+    }
+    std::cout << "Rounds settled: " << outcomes[(int) RoundOutcome::PLAYER_BLACKJACK] << " player blackjacks, "
+              << outcomes[(int) RoundOutcome::PLAYER_WIN] << " player wins, " << outcomes[(int) RoundOutcome::PUSH]
+              << " pushes, " << outcomes[(int) RoundOutcome::DEALER_WIN] << " dealer wins, "
+              << outcomes[(int) RoundOutcome::DEALER_BLACKJACK] << " dealer blackjacks" << std::endl;
+}
+
+/**
+ * This function plays "sessions" scripted games of Blackjack one after the other, each replaying the commands of the
+ * script from the start through the normal console code path, with a blackjack paying "blackjackPayout" and the
+ * dealer's second card following "holeCardRule". If the input "broadcast" is not null, the sessions are published to
+ * it. Afterwards, a short summary of all sessions is printed.
+ */
+void runScriptedSessions(ScriptedInput &script, int sessions, PayoutRatio blackjackPayout, HoleCardRule holeCardRule,
+                         TableBroadcast *broadcast) {
+    auto startTime = std::chrono::steady_clock::now();
+    long long totalRounds = 0;
+    Money totalFinalBalance;
+
+    for (int session = 0; session < sessions; ++session) {
+        std::istringstream commands = script.createSessionStream();
+        Blackjack game;
+        game.useScriptedSession(commands);
+        game.setBlackjackPayout(blackjackPayout);
+        game.setHoleCardRule(holeCardRule);
+        if (broadcast != nullptr) {
+            game.useBroadcast(*broadcast);
+        }
+        game.launchGame();
+
+        totalRounds += game.getRoundsPlayed();
+        totalFinalBalance += game.getPlayerMoney();
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Scripted sessions: " << sessions << " (" << script.getCommandCount() << " commands each)" << std::endl;
+    std::cout << "Rounds played: " << totalRounds << std::endl;
+    std::cout << "Average final balance: " << totalFinalBalance.toDecimal() / sessions << std::endl;
+    std::cout << "Elapsed time: " << elapsedSeconds << " s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
     // Seeding the random number generator
     srand(time(0));
 
-    // Launching a game of Blackjack defined by the Blackjack class
-    Blackjack().launchGame();
+    // Reading the command line options:
+    // "--no-delay" runs the game without the pauses in between card draws
+    // "--spectators <n>" lets n spectators watch the table through a TableBroadcast, "--event-log <file>" logs its events
+    // "--scrolling" prints the table below the previous one instead of redrawing it in place
+    // "--script <file>" plays the commands in the file (or "-" for a pipe) without prompts, "--sessions <n>" repeats it
+    // "--decks <n>" deals the cards from a shoe of n decks (0 for an infinite deck), "--penetration <f>" sets its cut card
+    // "--composition <deck>" draws from decks with other amounts of cards per rank (see WeightedDeck.h) instead
+    // "--csm <slots>" deals from a continuous shuffler with that many slots, "--csm-buffer <n>" sets its delivery buffer
+    // "--bankroll-sim" runs the bankroll simulator instead of the game, configured by the options below it
+    // "--blackjack-pays <3:2|6:5>" sets the payout of a blackjack in the game and the bankroll simulator
+    // "--enhc" deals the dealer's second card after the player's turn, without a hole card or peek, in the game and
+    // the simulators
+    // "--account <name>" keeps the balance of the player in an account in the directory "--accounts-dir <dir>"
+    // "--house-edge" measures the house edge with the lockstep simulator ("--scalar" plays one round at a time instead)
+    // "--precision <pct>" stops the house edge simulation once its 95% confidence interval is within +/- pct percent
+    // "--dealer-table" picks the dealer's final total from the precalculated DealerTable instead of drawing cards
+    // "--index-plays" generates the table of index plays, "--rounds <n>" sets the amount of rounds to simulate
+    // "--async-tables <n>" plays n tables of simulated players as coroutines on one thread (see AsyncTable.h)
+    // "--compare <a> <b>" compares two variants (a policy with rules, like "basic+enhc") on common cards over the
+    // rounds of "--rounds <n>", optionally with "--antithetic" shoes and "--control-variates"
+    // "--strategy-chart" calculates the basic strategy chart for the rules, which "--chart-csv <file>" and
+    // "--chart-header <file>" export
+    // "--shuffle <procedure>" makes the dealer shuffle the shoe by hand (see ShuffleProcedure.h), and
+    // "--shuffle-analysis" measures how predictable that procedure leaves the cards over "--shuffles <n>" shuffles
+    // "--instrument <file>" writes a snapshot of the Instrumentation to the file (or to a Unix socket given as
+    // "unix:<path>") every "--instrument-interval <ms>" milliseconds, in builds with BLACKJACK_INSTRUMENTATION
+    // "--metrics-port <port>" serves the Metrics at http://127.0.0.1:<port>/metrics while the program runs
+    bool noDelay = false;
+    bool scrolling = false;
+    int amountOfSpectators = 0;
+    string eventLogFileName;
+    string scriptFileName;
+    int sessions = 1;
+    bool runBankrollSimulator = false;
+    BankrollSettings bankrollSettings;
+    bool runHouseEdge = false;
+    bool scalarHouseEdge = false;
+    bool useDealerTable = false;
+    double targetPrecision = 0;
+    bool roundsGiven = false;
+    bool runDeviationGenerator = false;
+    DeviationSettings deviationSettings;
+    int amountOfAsyncTables = 0;
+    bool runPolicyComparison = false;
+    ComparisonSettings comparisonSettings;
+    bool runStrategyChartGenerator = false;
+    string chartCsvFileName;
+    string chartHeaderFileName;
+    bool runShuffleAnalyzer = false;
+    ShuffleSettings shuffleSettings;
+    bool shuffleGiven = false;
+    string instrumentationDestination;
+    int metricsPort = 0;
+    int instrumentationInterval = 1000;
+    bool decksGiven = false;
+    string accountName;
+    string accountsDirectory = "accounts";
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--no-delay") {
+            noDelay = true;
+        } else if (option == "--scrolling") {
+            scrolling = true;
+        } else if (option == "--spectators" && hasValue) {
+            amountOfSpectators = std::max(0, atoi(argv[++i]));
+        } else if (option == "--event-log" && hasValue) {
+            eventLogFileName = argv[++i];
+        } else if (option == "--script" && hasValue) {
+            scriptFileName = argv[++i];
+        } else if (option == "--sessions" && hasValue) {
+            sessions = std::max(1, atoi(argv[++i]));
+        } else if (option == "--decks" && hasValue) {
+            bankrollSettings.amountOfDecks = std::max(0, atoi(argv[++i]));
+            decksGiven = true;
+        } else if (option == "--composition" && hasValue) {
+            bankrollSettings.deckComposition = WeightedDeck::parseDeckComposition(argv[++i]);
+        } else if (option == "--csm" && hasValue) {
+            bankrollSettings.shufflerSlots = std::max(0, atoi(argv[++i]));
+        } else if (option == "--csm-buffer" && hasValue) {
+            bankrollSettings.shufflerBufferMinimum = std::max(1, atoi(argv[++i]));
+        } else if (option == "--penetration" && hasValue) {
+            bankrollSettings.penetration = atof(argv[++i]);
+        } else if (option == "--bankroll-sim") {
+            runBankrollSimulator = true;
+        } else if (option == "--blackjack-pays" && hasValue) {
+            bankrollSettings.blackjackPayout = Money::parsePayoutRatio(argv[++i]);
+        } else if (option == "--enhc") {
+            bankrollSettings.holeCardRule = HoleCardRule::NO_HOLE_CARD;
+        } else if (option == "--account" && hasValue) {
+            accountName = argv[++i];
+        } else if (option == "--accounts-dir" && hasValue) {
+            accountsDirectory = argv[++i];
+        } else if (option == "--house-edge") {
+            runHouseEdge = true;
+        } else if (option == "--scalar") {
+            scalarHouseEdge = true;
+        } else if (option == "--dealer-table") {
+            useDealerTable = true;
+        } else if (option == "--index-plays") {
+            runDeviationGenerator = true;
+        } else if (option == "--async-tables" && hasValue) {
+            amountOfAsyncTables = std::max(0, atoi(argv[++i]));
+        } else if (option == "--compare" && i + 2 < argc) {
+            runPolicyComparison = true;
+            comparisonSettings.variants[0] = PolicyComparison::parseVariant(argv[++i]);
+            comparisonSettings.variants[1] = PolicyComparison::parseVariant(argv[++i]);
+        } else if (option == "--antithetic") {
+            comparisonSettings.antitheticShoes = true;
+        } else if (option == "--control-variates") {
+            comparisonSettings.controlVariates = true;
+        } else if (option == "--strategy-chart") {
+            runStrategyChartGenerator = true;
+        } else if (option == "--chart-csv" && hasValue) {
+            chartCsvFileName = argv[++i];
+        } else if (option == "--chart-header" && hasValue) {
+            chartHeaderFileName = argv[++i];
+        } else if (option == "--shuffle" && hasValue) {
+            shuffleSettings.procedure = ShuffleProcedure::parse(argv[++i]);
+            shuffleGiven = true;
+        } else if (option == "--shuffle-analysis") {
+            runShuffleAnalyzer = true;
+        } else if (option == "--shuffles" && hasValue) {
+            shuffleSettings.shuffles = std::max(1LL, atoll(argv[++i]));
+        } else if (option == "--instrument" && hasValue) {
+            instrumentationDestination = argv[++i];
+        } else if (option == "--instrument-interval" && hasValue) {
+            instrumentationInterval = std::max(1, atoi(argv[++i]));
+        } else if (option == "--metrics-port" && hasValue) {
+            metricsPort = atoi(argv[++i]);
+        } else if (option == "--rounds" && hasValue) {
+            deviationSettings.rounds = std::max(1LL, atoll(argv[++i]));
+            roundsGiven = true;
+        } else if (option == "--precision" && hasValue) {
+            targetPrecision = std::max(0.0, atof(argv[++i]));
+        } else if (option == "--strategy" && hasValue) {
+            bankrollSettings.strategy = BankrollSimulator::parseBettingStrategy(argv[++i]);
+        } else if (option == "--sim-sessions" && hasValue) {
+            bankrollSettings.sessions = std::max(1, atoi(argv[++i]));
+        } else if (option == "--sim-rounds" && hasValue) {
+            bankrollSettings.roundsPerSession = std::max(1, atoi(argv[++i]));
+        } else if (option == "--bankroll" && hasValue) {
+            bankrollSettings.startingBankroll = Money::fromDecimal(atof(argv[++i]));
+            // A session needs money to bet with, and the histogram of final bankrolls spans 0 to 4 times this amount
+            if (bankrollSettings.startingBankroll <= Money()) {
+                std::cerr << "Error: --bankroll needs a positive amount, not \"" << argv[i] << "\"" << std::endl;
+                exit(-1);
+            }
+        } else if (option == "--kelly-fraction" && hasValue) {
+            bankrollSettings.kellyFraction = atof(argv[++i]);
+        } else if (option == "--threads" && hasValue) {
+            bankrollSettings.threads = atoi(argv[++i]);
+        } else if (option == "--seed" && hasValue) {
+            bankrollSettings.seed = strtoull(argv[++i], nullptr, 10);
+        }
+    }
+
+    // The options for the shoe, threads, seed and hole card are shared by all simulators
+    deviationSettings.amountOfDecks = std::max(1, bankrollSettings.amountOfDecks);
+    deviationSettings.penetration = bankrollSettings.penetration;
+    deviationSettings.threads = bankrollSettings.threads;
+    deviationSettings.seed = bankrollSettings.seed;
+    deviationSettings.holeCardRule = bankrollSettings.holeCardRule;
+    shuffleSettings.amountOfDecks = deviationSettings.amountOfDecks;
+    shuffleSettings.penetration = bankrollSettings.penetration;
+    shuffleSettings.threads = bankrollSettings.threads;
+    shuffleSettings.seed = bankrollSettings.seed;
+
+    // The snapshots and the metrics cover whatever runs below, and the last snapshot is written when main() returns
+    std::unique_ptr<SnapshotExporter> snapshotExporter;
+    if (!instrumentationDestination.empty()) {
+        if (!Instrumentation::isEnabled()) {
+            std::cerr << "Error: --instrument needs a build with the CMake option BLACKJACK_INSTRUMENTATION"
+                      << std::endl;
+            exit(-1);
+        }
+        snapshotExporter = std::make_unique<SnapshotExporter>(instrumentationDestination, instrumentationInterval);
+    }
+    std::unique_ptr<MetricsEndpoint> metricsEndpoint;
+    if (metricsPort > 0) {
+        metricsEndpoint = std::make_unique<MetricsEndpoint>(metricsPort);
+    }
+
+    if (runPolicyComparison) {
+        comparisonSettings.amountOfDecks = bankrollSettings.amountOfDecks;
+        comparisonSettings.penetration = bankrollSettings.penetration;
+        comparisonSettings.rounds = deviationSettings.rounds;
+        comparisonSettings.threads = bankrollSettings.threads;
+        comparisonSettings.seed = bankrollSettings.seed;
+        PolicyComparison comparison(comparisonSettings);
+        comparison.run();
+        comparison.printReport();
+        return 0;
+    }
+
+    if (runStrategyChartGenerator) {
+        ChartSettings chartSettings;
+        chartSettings.amountOfDecks = bankrollSettings.amountOfDecks;
+        chartSettings.holeCardRule = bankrollSettings.holeCardRule;
+        chartSettings.blackjackPayout = bankrollSettings.blackjackPayout;
+        chartSettings.threads = bankrollSettings.threads;
+        StrategyChartGenerator generator(chartSettings);
+        generator.run();
+        generator.printChart();
+        if (!chartCsvFileName.empty()) {
+            generator.writeCsv(chartCsvFileName);
+        }
+        if (!chartHeaderFileName.empty()) {
+            generator.writeHeader(chartHeaderFileName, "BASIC_STRATEGY_CHART");
+        }
+        return 0;
+    }
+
+    if (runShuffleAnalyzer) {
+        ShuffleAnalyzer analyzer(shuffleSettings);
+        analyzer.run();
+        analyzer.printReport();
+        return 0;
+    }
+
+    if (runHouseEdge) {
+        // With a target precision and no amount of rounds, the simulation runs until the precision is reached
+        long long maximumRounds = targetPrecision > 0 && !roundsGiven ? 1000000000000000LL : deviationSettings.rounds;
+        BatchRoundSimulator::runHouseEdge(maximumRounds, bankrollSettings.threads, bankrollSettings.seed,
+                                          scalarHouseEdge, useDealerTable, bankrollSettings.holeCardRule,
+                                          targetPrecision);
+        return 0;
+    }
+
+    if (runDeviationGenerator) {
+        DeviationGenerator generator(deviationSettings);
+        generator.run();
+        generator.printTable();
+        return 0;
+    }
+
+    if (amountOfAsyncTables > 0) {
+        AsyncTable::runTables(amountOfAsyncTables, bankrollSettings.roundsPerSession, bankrollSettings.startingBankroll,
+                              bankrollSettings.blackjackPayout, bankrollSettings.holeCardRule, bankrollSettings.seed,
+                              noDelay);
+        return 0;
+    }
+
+    if (runBankrollSimulator) {
+        BankrollSimulator simulator(bankrollSettings);
+        simulator.run();
+        simulator.printReport();
+        return 0;
+    }
+
+    // The events of the game (or the scripted sessions) are consumed on a thread of their own, if anyone watches
+    bool publishEvents = amountOfSpectators > 0 || !eventLogFileName.empty();
+    TableBroadcast broadcast;
+    std::atomic<bool> stopConsuming{false};
+    std::thread consumerThread;
+    if (publishEvents) {
+        // Subscribing before the game starts, so the consumers do not miss its first events
+        consumerThread = std::thread(consumeTableEvents, std::ref(broadcast), broadcast.subscribe(), amountOfSpectators,
+                                     std::cref(eventLogFileName), std::cref(stopConsuming));
+    }
+    auto stopConsumers = [&consumerThread, &stopConsuming]() {
+        if (consumerThread.joinable()) {
+            stopConsuming = true;
+            consumerThread.join();
+        }
+    };
+
+    if (!scriptFileName.empty()) {
+        ScriptedInput script = ScriptedInput::fromFile(scriptFileName);
+        runScriptedSessions(script, sessions, bankrollSettings.blackjackPayout, bankrollSettings.holeCardRule,
+                            publishEvents ? &broadcast : nullptr);
+        stopConsumers();
+        return 0;
+    }
+
+    // Launching a game of Blackjack defined by the Blackjack class. The cards are drawn with colour codes (see
+    // CardGlyphs.h), which the console has to be told about first
+    CardGlyphs::enableColourCodes();
+    SleepingPacer sleepingPacer;
+    ZeroDelayPacer zeroDelayPacer;
+    Blackjack game(noDelay ? (Pacer &) zeroDelayPacer : (Pacer &) sleepingPacer);
+    game.setBlackjackPayout(bankrollSettings.blackjackPayout);
+    game.setHoleCardRule(bankrollSettings.holeCardRule);
+    game.setRedrawInPlace(!scrolling);
+    // The console game generates random cards (an infinite deck), unless a shoe, a deck composition or a continuous
+    // shuffler was asked for. Shuffling by hand also asks for a shoe, of 6 decks unless --decks says otherwise
+    if (shuffleGiven && (bankrollSettings.amountOfDecks <= 0 || bankrollSettings.shufflerSlots > 0 ||
+                         !bankrollSettings.deckComposition.empty())) {
+        std::cerr << "Error: --shuffle shuffles a shoe, which an infinite deck, --composition or --csm does not use"
+                  << std::endl;
+        exit(-1);
+    }
+    // Only the card source that is used is created (like BankrollSimulator::createCardSource() does)
+    std::unique_ptr<CardSource> cardSource;
+    if (bankrollSettings.shufflerSlots > 0) {
+        cardSource = std::make_unique<ContinuousShuffler>(std::max(1, bankrollSettings.amountOfDecks),
+                                                          bankrollSettings.shufflerSlots,
+                                                          bankrollSettings.shufflerBufferMinimum, time(0));
+    } else if (!bankrollSettings.deckComposition.empty()) {
+        cardSource = std::make_unique<WeightedDeck>(bankrollSettings.deckComposition,
+                                                    std::max(1, bankrollSettings.amountOfDecks),
+                                                    bankrollSettings.penetration, time(0));
+    } else if ((decksGiven || shuffleGiven) && bankrollSettings.amountOfDecks > 0) {
+        auto shoe = std::make_unique<Shoe>(bankrollSettings.amountOfDecks, bankrollSettings.penetration, time(0));
+        if (shuffleGiven) {
+            shoe->setShuffleProcedure(shuffleSettings.procedure);
+        }
+        cardSource = std::move(shoe);
+    }
+    if (cardSource != nullptr) {
+        game.useCardSource(*cardSource);
+    }
+    // The account store is only opened if an account was asked for, as it creates its directory
+    std::unique_ptr<AccountStore> accountStore;
+    if (!accountName.empty()) {
+        accountStore = std::make_unique<AccountStore>(accountsDirectory);
+        game.useAccount(*accountStore, accountName);
+    }
+    if (publishEvents) {
+        game.useBroadcast(broadcast);
+    }
+    game.launchGame();
+    stopConsumers();
 
     return 0;
-}
\ No newline at end of file
+}